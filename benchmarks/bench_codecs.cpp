@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brace/base16.h"
+#include "brace/base32.h"
+#include "brace/base64.h"
+#include "brace/benchmark.h"
+#include "brace/parallel_codec.h"
+
+#include "bench_data.h"
+
+namespace {
+
+constexpr size_t    input_size{16384};
+
+template <typename Coder>
+void add_codec(brace::BenchmarkRegistry &registry, const std::string &name)
+{
+    const auto          data{bench::random_bytes(input_size)};
+    const std::string   encoded{Coder().encode(data.begin(), data.end())};
+
+    registry.add("codec/" + name + "/encode", data.size(), [data]
+        {
+            return Coder().encode(data.begin(), data.end());
+        });
+
+    registry.add("codec/" + name + "/decode", encoded.size(), [encoded]
+        {
+            return Coder().decode(encoded);
+        });
+
+    // Decoding into a reused buffer measures the decoder without the
+    // allocation.
+    registry.add("codec/" + name + "/try_decode", encoded.size(), [encoded](uint64_t n)
+        {
+            const Coder             coder;
+            std::vector<uint8_t>    out;
+
+            out.reserve(input_size);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                out.clear();
+                brace::do_not_optimize(coder.try_decode(encoded, out));
+                brace::do_not_optimize(out.data());
+            }
+        });
+}
+
+// Large enough to split into several chunks.
+constexpr size_t    parallel_input_size{size_t{1} << 22};
+
+void add_parallel_encode(brace::BenchmarkRegistry &registry)
+{
+    const auto  data{bench::random_bytes(parallel_input_size)};
+
+    registry.add("codec/Base64/encode_large", data.size(), [data]
+        {
+            return brace::Base64().encode(data.begin(), data.end());
+        });
+
+    registry.add("codec/Base64/parallel_encode", data.size(), [data]
+        {
+            return brace::parallel_encode(brace::Base64(), data.begin(), data.end());
+        });
+}
+
+const bool  registered{[]
+    {
+        auto   &registry{brace::BenchmarkRegistry::instance()};
+
+        add_codec<brace::Base16>(registry, "Base16");
+        add_codec<brace::Base32>(registry, "Base32");
+        add_codec<brace::Base64>(registry, "Base64");
+        add_codec<brace::Base64Url>(registry, "Base64Url");
+        add_parallel_encode(registry);
+
+        return true;
+    }()};
+
+}
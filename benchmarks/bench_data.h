@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file bench_data.h
+/// \brief  Inputs shared by the benchmarks.
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_BENCH_DATA_INC
+#define BRACE_BENCH_DATA_INC
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/// \brief  Generate reproducible pseudo-random bytes.
+inline std::vector<uint8_t> random_bytes(size_t size, uint64_t seed = 0x9E3779B97F4A7C15)
+{
+    std::vector<uint8_t>    rv(size);
+
+    for (auto &byte : rv)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        byte = static_cast<uint8_t>(seed >> 56);
+    }
+
+    return rv;
+}
+
+/// \brief  Generate text by repeating a line until it reaches a size.
+inline std::string repeat_text(const std::string &line, size_t size)
+{
+    std::string rv;
+
+    rv.reserve(size + line.size());
+    while (rv.size() < size)
+        rv += line;
+    rv.resize(size);
+
+    return rv;
+}
+
+}
+
+#endif  // BRACE_BENCH_DATA_INC
@@ -0,0 +1,38 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brace/benchmark.h"
+#include "brace/md5.h"
+#include "brace/sha1.h"
+#include "brace/sha2.h"
+
+#include "bench_data.h"
+
+namespace {
+
+template <typename Hash>
+void add_hash(brace::BenchmarkRegistry &registry, const std::string &name)
+{
+    for (size_t size : {64, 1024, 16384})
+    {
+        registry.add("hash/" + name + "/" + std::to_string(size), size, [data = bench::random_bytes(size)]
+            {
+                return Hash().compute_hash(data.data(), data.size());
+            });
+    }
+}
+
+const bool  registered{[]
+    {
+        auto   &registry{brace::BenchmarkRegistry::instance()};
+
+        add_hash<brace::MD5>(registry, "MD5");
+        add_hash<brace::SHA1>(registry, "SHA1");
+        add_hash<brace::SHA256>(registry, "SHA256");
+        add_hash<brace::SHA512>(registry, "SHA512");
+
+        return true;
+    }()};
+
+}
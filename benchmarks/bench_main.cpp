@@ -0,0 +1,6 @@
+#include "brace/benchmark.h"
+
+int main(int argc, char *argv[])
+{
+    return brace::benchmark_main(argc, argv);
+}
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brace/benchmark.h"
+#include "brace/binastream.h"
+#include "brace/byteorder.h"
+
+namespace {
+
+constexpr size_t    value_count{4096};
+
+void add_stream(brace::BenchmarkRegistry &registry, const std::string &name, brace::Endian endian)
+{
+    const size_t    bytes{value_count * sizeof(uint32_t)};
+
+    registry.add("stream/" + name + "/insert", bytes, [endian](uint64_t n)
+        {
+            std::vector<uint8_t>    buffer(bytes);
+
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                brace::BinOArrayStream  out{buffer.data(), buffer.size()};
+
+                out.endian(endian);
+                for (uint32_t v = 0; v < value_count; ++v)
+                    out << v;
+                brace::do_not_optimize(buffer.data());
+            }
+        });
+
+    registry.add("stream/" + name + "/extract", bytes, [endian](uint64_t n)
+        {
+            std::vector<uint8_t>    buffer(bytes, 0x5A);
+
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                brace::BinIArrayStream  in{buffer.data(), buffer.size()};
+                uint32_t                sum{0};
+                uint32_t                v{0};
+
+                in.endian(endian);
+                for (size_t k = 0; k < value_count; ++k)
+                {
+                    in >> v;
+                    sum += v;
+                }
+                brace::do_not_optimize(sum);
+            }
+        });
+
+    registry.add("stream/" + name + "/write_values", bytes, [endian](uint64_t n)
+        {
+            std::vector<uint8_t>    buffer(bytes);
+            std::vector<uint32_t>   values(value_count, 0x01020304);
+
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                brace::BinOArrayStream  out{buffer.data(), buffer.size()};
+
+                out.endian(endian);
+                out.write_values(values.data(), values.size());
+                brace::do_not_optimize(buffer.data());
+            }
+        });
+}
+
+const bool  registered{[]
+    {
+        auto   &registry{brace::BenchmarkRegistry::instance()};
+
+        add_stream(registry, "native", brace::Endian::Native);
+        add_stream(registry, "swapped", brace::Endian::Native == brace::Endian::Little ? brace::Endian::Big
+                                                                                       : brace::Endian::Little);
+
+        return true;
+    }()};
+
+}
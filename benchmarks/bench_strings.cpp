@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "brace/benchmark.h"
+#include "brace/string.h"
+
+#include "bench_data.h"
+
+namespace {
+
+const std::string   haystack{bench::repeat_text("2024-05-01 12:00:00 INFO request served in 12 ms\n", 16384)
+                             + "2024-05-01 12:00:01 WARN Connection Reset by peer\n"};
+const std::string   csv{bench::repeat_text("alpha, beta,,gamma ,delta,", 4096)};
+const std::string   words{bench::repeat_text("a to be or not\tin the sum of it all\n", 65536)};
+
+const bool  registered{[]
+    {
+        auto   &registry{brace::BenchmarkRegistry::instance()};
+
+        registry.add("string/ci_find", haystack.size(), []
+            {
+                return brace::ci_find(haystack, "connection reset");
+            });
+
+        registry.add("string/ci_equal", haystack.size(), [upper = brace::to_upper(haystack)]
+            {
+                return brace::ci_equal(haystack, upper);
+            });
+
+        registry.add("string/split", csv.size(), []
+            {
+                size_t  count{0};
+
+                for (auto piece : brace::split(csv, ',', brace::SplitOptions::Trim | brace::SplitOptions::SkipEmpty))
+                    count += piece.size();
+                return count;
+            });
+
+        registry.add("string/tokenize", words.size(), []
+            {
+                size_t  count{0};
+
+                for (auto token : brace::tokenize(words))
+                    count += token.size();
+                return count;
+            });
+
+        registry.add("string/parse_integer", 0, []
+            {
+                uint64_t    value{0};
+
+                brace::do_not_optimize(brace::parse_integer(std::string_view{"18446744073709551615"}, value));
+                return value;
+            });
+
+        registry.add("string/format_integer", 0, []
+            {
+                char    buf[24];
+
+                brace::do_not_optimize(brace::format_integer(uint64_t{18446744073709551615U}, buf));
+                return buf[0];
+            });
+
+        return true;
+    }()};
+
+}
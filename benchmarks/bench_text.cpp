@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brace/benchmark.h"
+#include "brace/byteorder.h"
+#include "brace/encoding_registry.h"
+#include "brace/transcode.h"
+
+#include "bench_data.h"
+
+namespace {
+
+constexpr size_t    text_size{16384};
+
+// The same text in each of the three mixes of characters the transcoding
+// kernels treat differently.
+const std::string   ascii_text{bench::repeat_text("The quick brown fox jumps over the lazy dog. ", text_size)};
+const std::string   latin_text{bench::repeat_text("Fran\xC3\xA7ois \xC3\xA0 la pla\xC3\xA7" "a, d\xC3\xA9j\xC3\xA0 vu. ", text_size)};
+const std::string   cjk_text{bench::repeat_text("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE6\x96\x87\xE7\xAB\xA0\xE3\x80\x82", text_size)};
+
+template <typename SrcCodec, typename DstCodec>
+void add_static(brace::BenchmarkRegistry &registry, const std::string &name, const std::string &text)
+{
+    registry.add("text/" + name, text.size(), [&text](uint64_t n)
+        {
+            std::vector<unsigned char>  out(text.size() * 4);
+            const auto                  in{reinterpret_cast<const unsigned char *>(text.data())};
+
+            for (uint64_t i = 0; i < n; ++i)
+                brace::do_not_optimize(brace::transcode<SrcCodec, DstCodec>(in, text.size(), out.data(), out.size()));
+        });
+}
+
+void add_dynamic(brace::BenchmarkRegistry &registry, const std::string &name, const std::string &text,
+                 const char *dst_name)
+{
+    registry.add("text/" + name, text.size(), [&text, dst_name](uint64_t n)
+        {
+            const auto                 &src{*brace::find_encoding("UTF-8")};
+            const auto                 &dst{*brace::find_encoding(dst_name)};
+            std::vector<unsigned char>  out(text.size() * 4);
+            const auto                  in{reinterpret_cast<const unsigned char *>(text.data())};
+
+            for (uint64_t i = 0; i < n; ++i)
+                brace::do_not_optimize(brace::transcode(src, in, text.size(), dst, out.data(), out.size()));
+        });
+}
+
+const bool  registered{[]
+    {
+        using brace::Endian;
+
+        auto   &registry{brace::BenchmarkRegistry::instance()};
+
+        add_static<brace::UTF8Codec, brace::UTF16Codec<Endian::Little>>(registry, "utf8-utf16le/ascii", ascii_text);
+        add_static<brace::UTF8Codec, brace::UTF16Codec<Endian::Little>>(registry, "utf8-utf16le/latin", latin_text);
+        add_static<brace::UTF8Codec, brace::UTF16Codec<Endian::Little>>(registry, "utf8-utf16le/cjk", cjk_text);
+        add_static<brace::UTF8Codec, brace::UTF32Codec<Endian::Little>>(registry, "utf8-utf32le/latin", latin_text);
+        add_static<brace::UTF8Codec, brace::Latin1Codec<true>>(registry, "utf8-latin1/latin", latin_text);
+        add_static<brace::UTF8Codec, brace::UTF8Codec>(registry, "utf8-utf8/cjk", cjk_text);
+        add_dynamic(registry, "utf8-utf16le/ascii/registry", ascii_text, "UTF-16LE");
+
+        return true;
+    }()};
+
+}
@@ -14,7 +14,17 @@
 #ifndef BRACE_LIB_ASCII_INC
 #define BRACE_LIB_ASCII_INC
 
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "brace/bits.h"
 
 namespace brace {
 class Ascii
@@ -171,7 +181,209 @@ public:
         return ch;
     }
 
+    /// \brief  Find the first character in a string that has any of the
+    ///         specified properties.
+    /// \param str      string to scan
+    /// \param props    property or properties to look for
+    /// \return The index of the first character for which has_property()
+    ///         would return true, or str.size() if there is none.
+    /// \details    This and the other bulk scanners classify 16 or 32
+    ///             characters at a time when SSSE3 or AVX2 is available,
+    ///             using two nibble lookups per vector. Characters outside
+    ///             the ASCII range have no properties.
+    static size_t find_first(std::string_view str, int props) noexcept
+    {
+        return scan(str, props, true);
+    }
+
+    /// \brief  Find the first character in a string that has none of the
+    ///         specified properties.
+    /// \param str      string to scan
+    /// \param props    property or properties to skip over
+    /// \return The index of the first character for which has_property()
+    ///         would return false, or str.size() if there is none.
+    static size_t find_first_not(std::string_view str, int props) noexcept
+    {
+        return scan(str, props, false);
+    }
+
+    /// \brief  Determine the length of the run of characters at the start
+    ///         of a string that have any of the specified properties.
+    /// \param str      string to scan
+    /// \param props    property or properties making up the run
+    /// \return The number of leading characters in the run. For example,
+    ///         span(text, SPACE) is the amount of leading white space.
+    static size_t span(std::string_view str, int props) noexcept
+    {
+        return scan(str, props, false);
+    }
+
+    /// \brief  Count the characters in a string that have any of the
+    ///         specified properties.
+    /// \param str      string to scan
+    /// \param props    property or properties to count
+    /// \return The number of characters for which has_property() would
+    ///         return true.
+    static size_t count(std::string_view str, int props) noexcept
+    {
+        const char     *p{str.data()};
+        const size_t    length{str.size()};
+        size_t          pos{0};
+        size_t          n{0};
+
+#if defined(__SSSE3__)
+        if (length >= block_size)
+        {
+            const __m128i   table{class_bits(props)};
+
+            for (; pos + block_size <= length; pos += block_size)
+                n += static_cast<size_t>(popcount(class_mask(table, p + pos)));
+        }
+#endif
+        for (; pos < length; ++pos)
+            n += has_property(static_cast<unsigned char>(p[pos]), props);
+
+        return n;
+    }
+
 private:
+    // For each low nibble, a bit for each high nibble (0 to 7) that
+    // completes a character in the class.
+    struct ClassTable
+    {
+        unsigned char   bits[16];
+    };
+
+    // The class table of each property, indexed by the position of its
+    // bit in Properties.
+    static constexpr size_t property_count{10};
+
+    struct PropertyTables
+    {
+        ClassTable  property[property_count];
+    };
+
+    static constexpr PropertyTables make_property_tables() noexcept
+    {
+        PropertyTables  tables{};
+
+        for (int ch = 0; ch < 128; ++ch)
+        {
+            for (size_t k = 0; k < property_count; ++k)
+            {
+                if (char_props[ch] & (1 << k))
+                    tables.property[k].bits[ch & 0x0F] |= static_cast<unsigned char>(1U << (ch >> 4));
+            }
+        }
+
+        return tables;
+    }
+
+    static const PropertyTables property_tables;
+
+#if defined(__SSSE3__)
+    // The class table for characters having any of props: the union of
+    // the tables of its properties.
+    static __m128i class_bits(int props) noexcept
+    {
+        __m128i bits{_mm_setzero_si128()};
+
+        for (unsigned m = static_cast<unsigned>(props) & ((1U << property_count) - 1); m != 0; m &= m - 1)
+        {
+            const ClassTable   &table{property_tables.property[countr_zero(m)]};
+
+            bits = _mm_or_si128(bits, _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.bits)));
+        }
+
+        return bits;
+    }
+#endif
+
+    // Bitmask of the characters in a block that are in the class. A
+    // character is in the class when the bit selected by its high nibble
+    // is set in the table entry selected by its low nibble; the high-nibble
+    // lookup yields zero for characters above 0x7F.
+#if defined(__SSSE3__)
+    static constexpr size_t head_size{8};
+#endif
+
+#if defined(__AVX2__)
+    static constexpr size_t block_size{32};
+
+    static uint32_t class_mask(__m128i table, const char *p) noexcept
+    {
+        const __m256i   bits{_mm256_broadcastsi128_si256(table)};
+        const __m256i   high_bits{_mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                   1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)};
+        const __m256i   nibble{_mm256_set1_epi8(0x0F)};
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))};
+        const __m256i   lo{_mm256_shuffle_epi8(bits, _mm256_and_si256(v, nibble))};
+        const __m256i   hi{_mm256_shuffle_epi8(high_bits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble))};
+        const __m256i   none{_mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256())};
+
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(none));
+    }
+#elif defined(__SSSE3__)
+    static constexpr size_t block_size{16};
+
+    static uint32_t class_mask(__m128i bits, const char *p) noexcept
+    {
+        const __m128i   high_bits{_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)};
+        const __m128i   nibble{_mm_set1_epi8(0x0F)};
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))};
+        const __m128i   lo{_mm_shuffle_epi8(bits, _mm_and_si128(v, nibble))};
+        const __m128i   hi{_mm_shuffle_epi8(high_bits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble))};
+        const __m128i   none{_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())};
+
+        return ~static_cast<uint32_t>(_mm_movemask_epi8(none)) & 0xFFFF;
+    }
+#endif
+
+    // Find the first character that is (if wanted is true) or is not in
+    // the class.
+    static size_t scan(std::string_view str, int props, bool wanted) noexcept
+    {
+        const char     *p{str.data()};
+        const size_t    length{str.size()};
+        size_t          pos{0};
+
+#if defined(__SSSE3__)
+        // Runs are often short, like the words of a text and the spaces
+        // between them, so the first few characters are checked one at a
+        // time before the vector loop starts.
+        const size_t    head{length < head_size ? length : head_size};
+
+        for (; pos < head; ++pos)
+        {
+            if (has_property(static_cast<unsigned char>(p[pos]), props) == wanted)
+                return pos;
+        }
+
+        if (length - pos >= block_size)
+        {
+            const __m128i   table{class_bits(props)};
+            const uint32_t  all{block_size == 32 ? ~uint32_t{0} : 0xFFFFU};
+
+            for (; pos + block_size <= length; pos += block_size)
+            {
+                const uint32_t  mask{class_mask(table, p + pos)};
+                const uint32_t  found{wanted ? mask : mask ^ all};
+
+                if (found != 0)
+                    return pos + static_cast<size_t>(countr_zero(found));
+            }
+        }
+#endif
+        // Finish the tail.
+        for (; pos < length; ++pos)
+        {
+            if (has_property(static_cast<unsigned char>(p[pos]), props) == wanted)
+                break;
+        }
+
+        return pos;
+    }
+
     inline constexpr static int char_props[128] = {
     /* 00   */ CONTROL,
     /* 01   */ CONTROL,
@@ -304,5 +516,7 @@ private:
     };
 };
 
+inline constexpr Ascii::PropertyTables  Ascii::property_tables{Ascii::make_property_tables()};
+
 }
 #endif  // BRACE_LIB_ASCII_INC
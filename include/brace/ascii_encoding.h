@@ -14,8 +14,19 @@
 #ifndef BRACE_LIB_ASCII_ENCODING_INC
 #define BRACE_LIB_ASCII_ENCODING_INC
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 #include "brace/text_encoding.h"
 #include "brace/string.h"
+#include "brace/text_codec.h"
 
 namespace brace {
 class ASCIIEncoding : public TextEncoding
@@ -71,7 +82,17 @@ public:
     ///         if successful, -1 otherwise.
     int decode(const unsigned char *bytes) const noexcept override
     {
-        return _map[*bytes];
+        return decode_sequence<ASCIICodec>(bytes);
+    }
+
+    /// \brief  Decode the character at the start of a bounded byte sequence.
+    /// \param bytes    Pointer to a byte sequence.
+    /// \param length   Number of bytes available at \p bytes.
+    /// \return A DecodeResult holding the character and a length of one,
+    ///         or DecodeResult::invalid if the byte is not ASCII.
+    DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept override
+    {
+        return decode_sequence<ASCIICodec>(bytes, length);
     }
 
     /// \brief  Encode the Unicode character ch into a byte sequence.
@@ -81,14 +102,73 @@ public:
     /// \return The number of bytes used in the conversion.
     int encode(int ch, unsigned char *bytes, int length) const noexcept override
     {
-        if (ch >= 0 && ch <= 127)
+        return encode_sequence<ASCIICodec>(ch, bytes, length);
+    }
+
+    /// \brief  Determine the length of a byte sequence.
+    /// \param bytes    Pointer to byte sequence
+    /// \param length   Maximum length of byte sequence
+    /// \return Length of the byte sequence.
+    int sequence_length(const unsigned char *bytes, int length) const noexcept override
+    {
+        return measure_sequence<ASCIICodec>(bytes, length);
+    }
+
+    /// \brief  Find the first byte in a buffer that is not ASCII.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return The offset of the first byte above 0x7F, or \p length if
+    ///         every byte is ASCII.
+    /// \details    The buffer is checked 32 or 16 bytes at a time when AVX2
+    ///             or SSE2 is available, and eight bytes at a time otherwise.
+    static size_t find_invalid(const unsigned char *bytes, size_t length) noexcept
+    {
+        size_t  pos{0};
+
+#if defined(__AVX2__)
+        for (; pos + 32 <= length; pos += 32)
+        {
+            const auto  mask{static_cast<uint32_t>(_mm256_movemask_epi8(
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + pos))))};
+
+            if (mask)
+                break;
+        }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+        for (; pos + 16 <= length; pos += 16)
         {
-            if (bytes && length >= 1)
-                *bytes = static_cast<unsigned char>(ch);
-            return 1;
+            const auto  mask{static_cast<uint32_t>(_mm_movemask_epi8(
+                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + pos))))};
+
+            if (mask)
+                break;
         }
+#endif
+        for (; pos + 8 <= length; pos += 8)
+        {
+            uint64_t    word;
 
-        return 0;
+            std::memcpy(&word, bytes + pos, sizeof(word));
+            if (word & 0x8080808080808080ULL)
+                break;
+        }
+        for (; pos < length; ++pos)
+        {
+            if (bytes[pos] > 0x7F)
+                break;
+        }
+
+        return pos;
+    }
+
+    /// \brief  Determine if a buffer contains only ASCII.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return \c true if every byte is in the range 0x00 to 0x7F.
+    static bool validate(const unsigned char *bytes, size_t length) noexcept
+    {
+        return find_invalid(bytes, length) == length;
     }
 
 private:
@@ -14,13 +14,16 @@
 #ifndef BRACE_LIB_BASE16_INC
 #define BRACE_LIB_BASE16_INC
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <istream>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <ostream>
 #include <string>
 #include <string_view>
-#include <variant>
 #include <vector>
 
 #include "binistream.h"
@@ -124,13 +127,11 @@ private:
     /// @param handle_newline   \c true if the decoding operation should handle new-line
     ///                         characters in the encoded input. If \c false, new-line
     ///                         characters are treated as invalid data.
-    /// @return An \c std::variant object containing either a \c bool or a brace::BasicParseError
-    ///         object. If a decoding error occurs, the variant will contain a brace::BasicParseError
-    ///         object indicating the error. Otherwise the function will return \c true on success
-    ///         or \c false on error. A return value of \c false indicates that the out_func function
-    ///         object failed.
+    /// @return A brace::CodecDecodeResult describing the first error found in the input, or
+    ///         CodecDecodeError::OutputFailed if the out_func function object failed. Building
+    ///         the result never allocates.
     [[nodiscard]]
-    std::variant<bool, brace::BasicParseError>
+    CodecDecodeResult
     do_decode(std::function<bool(char &)> in_func, std::function<bool(uint8_t)> out_func, bool handle_newline) const
     {
         char                ch;
@@ -149,7 +150,7 @@ private:
                     uint8_t byte{static_cast<uint8_t>((get_index(duo[0]) << 4) | (get_index(duo[1]) & 0x0F))};
 
                     if (!out_func(byte))
-                        return false;
+                        return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
 
                     duo_pos = 0;
                 }
@@ -161,29 +162,24 @@ private:
             }
             else
             {
-                return brace::BasicParseError{line, pos, "Invalid character"};
+                return CodecDecodeResult{CodecDecodeError::InvalidCharacter, line, pos, "Invalid character"};
             }
+
+            ++pos;
         }
 
         if (duo_pos)
-            return brace::BasicParseError{line, pos, "Length error"};
+            return CodecDecodeResult{CodecDecodeError::InvalidLength, line, pos, "Length error"};
 
-        return true;
+        return CodecDecodeResult{};
     }
 
-public:
-    /// \brief  Encode data from a range of bytes to a Base16 encoded string
-    /// \param beg      Iterator at the beginning of the data to be encoded.
-    /// \param end      Iterator at one past the end of the data to be encoded.
-    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
-    /// \return A string containing the Base16 encoded data.
-    template<typename input_iterator>
-    auto encode(input_iterator beg, input_iterator end, size_t wrapat = 0) const
-            -> std::enable_if_t<sizeof(*beg) == 1, std::string>
+    /// \brief  Encode a range of bytes, appending the characters to a string.
+    template<typename input_iterator, typename String>
+    void encode_range(input_iterator beg, input_iterator end, String &rv, size_t wrapat) const
     {
         const auto  in_size{end - beg};
         const auto  out_size{in_size * 2};
-        std::string rv;
 
         auto    in_func = [&beg, &end, wrapat](uint8_t &b)
                 {
@@ -201,17 +197,12 @@ public:
         rv.reserve(out_size);
 
         do_encode(in_func, out_func, wrapat);
-        return rv;
     }
 
-    /// \brief  Encode data from a binary stream to a Base16 encoded string.
-    /// \param instream brace::BinIStream containing the data to be encoded.
-    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
-    /// \return A string containing the encoded data.
-    std::string encode(brace::BinIStream &instream, size_t wrapat = 0) const
+    /// \brief  Encode a binary stream, appending the characters to a string.
+    template<typename String>
+    void encode_stream(brace::BinIStream &instream, String &rv, size_t wrapat) const
     {
-        std::string rv;
-
         auto    in_func = [&instream](uint8_t &b)
                 {
                     instream.get(b);
@@ -224,8 +215,180 @@ public:
                 };
 
         do_encode(in_func, out_func, wrapat);
+    }
+
+    /// \brief  Decode a string, appending the bytes to a vector.
+    template<typename Vector>
+    [[nodiscard]] CodecDecodeResult
+    decode_string(std::string_view str, Vector &rv, bool handle_newline) const
+    {
+        const size_t    start{rv.size()};
+        const size_t    out_size{str.size() / 2};
+
+        auto    in_it{str.begin()};
+        auto    in_func = [&in_it, &str](char &ch)
+                {
+                    if (in_it != str.end())
+                    {
+                        ch = *in_it++;
+                        return true;
+                    }
+                    return false;
+                };
+        auto    out_func = [&rv, start, out_size](uint8_t b)
+                {
+                    // Reserve only once the first group has decoded, so
+                    // that rejected input allocates nothing.
+                    if (rv.size() == start)
+                        rv.reserve(start + out_size);
+                    rv.push_back(b);
+                    return true;
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = rv.size() - start;
+        return result;
+    }
+
+    /// \brief  Decode a standard stream, appending the bytes to a vector.
+    template<typename Vector>
+    [[nodiscard]] CodecDecodeResult
+    decode_stream(std::istream &instream, Vector &rv, bool handle_newline) const
+    {
+        auto    in_func = [&instream](char &ch)
+                {
+                    return instream.get(ch).good();
+                };
+        auto    out_func = [&rv](uint8_t b)
+                {
+                    rv.push_back(b);
+                    return true;
+                };
+
+        const size_t        start{rv.size()};
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = rv.size() - start;
+        return result;
+    }
+
+    /// \brief  Decode a string, writing the bytes to a binary stream.
+    [[nodiscard]] CodecDecodeResult
+    decode_string(std::string_view str, brace::BinOStream &outstream, bool handle_newline) const
+    {
+        auto    in_it{str.begin()};
+        auto    in_func = [&in_it, &str](char &ch)
+                {
+                    if (in_it != str.end())
+                    {
+                        ch = *in_it++;
+                        return true;
+                    }
+                    return false;
+                };
+        size_t  bytes_written{0};
+        auto    out_func = [&outstream, &bytes_written](uint8_t b)
+                {
+                    if (outstream.put(b) == b)
+                        ++bytes_written;
+                    return outstream.good();
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = bytes_written;
+        return result;
+    }
+
+    /// \brief  Decode a standard stream, writing the bytes to a binary stream.
+    [[nodiscard]] CodecDecodeResult
+    decode_stream(std::istream &instream, brace::BinOStream &outstream, bool handle_newline) const
+    {
+        auto    in_func = [&instream](char &ch)
+                {
+                    return instream.get(ch).good();
+                };
+        size_t  bytes_written{0};
+        auto    out_func = [&outstream, &bytes_written](uint8_t b)
+                {
+                    if (outstream.put(b) == b)
+                        ++bytes_written;
+                    return outstream.good();
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = bytes_written;
+        return result;
+    }
+
+public:
+    /// \brief  Encode data from a range of bytes to a Base16 encoded string
+    /// \param beg      Iterator at the beginning of the data to be encoded.
+    /// \param end      Iterator at one past the end of the data to be encoded.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the Base16 encoded data.
+    template<typename input_iterator>
+    auto encode(input_iterator beg, input_iterator end, size_t wrapat = 0) const
+            -> std::enable_if_t<sizeof(*beg) == 1, std::string>
+    {
+        std::string rv;
+
+        encode_range(beg, end, rv, wrapat);
+        return rv;
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Encode data from a range of bytes to a Base16 encoded string
+    ///         allocated from a memory resource.
+    /// \param beg      Iterator at the beginning of the data to be encoded.
+    /// \param end      Iterator at one past the end of the data to be encoded.
+    /// \param resource Memory resource from which to allocate the returned
+    ///                 string.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the Base16 encoded data.
+    template<typename input_iterator, typename Resource>
+    auto encode(input_iterator beg, input_iterator end, Resource *resource, size_t wrapat = 0) const
+            -> std::enable_if_t<sizeof(*beg) == 1 && std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        std::pmr::string    rv{resource};
+
+        encode_range(beg, end, rv, wrapat);
+        return rv;
+    }
+#endif
+
+    /// \brief  Encode data from a binary stream to a Base16 encoded string.
+    /// \param instream brace::BinIStream containing the data to be encoded.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the encoded data.
+    std::string encode(brace::BinIStream &instream, size_t wrapat = 0) const
+    {
+        std::string rv;
+
+        encode_stream(instream, rv, wrapat);
+        return rv;
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Encode data from a binary stream to a Base16 encoded string
+    ///         allocated from a memory resource.
+    /// \param instream brace::BinIStream containing the data to be encoded.
+    /// \param resource Memory resource from which to allocate the returned
+    ///                 string.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the encoded data.
+    template<typename Resource>
+    auto encode(brace::BinIStream &instream, Resource *resource, size_t wrapat = 0) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        std::pmr::string    rv{resource};
+
+        encode_stream(instream, rv, wrapat);
         return rv;
     }
+#endif
 
     /// \brief  Encode data from a range of bytes to a stream.
     /// \param beg  Iterator at the beginning of the input data.
@@ -293,32 +456,32 @@ public:
     std::vector<uint8_t> decode(std::string_view str, bool handle_newline = false) const
     {
         std::vector<uint8_t>    rv;
-        const auto              out_size{str.size() / 2};
-        rv.reserve(out_size);
 
-        auto    in_it{str.begin()};
-        auto    in_func = [&in_it, &str](char &ch)
-                {
-                    if (in_it != str.end())
-                    {
-                        ch = *in_it++;
-                        return true;
-                    }
-                    return false;
-                };
-        auto    out_func = [&rv](uint8_t b)
-                {
-                    rv.push_back(b);
-                    return true;
-                };
-
-        auto    result{do_decode(in_func, out_func, handle_newline)};
+        decode_string(str, rv, handle_newline).throw_if_invalid();
+        return rv;
+    }
 
-        if (std::holds_alternative<brace::BasicParseError>(result))
-            throw std::get<brace::BasicParseError>(result);
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode a Base16 encoded string to its original array of bytes
+    ///         allocated from a memory resource.
+    /// \param str              Base16 encoded string data to decode.
+    /// \param resource         Memory resource from which to allocate the
+    ///                         returned vector.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return On success returns a std::pmr::vector<uint8_t> containing the decoded bytes.
+    /// \exception  brace::BasicParseError if errors are encountered in the encoded data.
+    template<typename Resource>
+    auto decode(std::string_view str, Resource *resource, bool handle_newline = false) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        std::pmr::vector<uint8_t>   rv{resource};
 
+        decode_string(str, rv, handle_newline).throw_if_invalid();
         return rv;
     }
+#endif
 
     /// \brief  Decode a Base16 encoded string to its original array of bytes,
     ///         storing the decoded data into a \c std::ostream.
@@ -335,30 +498,10 @@ public:
     ///             The state of the output stream can be checked for errors.
     size_t decode(std::string_view str, brace::BinOStream &outstream, bool handle_newline = false) const
     {
-        auto    in_it{str.begin()};
-        auto    in_func = [&in_it, &str](char &ch)
-                {
-                    if (in_it != str.end())
-                    {
-                        ch = *in_it++;
-                        return true;
-                    }
-                    return false;
-                };
-        size_t  bytes_written{0};
-        auto    out_func = [&outstream, &bytes_written](uint8_t b)
-                {
-                    if (outstream.put(b) == b)
-                        ++bytes_written;
-                    return outstream.good();
-                };
+        auto    result{decode_string(str, outstream, handle_newline)};
 
-        auto    rv{do_decode(in_func, out_func, handle_newline)};
-
-        if (std::holds_alternative<brace::BasicParseError>(rv))
-            throw std::get<brace::BasicParseError>(rv);
-
-        return bytes_written;
+        result.throw_if_invalid();
+        return result.size;
     }
 
     /// \brief  Decode Base16 encoded data from a standard stream into a \c brace::BinOStream.
@@ -375,24 +518,10 @@ public:
     ///             The state of the input and output streams can be checked for errors.
     size_t decode(std::istream &instream, brace::BinOStream &outstream, bool handle_newline = false) const
     {
-        auto    in_func = [&instream](char &ch)
-                {
-                    return instream.get(ch).good();
-                };
-        size_t  bytes_written{0};
-        auto    out_func = [&outstream, &bytes_written](uint8_t b)
-                {
-                    if (outstream.put(b) == b)
-                        ++bytes_written;
-                    return outstream.good();
-                };
-
-        auto    rv{do_decode(in_func, out_func, handle_newline)};
-
-        if (std::holds_alternative<brace::BasicParseError>(rv))
-            throw std::get<brace::BasicParseError>(rv);
+        auto    result{decode_stream(instream, outstream, handle_newline)};
 
-        return bytes_written;
+        result.throw_if_invalid();
+        return result.size;
     }
 
     /// \brief  Decode Base16 encoded data from a standard stream into a vector.
@@ -406,22 +535,110 @@ public:
     decode(std::istream &instream, bool handle_newline = false) const
     {
         std::vector<uint8_t>    rv;
-        auto    in_func = [&instream](char &ch)
-                {
-                    return instream.get(ch).good();
-                };
-        auto    out_func = [&rv](uint8_t b)
-                {
-                    rv.push_back(b);
-                    return true;
-                };
-        auto result{do_decode(in_func, out_func, handle_newline)};
 
-        if (std::holds_alternative<brace::BasicParseError>(result))
-            throw std::get<brace::BasicParseError>(result);
+        decode_stream(instream, rv, handle_newline).throw_if_invalid();
+        return rv;
+    }
 
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode Base16 encoded data from a standard stream into a vector
+    ///         allocated from a memory resource.
+    /// \param instream         Standard \c istream containing Base16 encoded data.
+    /// \param resource         Memory resource from which to allocate the
+    ///                         returned vector.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A std::pmr::vector<uint8_t> containing the decoded data.
+    /// \exception  brace::BasicParseError if errors are encountered in the encoded data.
+    template<typename Resource>
+    auto decode(std::istream &instream, Resource *resource, bool handle_newline = false) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        std::pmr::vector<uint8_t>   rv{resource};
+
+        decode_stream(instream, rv, handle_newline).throw_if_invalid();
         return rv;
     }
+#endif
+
+    /// \brief  Decode a Base16 encoded string without throwing.
+    /// \param str              Base16 encoded string data to decode.
+    /// \param out              Vector to which the decoded bytes are appended.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes appended.
+    /// \details    Invalid input is reported without throwing or allocating.
+    ///             Bytes decoded before an error remain in \p out. Reusing
+    ///             \p out across calls avoids allocating on success as well.
+    CodecDecodeResult try_decode(std::string_view str, std::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_string(str, out, handle_newline);
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode a Base16 encoded string into a std::pmr::vector without
+    ///         throwing.
+    /// \see    try_decode(std::string_view, std::vector<uint8_t> &, bool) const
+    CodecDecodeResult try_decode(std::string_view str, std::pmr::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_string(str, out, handle_newline);
+    }
+#endif
+
+    /// \brief  Decode a Base16 encoded string into a \c brace::BinOStream
+    ///         without throwing.
+    /// \param str              Base16 encoded string data to decode.
+    /// \param outstream        brace::BinOStream to receive the decoded bytes.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes written.
+    CodecDecodeResult try_decode(std::string_view str, brace::BinOStream &outstream, bool handle_newline = false) const
+    {
+        return decode_string(str, outstream, handle_newline);
+    }
+
+    /// \brief  Decode Base16 encoded data from a standard stream into a
+    ///         \c brace::BinOStream without throwing.
+    /// \param instream         Standard \c istream containing Base16 encoded data.
+    /// \param outstream        \c brace::BinOStream to receive the decoded bytes.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes written.
+    CodecDecodeResult try_decode(std::istream &instream, brace::BinOStream &outstream, bool handle_newline = false) const
+    {
+        return decode_stream(instream, outstream, handle_newline);
+    }
+
+    /// \brief  Decode Base16 encoded data from a standard stream into a vector
+    ///         without throwing.
+    /// \param instream         Standard \c istream containing Base16 encoded data.
+    /// \param out              Vector to which the decoded bytes are appended.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes appended.
+    CodecDecodeResult try_decode(std::istream &instream, std::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_stream(instream, out, handle_newline);
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode Base16 encoded data from a standard stream into a
+    ///         std::pmr::vector without throwing.
+    /// \see    try_decode(std::istream &, std::vector<uint8_t> &, bool) const
+    CodecDecodeResult try_decode(std::istream &instream, std::pmr::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_stream(instream, out, handle_newline);
+    }
+#endif
 };
 
 }
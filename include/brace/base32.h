@@ -18,10 +18,12 @@
 #include <cstdint>
 #include <functional>
 #include <istream>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <ostream>
 #include <string>
 #include <string_view>
-#include <variant>
 #include <vector>
 
 #include "binistream.h"
@@ -233,16 +235,14 @@ protected:
     /// \param handle_newline   If \c true, newline characters are effectively
     ///                         ignored in the input data. If \c false,
     ///                         newline characters are considered to be invalid.
-    /// \return An std::variant containing either a boolean value indicating
-    ///         success or failure, or a brace::BasicParseError indicating that
-    ///         an error was encountered in the input data. A return value of
-    ///         boolean \c false generally indicates a failure in the
-    ///         \c out_func output function.
+    /// \return A brace::CodecDecodeResult describing the first error found in
+    ///         the input data, or CodecDecodeError::OutputFailed if the \c out_func
+    ///         output function failed. Building the result never allocates.
     /// \details    This is the workhorse function for decoding data. The \c decode
     ///             functions in the public interface call this function, providing
     ///             custom functions (in the form of lambda expressions), passing them
     ///             as the \c in_func and \c out_func parameters.
-    std::variant<bool, brace::BasicParseError>
+    CodecDecodeResult
     do_decode(std::function<bool(char &)> in_func, std::function<bool(uint8_t)> out_func, bool handle_newline) const
     {
         std::array<char, 8> eights;
@@ -257,7 +257,7 @@ protected:
             if (is_valid_character(ch))
             {
                 if (pad_count)  // already seen a padding character, so something's broken.
-                    return brace::BasicParseError{line, pos, bad_char_msg};
+                    return CodecDecodeResult{CodecDecodeError::InvalidCharacter, line, pos, bad_char_msg};
 
                 eights[eights_pos++] = ch;
                 if (eights_pos == 8)
@@ -266,7 +266,7 @@ protected:
 
                     for (auto b : bytes)
                         if (!out_func(b))
-                            return false;
+                            return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
 
                     eights_pos = 0;
                 }
@@ -284,7 +284,7 @@ protected:
                 }
                 else
                 {
-                    return brace::BasicParseError{line, pos, bad_char_msg};
+                    return CodecDecodeResult{CodecDecodeError::InvalidCharacter, line, pos, bad_char_msg};
                 }
             }
 
@@ -293,49 +293,44 @@ protected:
 
         if (eights_pos) // partial set remaining
         {
-            std::string s{eights.data(), eights.size()};
-            for (int i=eights_pos; i < 8; ++i)
+            std::array<char, 8> s{eights};
+            for (size_t i=eights_pos; i < 8; ++i)
                 s[i] = 'A';
-            auto    bytes{decode_eights(s)};
+            auto    bytes{decode_eights({s.data(), s.size()})};
             switch (eights_pos)
             {
                 case 2:
-                    return out_func(bytes[0]);
+                    if (!out_func(bytes[0]))
+                        return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
+                    break;
                 case 3:
                 case 4:
                     for (size_t i=0; i < 2; ++i)
                         if (!out_func(bytes[i]))
-                            return false;
+                            return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
                     break;
                 case 5:
                     for (size_t i=0; i < 3; ++i)
                         if (!out_func(bytes[i]))
-                            return false;
+                            return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
                     break;
                 case 6:
                 case 7:
                     for (size_t i=0; i < 4; ++i)
                         if (!out_func(bytes[i]))
-                            return false;
+                            return CodecDecodeResult{CodecDecodeError::OutputFailed, line, pos, "Write failed"};
             }
         }
 
-        return true;
+        return CodecDecodeResult{};
     }
 
-public:
-    /// \brief  Encode data from a range of bytes to a Base32 encoded string
-    /// \param beg      Iterator at the beginning of the data to be encoded.
-    /// \param end      Iterator at one past the end of the data to be encoded.
-    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
-    /// \return A string containing the Base32 encoded data.
-    template<typename input_iterator>
-    auto encode(input_iterator beg, input_iterator end, size_t wrapat = 0) const
-            -> std::enable_if_t<sizeof(*beg) == 1, std::string>
+    /// \brief  Encode a range of bytes, appending the characters to a string.
+    template<typename input_iterator, typename String>
+    void encode_range(input_iterator beg, input_iterator end, String &rv, size_t wrapat) const
     {
         const auto  in_size{end - beg};
-        const auto  out_size{((in_size + 2) / 3) * 4};
-        std::string rv;
+        const auto  out_size{((in_size + 4) / 5) * 8};
 
         auto    in_func = [&beg, &end, wrapat](uint8_t &b)
                 {
@@ -353,17 +348,12 @@ public:
         rv.reserve(out_size);
 
         do_encode(in_func, out_func, wrapat);
-        return rv;
     }
 
-    /// \brief  Encode data from a binary stream to a Base32 encoded string.
-    /// \param instream brace::BinIStream containing the data to be encoded.
-    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
-    /// \return A string containing the encoded data.
-    std::string encode(brace::BinIStream &instream, size_t wrapat = 0) const
+    /// \brief  Encode a binary stream, appending the characters to a string.
+    template<typename String>
+    void encode_stream(brace::BinIStream &instream, String &rv, size_t wrapat) const
     {
-        std::string rv;
-
         auto    in_func = [&instream](uint8_t &b)
                 {
                     instream.get(b);
@@ -376,8 +366,180 @@ public:
                 };
 
         do_encode(in_func, out_func, wrapat);
+    }
+
+    /// \brief  Decode a string, appending the bytes to a vector.
+    template<typename Vector>
+    [[nodiscard]] CodecDecodeResult
+    decode_string(std::string_view str, Vector &rv, bool handle_newline) const
+    {
+        const size_t    start{rv.size()};
+        const size_t    out_size{(str.size() / 8) * 5};
+
+        auto    in_it{str.begin()};
+        auto    in_func = [&in_it, &str](char &ch)
+                {
+                    if (in_it != str.end())
+                    {
+                        ch = *in_it++;
+                        return true;
+                    }
+                    return false;
+                };
+        auto    out_func = [&rv, start, out_size](uint8_t b)
+                {
+                    // Reserve only once the first group has decoded, so
+                    // that rejected input allocates nothing.
+                    if (rv.size() == start)
+                        rv.reserve(start + out_size);
+                    rv.push_back(b);
+                    return true;
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = rv.size() - start;
+        return result;
+    }
+
+    /// \brief  Decode a standard stream, appending the bytes to a vector.
+    template<typename Vector>
+    [[nodiscard]] CodecDecodeResult
+    decode_stream(std::istream &instream, Vector &rv, bool handle_newline) const
+    {
+        auto    in_func = [&instream](char &ch)
+                {
+                    return instream.get(ch).good();
+                };
+        auto    out_func = [&rv](uint8_t b)
+                {
+                    rv.push_back(b);
+                    return true;
+                };
+
+        const size_t        start{rv.size()};
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = rv.size() - start;
+        return result;
+    }
+
+    /// \brief  Decode a string, writing the bytes to a binary stream.
+    [[nodiscard]] CodecDecodeResult
+    decode_string(std::string_view str, brace::BinOStream &outstream, bool handle_newline) const
+    {
+        auto    in_it{str.begin()};
+        auto    in_func = [&in_it, &str](char &ch)
+                {
+                    if (in_it != str.end())
+                    {
+                        ch = *in_it++;
+                        return true;
+                    }
+                    return false;
+                };
+        size_t  bytes_written{0};
+        auto    out_func = [&outstream, &bytes_written](uint8_t b)
+                {
+                    if (outstream.put(b) == b)
+                        ++bytes_written;
+                    return outstream.good();
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = bytes_written;
+        return result;
+    }
+
+    /// \brief  Decode a standard stream, writing the bytes to a binary stream.
+    [[nodiscard]] CodecDecodeResult
+    decode_stream(std::istream &instream, brace::BinOStream &outstream, bool handle_newline) const
+    {
+        auto    in_func = [&instream](char &ch)
+                {
+                    return instream.get(ch).good();
+                };
+        size_t  bytes_written{0};
+        auto    out_func = [&outstream, &bytes_written](uint8_t b)
+                {
+                    if (outstream.put(b) == b)
+                        ++bytes_written;
+                    return outstream.good();
+                };
+
+        CodecDecodeResult   result{do_decode(in_func, out_func, handle_newline)};
+
+        result.size = bytes_written;
+        return result;
+    }
+
+public:
+    /// \brief  Encode data from a range of bytes to a Base32 encoded string
+    /// \param beg      Iterator at the beginning of the data to be encoded.
+    /// \param end      Iterator at one past the end of the data to be encoded.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the Base32 encoded data.
+    template<typename input_iterator>
+    auto encode(input_iterator beg, input_iterator end, size_t wrapat = 0) const
+            -> std::enable_if_t<sizeof(*beg) == 1, std::string>
+    {
+        std::string rv;
+
+        encode_range(beg, end, rv, wrapat);
+        return rv;
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Encode data from a range of bytes to a Base32 encoded string
+    ///         allocated from a memory resource.
+    /// \param beg      Iterator at the beginning of the data to be encoded.
+    /// \param end      Iterator at one past the end of the data to be encoded.
+    /// \param resource Memory resource from which to allocate the returned
+    ///                 string.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the Base32 encoded data.
+    template<typename input_iterator, typename Resource>
+    auto encode(input_iterator beg, input_iterator end, Resource *resource, size_t wrapat = 0) const
+            -> std::enable_if_t<sizeof(*beg) == 1 && std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        std::pmr::string    rv{resource};
+
+        encode_range(beg, end, rv, wrapat);
         return rv;
     }
+#endif
+
+    /// \brief  Encode data from a binary stream to a Base32 encoded string.
+    /// \param instream brace::BinIStream containing the data to be encoded.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the encoded data.
+    std::string encode(brace::BinIStream &instream, size_t wrapat = 0) const
+    {
+        std::string rv;
+
+        encode_stream(instream, rv, wrapat);
+        return rv;
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Encode data from a binary stream to a Base32 encoded string
+    ///         allocated from a memory resource.
+    /// \param instream brace::BinIStream containing the data to be encoded.
+    /// \param resource Memory resource from which to allocate the returned
+    ///                 string.
+    /// \param wrapat   Position at which to wrap lines. If zero, no line wrapping occurs.
+    /// \return A string containing the encoded data.
+    template<typename Resource>
+    auto encode(brace::BinIStream &instream, Resource *resource, size_t wrapat = 0) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        std::pmr::string    rv{resource};
+
+        encode_stream(instream, rv, wrapat);
+        return rv;
+    }
+#endif
 
     /// \brief  Encode data from a range of bytes to a stream.
     /// \param beg  Iterator at the beginning of the input data.
@@ -446,32 +608,32 @@ public:
     std::vector<uint8_t> decode(std::string_view str, bool handle_newline = false) const
     {
         std::vector<uint8_t>    rv;
-        const auto              out_size{((str.size() + 4) / 5) * 8};
-        rv.reserve(out_size);
 
-        auto    in_it{str.begin()};
-        auto    in_func = [&in_it, &str](char &ch)
-                {
-                    if (in_it != str.end())
-                    {
-                        ch = *in_it++;
-                        return true;
-                    }
-                    return false;
-                };
-        auto    out_func = [&rv](uint8_t b)
-                {
-                    rv.push_back(b);
-                    return true;
-                };
-
-        auto    result{do_decode(in_func, out_func, handle_newline)};
+        decode_string(str, rv, handle_newline).throw_if_invalid();
+        return rv;
+    }
 
-        if (std::holds_alternative<brace::BasicParseError>(result))
-            throw std::get<brace::BasicParseError>(result);
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode a Base32 encoded string to its original array of bytes
+    ///         allocated from a memory resource.
+    /// \param str              Base32 encoded string data to decode.
+    /// \param resource         Memory resource from which to allocate the
+    ///                         returned vector.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return On success returns a std::pmr::vector<uint8_t> containing the decoded bytes.
+    /// \exception  brace::BasicParseError if errors are encountered in the encoded data.
+    template<typename Resource>
+    auto decode(std::string_view str, Resource *resource, bool handle_newline = false) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        std::pmr::vector<uint8_t>   rv{resource};
 
+        decode_string(str, rv, handle_newline).throw_if_invalid();
         return rv;
     }
+#endif
 
     /// \brief  Decode a Base32 encoded string to its original array of bytes,
     ///         storing the decoded data into a \c std::ostream.
@@ -488,30 +650,10 @@ public:
     ///             The state of the output stream can be checked for errors.
     size_t decode(std::string_view str, brace::BinOStream &outstream, bool handle_newline = false) const
     {
-        auto    in_it{str.begin()};
-        auto    in_func = [&in_it, &str](char &ch)
-                {
-                    if (in_it != str.end())
-                    {
-                        ch = *in_it++;
-                        return true;
-                    }
-                    return false;
-                };
-        size_t  bytes_written{0};
-        auto    out_func = [&outstream, &bytes_written](uint8_t b)
-                {
-                    if (outstream.put(b) == b)
-                        ++bytes_written;
-                    return outstream.good();
-                };
+        auto    result{decode_string(str, outstream, handle_newline)};
 
-        auto    rv{do_decode(in_func, out_func, handle_newline)};
-
-        if (std::holds_alternative<brace::BasicParseError>(rv))
-            throw std::get<brace::BasicParseError>(rv);
-
-        return bytes_written;
+        result.throw_if_invalid();
+        return result.size;
     }
 
     /// \brief  Decode Base32 encoded data from a standard stream into a \c brace::BinOStream.
@@ -528,24 +670,10 @@ public:
     ///             The state of the input and output streams can be checked for errors.
     size_t decode(std::istream &instream, brace::BinOStream &outstream, bool handle_newline = false) const
     {
-        auto    in_func = [&instream](char &ch)
-                {
-                    return instream.get(ch).good();
-                };
-        size_t  bytes_written{0};
-        auto    out_func = [&outstream, &bytes_written](uint8_t b)
-                {
-                    if (outstream.put(b) == b)
-                        ++bytes_written;
-                    return outstream.good();
-                };
-
-        auto    rv{do_decode(in_func, out_func, handle_newline)};
-
-        if (std::holds_alternative<brace::BasicParseError>(rv))
-            throw std::get<brace::BasicParseError>(rv);
+        auto    result{decode_stream(instream, outstream, handle_newline)};
 
-        return bytes_written;
+        result.throw_if_invalid();
+        return result.size;
     }
 
     /// \brief  Decode Base32 encoded data from a standard stream into a vector.
@@ -559,22 +687,110 @@ public:
     decode(std::istream &instream, bool handle_newline = false) const
     {
         std::vector<uint8_t>    rv;
-        auto    in_func = [&instream](char &ch)
-                {
-                    return instream.get(ch).good();
-                };
-        auto    out_func = [&rv](uint8_t b)
-                {
-                    rv.push_back(b);
-                    return true;
-                };
-        auto result{do_decode(in_func, out_func, handle_newline)};
 
-        if (std::holds_alternative<brace::BasicParseError>(result))
-            throw std::get<brace::BasicParseError>(result);
+        decode_stream(instream, rv, handle_newline).throw_if_invalid();
+        return rv;
+    }
 
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode Base32 encoded data from a standard stream into a vector
+    ///         allocated from a memory resource.
+    /// \param instream         Standard \c istream containing Base32 encoded data.
+    /// \param resource         Memory resource from which to allocate the
+    ///                         returned vector.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A std::pmr::vector<uint8_t> containing the decoded data.
+    /// \exception  brace::BasicParseError if errors are encountered in the encoded data.
+    template<typename Resource>
+    auto decode(std::istream &instream, Resource *resource, bool handle_newline = false) const
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        std::pmr::vector<uint8_t>   rv{resource};
+
+        decode_stream(instream, rv, handle_newline).throw_if_invalid();
         return rv;
     }
+#endif
+
+    /// \brief  Decode a Base32 encoded string without throwing.
+    /// \param str              Base32 encoded string data to decode.
+    /// \param out              Vector to which the decoded bytes are appended.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes appended.
+    /// \details    Invalid input is reported without throwing or allocating.
+    ///             Bytes decoded before an error remain in \p out. Reusing
+    ///             \p out across calls avoids allocating on success as well.
+    CodecDecodeResult try_decode(std::string_view str, std::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_string(str, out, handle_newline);
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode a Base32 encoded string into a std::pmr::vector without
+    ///         throwing.
+    /// \see    try_decode(std::string_view, std::vector<uint8_t> &, bool) const
+    CodecDecodeResult try_decode(std::string_view str, std::pmr::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_string(str, out, handle_newline);
+    }
+#endif
+
+    /// \brief  Decode a Base32 encoded string into a \c brace::BinOStream
+    ///         without throwing.
+    /// \param str              Base32 encoded string data to decode.
+    /// \param outstream        brace::BinOStream to receive the decoded bytes.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes written.
+    CodecDecodeResult try_decode(std::string_view str, brace::BinOStream &outstream, bool handle_newline = false) const
+    {
+        return decode_string(str, outstream, handle_newline);
+    }
+
+    /// \brief  Decode Base32 encoded data from a standard stream into a
+    ///         \c brace::BinOStream without throwing.
+    /// \param instream         Standard \c istream containing Base32 encoded data.
+    /// \param outstream        \c brace::BinOStream to receive the decoded bytes.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes written.
+    CodecDecodeResult try_decode(std::istream &instream, brace::BinOStream &outstream, bool handle_newline = false) const
+    {
+        return decode_stream(instream, outstream, handle_newline);
+    }
+
+    /// \brief  Decode Base32 encoded data from a standard stream into a vector
+    ///         without throwing.
+    /// \param instream         Standard \c istream containing Base32 encoded data.
+    /// \param out              Vector to which the decoded bytes are appended.
+    /// \param handle_newline   If \c true, newline characters are effectively
+    ///                         ignored in the input data. If \c false,
+    ///                         newline characters are considered to be invalid.
+    /// \return A brace::CodecDecodeResult giving the kind and location of any
+    ///         error, and the number of bytes appended.
+    CodecDecodeResult try_decode(std::istream &instream, std::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_stream(instream, out, handle_newline);
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Decode Base32 encoded data from a standard stream into a
+    ///         std::pmr::vector without throwing.
+    /// \see    try_decode(std::istream &, std::vector<uint8_t> &, bool) const
+    CodecDecodeResult try_decode(std::istream &instream, std::pmr::vector<uint8_t> &out, bool handle_newline = false) const
+    {
+        return decode_stream(instream, out, handle_newline);
+    }
+#endif
 };
 
 /// \brief  The Base32 class provides functions for encoding and decoding data
@@ -0,0 +1,766 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file benchmark.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_BENCHMARK_INC
+#define BRACE_LIB_BENCHMARK_INC
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "brace/cpu_features.h"
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define BRACE_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#elif defined(BRACE_CPU_X86)
+#include <x86intrin.h>
+#endif
+
+namespace brace {
+
+/// \brief  Keep the compiler from discarding a value a benchmark computes.
+/// \param value    The value. The compiler must assume it is read.
+template <typename T>
+inline void do_not_optimize(const T &value) noexcept
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void *volatile sink;
+
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+/// \brief  Keep the compiler from moving or discarding memory writes
+///         across this point.
+inline void clobber_memory() noexcept
+{
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+/// \brief  Hardware events that can be counted while a benchmark runs.
+enum class PerfEvent : unsigned
+{
+    Cycles,         ///< Core clock cycles
+    Instructions,   ///< Instructions retired
+    BranchMisses,   ///< Mispredicted branches
+    L1DMisses,      ///< Level 1 data cache read misses
+    LLCMisses,      ///< Last level cache misses
+};
+
+/// \brief  Number of PerfEvent values.
+constexpr size_t    perf_event_count{5};
+
+/// \brief  Counts of hardware events over some interval.
+/// \details    An event the processor or operating system could not count
+///             has no value.
+struct PerfCounts
+{
+    std::array<std::optional<double>, perf_event_count> counts;
+
+    /// \brief  Retrieve the count of one event.
+    std::optional<double> operator[](PerfEvent event) const noexcept
+    {
+        return counts[static_cast<size_t>(event)];
+    }
+
+    /// \brief  Retrieve the count of one event.
+    std::optional<double> &operator[](PerfEvent event) noexcept
+    {
+        return counts[static_cast<size_t>(event)];
+    }
+};
+
+/// \brief  Hardware event counters for the calling thread.
+/// \details    On Linux the counters are opened with perf_event_open(2)
+///             and count in user mode only. Each event is opened on its
+///             own, so the events a processor lacks, or that the system's
+///             \c perf_event_paranoid setting forbids, are simply
+///             unavailable. When the kernel multiplexes the counters, the
+///             counts are scaled by the fraction of the interval each
+///             was running. On other systems no event is available.
+class PerfCounters
+{
+public:
+    /// \brief  Open the counters, disabled.
+    PerfCounters() noexcept
+    {
+#if defined(BRACE_PERF_EVENTS)
+        constexpr uint64_t  l1d_read_miss{PERF_COUNT_HW_CACHE_L1D
+                                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+
+        open(PerfEvent::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(PerfEvent::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(PerfEvent::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        open(PerfEvent::L1DMisses, PERF_TYPE_HW_CACHE, l1d_read_miss);
+        open(PerfEvent::LLCMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    ~PerfCounters()
+    {
+#if defined(BRACE_PERF_EVENTS)
+        for (int fd : _fds)
+            if (fd >= 0)
+                ::close(fd);
+#endif
+    }
+
+    /// \brief  Determine whether an event can be counted.
+    bool available(PerfEvent event) const noexcept
+    {
+        return _fds[static_cast<size_t>(event)] >= 0;
+    }
+
+    /// \brief  Determine whether any event can be counted.
+    bool any_available() const noexcept
+    {
+        return std::any_of(_fds.begin(), _fds.end(), [](int fd) { return fd >= 0; });
+    }
+
+    /// \brief  Reset the counters to zero and start counting.
+    void start() noexcept
+    {
+#if defined(BRACE_PERF_EVENTS)
+        for (int fd : _fds)
+            if (fd >= 0)
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        for (int fd : _fds)
+            if (fd >= 0)
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    /// \brief  Stop counting.
+    /// \return The counts since start().
+    PerfCounts stop() noexcept
+    {
+        PerfCounts  rv;
+
+#if defined(BRACE_PERF_EVENTS)
+        for (int fd : _fds)
+            if (fd >= 0)
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        for (size_t i = 0; i < perf_event_count; ++i)
+        {
+            // value, time enabled, time running
+            uint64_t    values[3]{};
+
+            if (_fds[i] < 0 || ::read(_fds[i], values, sizeof values) != static_cast<ssize_t>(sizeof values))
+                continue;
+            if (values[2] == 0)
+                continue;   // never scheduled on the processor
+
+            double  count{static_cast<double>(values[0])};
+
+            if (values[2] < values[1])
+                count *= static_cast<double>(values[1]) / static_cast<double>(values[2]);
+            rv.counts[i] = count;
+        }
+#endif
+
+        return rv;
+    }
+
+    /// \brief  Retrieve the name by which an event is reported.
+    static constexpr std::string_view name(PerfEvent event) noexcept
+    {
+        switch (event)
+        {
+            case PerfEvent::Cycles:         return "cycles";
+            case PerfEvent::Instructions:   return "instructions";
+            case PerfEvent::BranchMisses:   return "branch_misses";
+            case PerfEvent::L1DMisses:      return "l1d_misses";
+            case PerfEvent::LLCMisses:      return "llc_misses";
+        }
+
+        return "";
+    }
+
+private:
+#if defined(BRACE_PERF_EVENTS)
+    void open(PerfEvent event, uint32_t type, uint64_t config) noexcept
+    {
+        perf_event_attr attr{};
+
+        attr.size = sizeof attr;
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        _fds[static_cast<size_t>(event)] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    std::array<int, perf_event_count>   _fds{-1, -1, -1, -1, -1};
+};
+
+/// \brief  Read the processor's time stamp counter.
+/// \return The counter, or zero where there is none.
+/// \details    The time stamp counter ticks at a constant rate, which is
+///             not the core clock rate when the core is throttled or
+///             boosted. It is used for cycle counts only when the
+///             PerfEvent::Cycles counter is unavailable.
+inline uint64_t read_tsc() noexcept
+{
+#if defined(BRACE_CPU_X86)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// \brief  A benchmark registered with a BenchmarkRegistry.
+struct Benchmark
+{
+    /// \brief  Name by which the benchmark is reported and selected.
+    std::string                     name;
+    /// \brief  Number of bytes one operation processes, or zero if the
+    ///         operation is not measured in bytes.
+    size_t                          bytes_per_op;
+    /// \brief  Function that runs the operation the given number of times.
+    std::function<void(uint64_t)>   run;
+};
+
+/// \brief  A collection of benchmarks.
+/// \details    Each program that measures the library keeps its benchmarks
+///             in the registry returned by instance(). A source file adds
+///             its benchmarks by calling add() from the initializer of a
+///             namespace-scope variable, so a benchmark program is built
+///             simply by linking together the files for the subsystems it
+///             is to measure.
+class BenchmarkRegistry
+{
+public:
+    /// \brief  Retrieve the process-wide registry.
+    static BenchmarkRegistry &instance()
+    {
+        static BenchmarkRegistry    registry;
+
+        return registry;
+    }
+
+    /// \brief  Add a benchmark.
+    /// \param name         Name of the benchmark. By convention the
+    ///                     subsystem comes first, separated by a slash, as
+    ///                     in <tt>"sha2/SHA256/16K"</tt>.
+    /// \param bytes_per_op Number of bytes each operation processes, or
+    ///                     zero.
+    /// \param fn           The operation. If it can be called with a
+    ///                     \c uint64_t, it is called once with the number of
+    ///                     operations to run, and must loop itself; this
+    ///                     allows setup to be kept out of the measurement.
+    ///                     Otherwise it is called with no arguments once per
+    ///                     operation, and anything it returns is passed to
+    ///                     do_not_optimize().
+    template <typename F>
+    void add(std::string name, size_t bytes_per_op, F fn)
+    {
+        if constexpr (std::is_invocable_v<F &, uint64_t>)
+        {
+            _benchmarks.push_back(Benchmark{std::move(name), bytes_per_op, std::move(fn)});
+        }
+        else
+        {
+            _benchmarks.push_back(Benchmark{std::move(name), bytes_per_op, [fn = std::move(fn)](uint64_t n) mutable
+                {
+                    for (uint64_t i = 0; i < n; ++i)
+                    {
+                        if constexpr (std::is_void_v<std::invoke_result_t<F &>>)
+                        {
+                            fn();
+                            clobber_memory();
+                        }
+                        else
+                        {
+                            do_not_optimize(fn());
+                        }
+                    }
+                }});
+        }
+    }
+
+    /// \brief  Retrieve the benchmarks, in the order they were added.
+    const std::vector<Benchmark> &benchmarks() const noexcept
+    {
+        return _benchmarks;
+    }
+
+private:
+    std::vector<Benchmark>  _benchmarks;
+};
+
+/// \brief  Settings for running benchmarks.
+struct BenchmarkOptions
+{
+    /// \brief  Run only benchmarks whose names contain this.
+    std::string filter;
+    /// \brief  Least time, in seconds, to spend measuring each benchmark.
+    double      min_time{0.5};
+    /// \brief  Number of timed runs of each benchmark. Each run performs
+    ///         the same number of operations, chosen so that the runs
+    ///         together take at least \c min_time.
+    size_t      repetitions{5};
+    /// \brief  Whether to read hardware event counters.
+    bool        counters{true};
+};
+
+/// \brief  The measurements of one benchmark.
+/// \details    Times and counts are those of the fastest run, so that the
+///             counts and the time they are compared against describe the
+///             same run; \c median_ns_per_op shows how much the runs varied.
+struct BenchmarkResult
+{
+    std::string                 name;
+    size_t                      bytes_per_op{0};
+    uint64_t                    iterations{0};      ///< Operations per run
+    size_t                      repetitions{0};
+    double                      ns_per_op{0};
+    double                      median_ns_per_op{0};
+    PerfCounts                  per_op;             ///< Event counts per operation
+    bool                        tsc_cycles{false};  ///< Cycles are time stamp counter ticks
+
+    /// \brief  Compute the throughput, if the benchmark processes bytes.
+    std::optional<double> bytes_per_second() const noexcept
+    {
+        if (bytes_per_op == 0 || ns_per_op <= 0)
+            return std::nullopt;
+        return static_cast<double>(bytes_per_op) * 1e9 / ns_per_op;
+    }
+
+    /// \brief  Compute the cycles per byte, if both are known.
+    std::optional<double> cycles_per_byte() const noexcept
+    {
+        if (bytes_per_op == 0 || !per_op[PerfEvent::Cycles])
+            return std::nullopt;
+        return *per_op[PerfEvent::Cycles] / static_cast<double>(bytes_per_op);
+    }
+
+    /// \brief  Compute the instructions per cycle, if both are counted.
+    std::optional<double> instructions_per_cycle() const noexcept
+    {
+        const auto  cycles{per_op[PerfEvent::Cycles]};
+        const auto  instructions{per_op[PerfEvent::Instructions]};
+
+        if (tsc_cycles || !cycles || !instructions || *cycles <= 0)
+            return std::nullopt;
+        return *instructions / *cycles;
+    }
+};
+
+/// \brief  Measure one benchmark.
+/// \param benchmark    The benchmark.
+/// \param options      The settings. The \c filter member is ignored.
+/// \param counters     The counters to read, or \c nullptr for none.
+/// \return The measurements.
+/// \details    The number of operations per run starts at one and grows
+///             until a run takes its share of \c min_time; these
+///             calibrating runs also warm the caches and branch
+///             predictors. Then \c repetitions runs are timed.
+inline BenchmarkResult run_benchmark(const Benchmark &benchmark, const BenchmarkOptions &options,
+                                     PerfCounters *counters = nullptr)
+{
+    using clock = std::chrono::steady_clock;
+
+    const size_t    repetitions{std::max<size_t>(options.repetitions, 1)};
+    const double    run_seconds{std::max(options.min_time, 0.0) / static_cast<double>(repetitions)};
+    uint64_t        n{1};
+
+    for (;;)
+    {
+        const auto  start{clock::now()};
+
+        benchmark.run(n);
+
+        const double    seconds{std::chrono::duration<double>(clock::now() - start).count()};
+
+        if (seconds >= run_seconds || n >= (uint64_t{1} << 40))
+            break;
+
+        // Aim a little past the target, and grow by at most ten times in
+        // case the timer was too coarse to measure the run.
+        const double    scale{seconds > 0 ? run_seconds * 1.2 / seconds : 10.0};
+
+        n = static_cast<uint64_t>(static_cast<double>(n) * std::clamp(scale, 1.5, 10.0));
+    }
+
+    const bool          use_counters{counters && counters->any_available()};
+    const bool          tsc_cycles{!(use_counters && counters->available(PerfEvent::Cycles)) && read_tsc() != 0};
+    std::vector<double> times;
+    BenchmarkResult     rv;
+
+    rv.name = benchmark.name;
+    rv.bytes_per_op = benchmark.bytes_per_op;
+    rv.iterations = n;
+    rv.repetitions = repetitions;
+    rv.tsc_cycles = tsc_cycles;
+
+    for (size_t r = 0; r < repetitions; ++r)
+    {
+        if (use_counters)
+            counters->start();
+
+        const uint64_t  tsc_start{tsc_cycles ? read_tsc() : 0};
+        const auto      start{clock::now()};
+
+        benchmark.run(n);
+
+        const auto      finish{clock::now()};
+        const uint64_t  tsc_finish{tsc_cycles ? read_tsc() : 0};
+        PerfCounts      counts;
+
+        if (use_counters)
+            counts = counters->stop();
+        if (tsc_cycles)
+            counts[PerfEvent::Cycles] = static_cast<double>(tsc_finish - tsc_start);
+
+        const double    ns{std::chrono::duration<double, std::nano>(finish - start).count() / static_cast<double>(n)};
+
+        times.push_back(ns);
+        if (r == 0 || ns < rv.ns_per_op)
+        {
+            rv.ns_per_op = ns;
+            for (auto &count : counts.counts)
+                if (count)
+                    *count /= static_cast<double>(n);
+            rv.per_op = counts;
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    rv.median_ns_per_op = times.size() % 2 ? times[times.size() / 2]
+                                           : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+
+    return rv;
+}
+
+/// \brief  Measure the benchmarks in a registry.
+/// \param registry The benchmarks.
+/// \param options  The settings.
+/// \param progress If not \c nullptr, the name of each benchmark is
+///                 written here as it starts.
+/// \return The measurements of the benchmarks selected by the filter, in
+///         the order they were added.
+inline std::vector<BenchmarkResult> run_benchmarks(const BenchmarkRegistry &registry, const BenchmarkOptions &options,
+                                                   std::ostream *progress = nullptr)
+{
+    std::optional<PerfCounters>     counters;
+    std::vector<BenchmarkResult>    rv;
+
+    if (options.counters)
+        counters.emplace();
+
+    for (const auto &benchmark : registry.benchmarks())
+    {
+        if (benchmark.name.find(options.filter) == std::string::npos)
+            continue;
+        if (progress)
+            *progress << benchmark.name << std::endl;
+        rv.push_back(run_benchmark(benchmark, options, counters ? &*counters : nullptr));
+    }
+
+    return rv;
+}
+
+/// \cond
+namespace detail {
+
+inline void write_json_string(std::ostream &out, std::string_view str)
+{
+    out << '"';
+    for (char c : str)
+    {
+        switch (c)
+        {
+            case '"':   out << "\\\""; break;
+            case '\\':  out << "\\\\"; break;
+            case '\n':  out << "\\n"; break;
+            case '\r':  out << "\\r"; break;
+            case '\t':  out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char    buf[8];
+
+                    std::snprintf(buf, sizeof buf, "\\u%04x", static_cast<unsigned>(c));
+                    out << buf;
+                }
+                else
+                {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+inline void write_json_number(std::ostream &out, std::optional<double> value)
+{
+    if (value)
+    {
+        char    buf[32];
+
+        std::snprintf(buf, sizeof buf, "%.6g", *value);
+        out << buf;
+    }
+    else
+    {
+        out << "null";
+    }
+}
+
+inline std::string format_number(std::optional<double> value, const char *format)
+{
+    if (!value)
+        return "-";
+
+    char    buf[32];
+
+    std::snprintf(buf, sizeof buf, format, *value);
+    return buf;
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Write measurements as JSON.
+/// \param out      The stream to write to.
+/// \param results  The measurements.
+/// \details    The document has a \c context object describing the
+///             machine and build, and a \c benchmarks array with one object
+///             per result. Values that could not be measured are \c null.
+///             Documents from two builds or two machines can be compared
+///             benchmark by benchmark by name.
+inline void write_json(std::ostream &out, const std::vector<BenchmarkResult> &results)
+{
+    const CpuFeatures   features{cpu_features()};
+    std::string         feature_names;
+
+    for (uint32_t bit = 1; bit != 0; bit <<= 1)
+    {
+        const auto  feature{static_cast<CpuFeature>(bit)};
+
+        if (features.has(feature) && !CpuFeatures::name(feature).empty())
+        {
+            if (!feature_names.empty())
+                feature_names += ' ';
+            feature_names += CpuFeatures::name(feature);
+        }
+    }
+
+    out << "{\n  \"context\": {\n    \"compiler\": ";
+#if defined(__VERSION__)
+    detail::write_json_string(out, __VERSION__);
+#elif defined(_MSC_FULL_VER)
+    detail::write_json_string(out, "MSVC " + std::to_string(_MSC_FULL_VER));
+#else
+    detail::write_json_string(out, "unknown");
+#endif
+    out << ",\n    \"cpu_features\": ";
+    detail::write_json_string(out, feature_names);
+    out << ",\n    \"perf_counters\": " << (PerfCounters{}.any_available() ? "true" : "false");
+    out << "\n  },\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &result{results[i]};
+
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        detail::write_json_string(out, result.name);
+        out << ", \"bytes_per_op\": " << result.bytes_per_op
+            << ", \"iterations\": " << result.iterations
+            << ", \"repetitions\": " << result.repetitions
+            << ", \"ns_per_op\": ";
+        detail::write_json_number(out, result.ns_per_op);
+        out << ", \"median_ns_per_op\": ";
+        detail::write_json_number(out, result.median_ns_per_op);
+        out << ", \"bytes_per_second\": ";
+        detail::write_json_number(out, result.bytes_per_second());
+        out << ", \"cycles_per_byte\": ";
+        detail::write_json_number(out, result.cycles_per_byte());
+        out << ", \"ipc\": ";
+        detail::write_json_number(out, result.instructions_per_cycle());
+        out << ", \"cycle_source\": " << (result.tsc_cycles ? "\"tsc\"" : result.per_op[PerfEvent::Cycles] ? "\"perf\"" : "null");
+        for (size_t e = 0; e < perf_event_count; ++e)
+        {
+            const auto  event{static_cast<PerfEvent>(e)};
+
+            out << ", \"" << PerfCounters::name(event) << "_per_op\": ";
+            detail::write_json_number(out, result.per_op[event]);
+        }
+        out << '}';
+    }
+
+    out << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+/// \brief  Write measurements as a table.
+/// \param out      The stream to write to.
+/// \param results  The measurements.
+/// \details    Columns that cannot be computed show a dash.
+inline void write_table(std::ostream &out, const std::vector<BenchmarkResult> &results)
+{
+    size_t  width{9};
+
+    for (const auto &result : results)
+        width = std::max(width, result.name.size());
+
+    char    buf[256];
+
+    std::snprintf(buf, sizeof buf, "%-*s %12s %10s %9s %7s %9s %9s %9s %9s\n", static_cast<int>(width),
+                  "benchmark", "ns/op", "MB/s", "cyc/byte", "IPC", "instr/op", "br-miss", "L1D-miss", "LLC-miss");
+    out << buf;
+
+    for (const auto &result : results)
+    {
+        std::optional<double>   mb_per_second{result.bytes_per_second()};
+
+        if (mb_per_second)
+            *mb_per_second /= 1e6;
+
+        std::snprintf(buf, sizeof buf, "%-*s %12.2f %10s %9s %7s %9s %9s %9s %9s\n", static_cast<int>(width),
+                      result.name.c_str(), result.ns_per_op,
+                      detail::format_number(mb_per_second, "%.1f").c_str(),
+                      detail::format_number(result.cycles_per_byte(), "%.3f").c_str(),
+                      detail::format_number(result.instructions_per_cycle(), "%.2f").c_str(),
+                      detail::format_number(result.per_op[PerfEvent::Instructions], "%.1f").c_str(),
+                      detail::format_number(result.per_op[PerfEvent::BranchMisses], "%.3f").c_str(),
+                      detail::format_number(result.per_op[PerfEvent::L1DMisses], "%.3f").c_str(),
+                      detail::format_number(result.per_op[PerfEvent::LLCMisses], "%.3f").c_str());
+        out << buf;
+    }
+}
+
+/// \brief  Run the benchmarks in the process-wide registry as a program.
+/// \param argc The argument count passed to \c main.
+/// \param argv The arguments passed to \c main.
+/// \return The exit status for \c main.
+/// \details    Recognized arguments:
+///             - <tt>--filter=TEXT</tt> runs only benchmarks whose names
+///               contain TEXT.
+///             - <tt>--min-time=SECONDS</tt> sets BenchmarkOptions::min_time.
+///             - <tt>--repetitions=N</tt> sets BenchmarkOptions::repetitions.
+///             - <tt>--no-counters</tt> does not read hardware counters.
+///             - <tt>--json=FILE</tt> also writes the results as JSON to
+///               FILE, or to the standard output if FILE is \c -.
+///             - <tt>--list</tt> lists the benchmarks without running them.
+inline int benchmark_main(int argc, char *argv[])
+{
+    BenchmarkOptions    options;
+    std::string         json_file;
+    bool                list{false};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view  arg{argv[i]};
+        const auto              value{[&arg](std::string_view prefix) {
+                                        return std::string{arg.substr(prefix.size())};
+                                    }};
+
+        if (arg.rfind("--filter=", 0) == 0)
+            options.filter = value("--filter=");
+        else if (arg.rfind("--min-time=", 0) == 0)
+            options.min_time = std::strtod(value("--min-time=").c_str(), nullptr);
+        else if (arg.rfind("--repetitions=", 0) == 0)
+            options.repetitions = std::strtoul(value("--repetitions=").c_str(), nullptr, 10);
+        else if (arg == "--no-counters")
+            options.counters = false;
+        else if (arg.rfind("--json=", 0) == 0)
+            json_file = value("--json=");
+        else if (arg == "--list")
+            list = true;
+        else
+        {
+            std::cerr << "unrecognized argument: " << arg << "\n"
+                      << "usage: " << argv[0]
+                      << " [--filter=TEXT] [--min-time=SECONDS] [--repetitions=N] [--no-counters] [--json=FILE] [--list]\n";
+            return 2;
+        }
+    }
+
+    const auto &registry{BenchmarkRegistry::instance()};
+
+    if (list)
+    {
+        for (const auto &benchmark : registry.benchmarks())
+            if (benchmark.name.find(options.filter) != std::string::npos)
+                std::cout << benchmark.name << '\n';
+        return 0;
+    }
+
+    // Progress goes to the standard error when JSON goes to the standard
+    // output, so the output can be redirected to a file.
+    const bool  json_to_stdout{json_file == "-"};
+    const auto  results{run_benchmarks(registry, options, json_to_stdout ? &std::cerr : nullptr)};
+
+    if (json_to_stdout)
+    {
+        write_json(std::cout, results);
+        return 0;
+    }
+
+    write_table(std::cout, results);
+    if (!json_file.empty())
+    {
+        std::ofstream   out{json_file};
+
+        write_json(out, results);
+        if (!out)
+        {
+            std::cerr << "could not write " << json_file << '\n';
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+#endif  // BRACE_LIB_BENCHMARK_INC
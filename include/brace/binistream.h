@@ -279,6 +279,33 @@ public:
         return *this;
     }
 
+    /// \brief  Extract an array of values from an input byte stream.
+    /// \tparam T       Type of the values to extract.
+    /// \param values   Pointer to an array to receive the values.
+    /// \param count    Number of values to extract.
+    /// \return *this
+    /// \details    Each value is read as by operator>>(). When the stream's
+    ///             byte order is the native order the whole array is read
+    ///             with a single call to read().
+    template<typename T, typename std::enable_if<std::is_arithmetic_v<T>>::type* = nullptr>
+    BinIStream &read_values(T *values, size_t count)
+    {
+        if (*this)
+        {
+            if (endian() == Endian::Native)
+            {
+                read(reinterpret_cast<byte_type *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+            }
+            else
+            {
+                for (size_t i = 0; i < count && *this; ++i)
+                    *this >> values[i];
+            }
+        }
+
+        return *this;
+    }
+
 #if 0
     /// \brief  Extract a single byte from an input byte stream.
     /// \param b    Byte value to be read.
@@ -116,7 +116,7 @@ public:
     {
         auto    rv{rdimpl()->put(b)};
 
-        if (traits_type::eq_int_type(traits_type::to_int_type(b), traits_type::eof()))
+        if (traits_type::eq_int_type(rv, traits_type::eof()))
             set_any_error_bits();
 
         return rv;
@@ -156,6 +156,33 @@ public:
         return *this;
     }
 
+    /// \brief  Insert an array of values into a BinOStream.
+    /// \tparam T       Type of the values to insert.
+    /// \param values   Pointer to the values to insert.
+    /// \param count    Number of values pointed to by \p values.
+    /// \return *this
+    /// \details    Each value is written as by operator<<(). When the stream's
+    ///             byte order is the native order the whole array is written
+    ///             with a single call to write().
+    template<typename T, typename std::enable_if<std::is_arithmetic_v<T>>::type* = nullptr>
+    BinOStream &write_values(const T *values, size_t count)
+    {
+        if (*this)
+        {
+            if (endian() == Endian::Native)
+            {
+                write(reinterpret_cast<const byte_type *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+            }
+            else
+            {
+                for (size_t i = 0; i < count && *this; ++i)
+                    *this << values[i];
+            }
+        }
+
+        return *this;
+    }
+
 private:
     void set_any_error_bits()
     {
@@ -17,6 +17,17 @@
 /// \author Jeff Bienstadt
 
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "brace/cpu_target.h"
+
+#if defined(__AVX2__) || defined(__BMI2__) || defined(BRACE_RUNTIME_DISPATCH)
+#include <immintrin.h>
+#endif
+
 /// \brief  The namespace enclosing the brace library.
 ///
 /// The entire brace library is contained within this namespace.
@@ -100,6 +111,445 @@ inline T rotate_right(T word, int bits) noexcept
     return (word >> bits) | (word << (w - bits));
 }
 
+/// \cond
+namespace detail {
+
+// The types accepted by popcount(), countr_zero() and countl_zero(): the
+// unsigned integer types, as for std::popcount.
+template <typename T>
+constexpr bool is_bit_word_v = std::is_integral_v<T> && std::is_unsigned_v<T>
+                               && !std::is_same_v<T, bool> && !std::is_same_v<T, char>
+                               && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t>
+                               && !std::is_same_v<T, char32_t>;
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Count the bits that are set in a word.
+///
+/// \tparam T   An unsigned integer type of at most 64 bits
+/// \param word Value whose bits are to be counted
+///
+/// \return The number of one bits in \p word.
+template<typename T, typename std::enable_if<detail::is_bit_word_v<T>>::type* = nullptr>
+constexpr int popcount(T word) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "popcount supports words of up to 64 bits");
+
+    if constexpr (sizeof(T) <= sizeof(uint32_t))
+    {
+        uint32_t    w{word};
+
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcount(w);
+#else
+        w = w - ((w >> 1) & 0x55555555);
+        w = (w & 0x33333333) + ((w >> 2) & 0x33333333);
+        return static_cast<int>((((w + (w >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+#endif
+    }
+    else
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        return popcount(static_cast<uint32_t>(word)) + popcount(static_cast<uint32_t>(word >> 32));
+#endif
+    }
+}
+
+/// \brief  Count the consecutive zero bits at the least significant end
+///         of a word.
+///
+/// \tparam T   An unsigned integer type of at most 64 bits
+/// \param word Value to examine
+///
+/// \return The number of trailing zero bits, which is the width of \p T if
+///         \p word is zero.
+template<typename T, typename std::enable_if<detail::is_bit_word_v<T>>::type* = nullptr>
+constexpr int countr_zero(T word) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "countr_zero supports words of up to 64 bits");
+
+    if (word == 0)
+        return std::numeric_limits<T>::digits;
+
+    if constexpr (sizeof(T) <= sizeof(uint32_t))
+    {
+        const uint32_t  w{word};
+
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(w);
+#else
+        return popcount((w & (0 - w)) - 1);
+#endif
+    }
+    else
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        return popcount(static_cast<T>((word & (0 - word)) - 1));
+#endif
+    }
+}
+
+/// \brief  Count the consecutive zero bits at the most significant end
+///         of a word.
+///
+/// \tparam T   An unsigned integer type of at most 64 bits
+/// \param word Value to examine
+///
+/// \return The number of leading zero bits, which is the width of \p T if
+///         \p word is zero.
+template<typename T, typename std::enable_if<detail::is_bit_word_v<T>>::type* = nullptr>
+constexpr int countl_zero(T word) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "countl_zero supports words of up to 64 bits");
+
+    if (word == 0)
+        return std::numeric_limits<T>::digits;
+
+    if constexpr (sizeof(T) <= sizeof(uint32_t))
+    {
+        // Narrower words are counted as 32 bits, less the extra high zeros.
+        constexpr int   extra{32 - std::numeric_limits<T>::digits};
+        uint32_t        w{word};
+
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clz(w) - extra;
+#else
+        // Smear the highest one bit into every lower position.
+        w |= w >> 1;
+        w |= w >> 2;
+        w |= w >> 4;
+        w |= w >> 8;
+        w |= w >> 16;
+        return 32 - popcount(w) - extra;
+#endif
+    }
+    else
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(word);
+#else
+        const auto  high{static_cast<uint32_t>(word >> 32)};
+
+        return high ? countl_zero(high) : 32 + countl_zero(static_cast<uint32_t>(word));
+#endif
+    }
+}
+
+/// \brief  Reverse the order of the bits in a word.
+///
+/// \tparam T   An unsigned integer type of at most 64 bits
+/// \param word Value whose bits are to be reversed
+///
+/// \return \p word with its lowest bit exchanged with its highest, the
+///         next lowest with the next highest, and so on across the width
+///         of \p T.
+template<typename T, typename std::enable_if<detail::is_bit_word_v<T>>::type* = nullptr>
+constexpr T bit_reverse(T word) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "bit_reverse supports words of up to 64 bits");
+
+    uint64_t    w{word};
+
+#if defined(__clang__)
+    w = __builtin_bitreverse64(w);
+#else
+    // Swap adjacent bits, then pairs, then nibbles, then reverse the bytes.
+    w = ((w >> 1) & 0x5555555555555555) | ((w & 0x5555555555555555) << 1);
+    w = ((w >> 2) & 0x3333333333333333) | ((w & 0x3333333333333333) << 2);
+    w = ((w >> 4) & 0x0F0F0F0F0F0F0F0F) | ((w & 0x0F0F0F0F0F0F0F0F) << 4);
+    w = ((w >> 8) & 0x00FF00FF00FF00FF) | ((w & 0x00FF00FF00FF00FF) << 8);
+    w = ((w >> 16) & 0x0000FFFF0000FFFF) | ((w & 0x0000FFFF0000FFFF) << 16);
+    w = (w >> 32) | (w << 32);
+#endif
+
+    // The bits of a narrower word end up at the top.
+    return static_cast<T>(w >> (64 - std::numeric_limits<T>::digits));
+}
+
+/// \brief  Compute the running sums of the bytes of a word.
+///
+/// \param word Value holding eight bytes to be summed
+///
+/// \return A word whose byte \e i, counting from the least significant,
+///         is the sum of bytes 0 through \e i of \p word, modulo 256.
+/// \details    Applied to the result of byte_popcounts(), this gives the
+///             number of set bits in bytes 0 through \e i with a single
+///             multiplication.
+constexpr uint64_t byte_prefix_sums(uint64_t word) noexcept
+{
+    return word * 0x0101010101010101;
+}
+
+/// \brief  Count the bits that are set in each byte of a word.
+///
+/// \param word Value whose bits are to be counted
+///
+/// \return A word whose every byte holds the number of one bits in the
+///         corresponding byte of \p word.
+constexpr uint64_t byte_popcounts(uint64_t word) noexcept
+{
+    word = word - ((word >> 1) & 0x5555555555555555);
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    return (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+}
+
+/// \brief  Scatter the low bits of a word to the positions of the set bits
+///         of a mask.
+///
+/// \param word Value supplying the bits, taken from the least significant
+/// \param mask Positions to receive the bits
+///
+/// \return A word holding the low <tt>popcount(mask)</tt> bits of \p word,
+///         in order, at the positions of the one bits of \p mask, and zero
+///         elsewhere.
+/// \details    This is the x86 PDEP instruction, which is used when BMI2 is
+///             available.
+inline uint64_t deposit_bits(uint64_t word, uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+    return _pdep_u64(word, mask);
+#else
+    uint64_t    result{0};
+
+    for (uint64_t bit = 1; mask; bit <<= 1)
+    {
+        if (word & bit)
+            result |= mask & (0 - mask);
+        mask &= mask - 1;
+    }
+    return result;
+#endif
+}
+
+/// \brief  Gather the bits of a word at the positions of the set bits of a
+///         mask into the low bits of the result.
+///
+/// \param word Value supplying the bits
+/// \param mask Positions of the bits to gather
+///
+/// \return A word holding, in order from the least significant, the bits
+///         of \p word at the positions of the one bits of \p mask.
+/// \details    This is the x86 PEXT instruction, which is used when BMI2 is
+///             available.
+inline uint64_t extract_bits(uint64_t word, uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+    return _pext_u64(word, mask);
+#else
+    uint64_t    result{0};
+
+    for (uint64_t bit = 1; mask; bit <<= 1)
+    {
+        if (word & mask & (0 - mask))
+            result |= bit;
+        mask &= mask - 1;
+    }
+    return result;
+#endif
+}
+
+/// \brief  Find the position of the n-th set bit in a word.
+///
+/// \param word Value to search
+/// \param n    Zero-based index of the set bit to find; must be less
+///             than <tt>popcount(word)</tt>
+///
+/// \return The bit number of the n-th one bit, counting from the least
+///         significant bit.
+/// \details    With BMI2 this deposits a single bit at the n-th set bit
+///             of \p word; otherwise the lower set bits are cleared one at
+///             a time.
+inline int select_bit(uint64_t word, int n) noexcept
+{
+#if defined(__BMI2__)
+    return countr_zero(deposit_bits(uint64_t{1} << n, word));
+#else
+    while (n--)
+        word &= word - 1;
+
+    return countr_zero(word);
+#endif
+}
+
+/// \cond
+namespace detail {
+
+enum class BitwiseOp { And, Or, Xor, AndNot };
+
+template <BitwiseOp Op>
+constexpr uint64_t combine(uint64_t a, uint64_t b) noexcept
+{
+    if constexpr (Op == BitwiseOp::And)
+        return a & b;
+    else if constexpr (Op == BitwiseOp::Or)
+        return a | b;
+    else if constexpr (Op == BitwiseOp::Xor)
+        return a ^ b;
+    else
+        return a & ~b;
+}
+
+#if defined(__AVX2__)
+template <BitwiseOp Op>
+inline __m256i combine(__m256i a, __m256i b) noexcept
+{
+    if constexpr (Op == BitwiseOp::And)
+        return _mm256_and_si256(a, b);
+    else if constexpr (Op == BitwiseOp::Or)
+        return _mm256_or_si256(a, b);
+    else if constexpr (Op == BitwiseOp::Xor)
+        return _mm256_xor_si256(a, b);
+    else
+        return _mm256_andnot_si256(b, a);
+}
+#endif
+
+template <BitwiseOp Op>
+inline void bitwise(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t count) noexcept
+{
+    size_t  i{0};
+
+#if defined(__AVX2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256i   va{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i))};
+        const __m256i   vb{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i))};
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), combine<Op>(va, vb));
+    }
+#endif
+
+    for (; i < count; ++i)
+        dst[i] = combine<Op>(a[i], b[i]);
+}
+
+inline size_t popcount_words(const uint64_t *words, size_t count) noexcept
+{
+    size_t  total{0};
+
+    for (size_t i = 0; i < count; ++i)
+        total += static_cast<size_t>(popcount(words[i]));
+
+    return total;
+}
+
+// Also compiled for AVX2 when the program is not, so that
+// popcount_dispatched() can choose it at run time.
+#if defined(__AVX2__) || defined(BRACE_RUNTIME_DISPATCH)
+BRACE_TARGET("avx2,popcnt")
+inline size_t popcount_words_avx2(const uint64_t *words, size_t count) noexcept
+{
+    const __m256i   nibble_counts{_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4)};
+    const __m256i   low_nibbles{_mm256_set1_epi8(0x0F)};
+    __m256i         sums{_mm256_setzero_si256()};
+    size_t          i{0};
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i))};
+        const __m256i   lo{_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(v, low_nibbles))};
+        const __m256i   hi{_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles))};
+
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+
+    size_t  total =   static_cast<size_t>(_mm256_extract_epi64(sums, 0)) + static_cast<size_t>(_mm256_extract_epi64(sums, 1))
+                    + static_cast<size_t>(_mm256_extract_epi64(sums, 2)) + static_cast<size_t>(_mm256_extract_epi64(sums, 3));
+
+    for (; i < count; ++i)
+        total += static_cast<size_t>(popcount(words[i]));
+
+    return total;
+}
+#endif
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Count the bits that are set in an array of words.
+///
+/// \param words    Pointer to the words whose bits are to be counted
+/// \param count    Number of words pointed to by \p words
+///
+/// \return The number of one bits in all of the words.
+/// \details    When the program is compiled for AVX2, four words at a time
+///             are counted by looking up the count of each nibble with a
+///             byte shuffle and summing the bytes with SAD. To choose that
+///             kernel at run time instead, use popcount_dispatched() from
+///             \c brace/bits_dispatch.h.
+inline size_t popcount(const uint64_t *words, size_t count) noexcept
+{
+#if defined(__AVX2__)
+    return detail::popcount_words_avx2(words, count);
+#else
+    return detail::popcount_words(words, count);
+#endif
+}
+
+/// \brief  Compute the bitwise AND of two arrays of words.
+///
+/// \param dst      Pointer to the array to receive the result, which may
+///                 be \p a or \p b
+/// \param a        Pointer to the first operand
+/// \param b        Pointer to the second operand
+/// \param count    Number of words in each array
+///
+/// \details    Four words at a time are combined when AVX2 is available.
+inline void bitwise_and(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t count) noexcept
+{
+    detail::bitwise<detail::BitwiseOp::And>(dst, a, b, count);
+}
+
+/// \brief  Compute the bitwise OR of two arrays of words.
+///
+/// \param dst      Pointer to the array to receive the result, which may
+///                 be \p a or \p b
+/// \param a        Pointer to the first operand
+/// \param b        Pointer to the second operand
+/// \param count    Number of words in each array
+///
+/// \details    Four words at a time are combined when AVX2 is available.
+inline void bitwise_or(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t count) noexcept
+{
+    detail::bitwise<detail::BitwiseOp::Or>(dst, a, b, count);
+}
+
+/// \brief  Compute the bitwise exclusive OR of two arrays of words.
+///
+/// \param dst      Pointer to the array to receive the result, which may
+///                 be \p a or \p b
+/// \param a        Pointer to the first operand
+/// \param b        Pointer to the second operand
+/// \param count    Number of words in each array
+///
+/// \details    Four words at a time are combined when AVX2 is available.
+inline void bitwise_xor(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t count) noexcept
+{
+    detail::bitwise<detail::BitwiseOp::Xor>(dst, a, b, count);
+}
+
+/// \brief  Compute the bits of one array of words that are not set in
+///         another.
+///
+/// \param dst      Pointer to the array to receive the result, which may
+///                 be \p a or \p b
+/// \param a        Pointer to the first operand
+/// \param b        Pointer to the second operand, whose bits are removed
+///                 from \p a
+/// \param count    Number of words in each array
+///
+/// \details    Four words at a time are combined when AVX2 is available.
+inline void bitwise_and_not(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t count) noexcept
+{
+    detail::bitwise<detail::BitwiseOp::AndNot>(dst, a, b, count);
+}
+
 } // namespace brace
 
 #endif  // BRACE_LIB_BITS_INC
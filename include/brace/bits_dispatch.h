@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file bits_dispatch.h
+/// \brief  Bulk bit operations whose kernel is chosen for the running
+///         processor.
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_BITS_DISPATCH_INC
+#define BRACE_LIB_BITS_DISPATCH_INC
+
+#include <cstddef>
+#include <cstdint>
+
+#include "brace/bits.h"
+#include "brace/cpu_features.h"
+
+namespace brace {
+
+/// \cond
+namespace detail {
+
+#if defined(BRACE_RUNTIME_DISPATCH)
+// The portable loop, compiled to use the POPCNT instruction.
+BRACE_TARGET("popcnt") BRACE_FLATTEN
+inline size_t popcount_words_popcnt(const uint64_t *words, size_t count) noexcept
+{
+    return popcount_words(words, count);
+}
+
+struct PopcountWords
+{
+    static auto select(const CpuFeatures &features) noexcept -> size_t (*)(const uint64_t *, size_t)
+    {
+        if (features.has(CpuFeature::AVX2) && features.has(CpuFeature::POPCNT))
+            return popcount_words_avx2;
+        if (features.has(CpuFeature::POPCNT))
+            return popcount_words_popcnt;
+        return popcount_words;
+    }
+};
+#endif
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Count the bits that are set in an array of words, using the
+///         fastest kernel the running processor supports.
+///
+/// \param words    Pointer to the words whose bits are to be counted
+/// \param count    Number of words pointed to by \p words
+///
+/// \return The number of one bits in all of the words.
+/// \details    Gives the same result as popcount(const uint64_t *, size_t).
+///             When the program is compiled for AVX2 this is that function;
+///             otherwise the AVX2 or POPCNT kernel is chosen on the first
+///             call if cpu_features() reports it.
+inline size_t popcount_dispatched(const uint64_t *words, size_t count) noexcept
+{
+#if defined(__AVX2__) || !defined(BRACE_RUNTIME_DISPATCH)
+    return popcount(words, count);
+#else
+    return KernelDispatch<detail::PopcountWords, size_t(const uint64_t *, size_t)>::call(words, count);
+#endif
+}
+
+}
+
+#endif  // BRACE_LIB_BITS_DISPATCH_INC
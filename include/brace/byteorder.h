@@ -12,7 +12,7 @@
 ///
 /// \author Jeff Bienstadt
 #ifndef BRACE_LIB_BYTEORDER_INC
-#define BRACE_LIB_BTYEORDER_INC
+#define BRACE_LIB_BYTEORDER_INC
 
 #include <algorithm>
 #include <cstdint>
@@ -315,4 +315,4 @@ inline void convert_from_endian(Endian endian, T &value)
 
 }   // namespace brace
 
-#endif  // BRACE_LIB_BTYEORDER_INC
+#endif  // BRACE_LIB_BYTEORDER_INC
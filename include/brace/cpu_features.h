@@ -0,0 +1,376 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file cpu_features.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_CPU_FEATURES_INC
+#define BRACE_LIB_CPU_FEATURES_INC
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#include "brace/cpu_target.h"
+
+#if defined(BRACE_CPU_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+namespace brace {
+
+/// \brief  Instruction set extensions that kernels may be specialized for.
+enum class CpuFeature : uint32_t
+{
+    SSE2        = 1u << 0,
+    SSSE3       = 1u << 1,
+    SSE41       = 1u << 2,
+    SSE42       = 1u << 3,
+    POPCNT      = 1u << 4,
+    PCLMUL      = 1u << 5,
+    AVX         = 1u << 6,
+    AVX2        = 1u << 7,
+    BMI1        = 1u << 8,
+    BMI2        = 1u << 9,
+    SHA         = 1u << 10,
+    AVX512F     = 1u << 11,
+    AVX512BW    = 1u << 12,
+    AVX512VL    = 1u << 13
+};
+
+/// \brief  A set of CpuFeature values.
+class CpuFeatures
+{
+public:
+    /// \brief  Construct an empty set, describing a processor with none of
+    ///         the features.
+    constexpr CpuFeatures() noexcept = default;
+
+    /// \brief  Construct a set from a bit mask of CpuFeature values.
+    constexpr explicit CpuFeatures(uint32_t bits) noexcept
+      : _bits{bits}
+    {}
+
+    /// \brief  Retrieve the set as a bit mask of CpuFeature values.
+    constexpr uint32_t bits() const noexcept
+    {
+        return _bits;
+    }
+
+    /// \brief  Determine if the set includes a feature.
+    constexpr bool has(CpuFeature feature) const noexcept
+    {
+        return (_bits & static_cast<uint32_t>(feature)) != 0;
+    }
+
+    /// \brief  Add a feature to the set.
+    constexpr CpuFeatures &set(CpuFeature feature) noexcept
+    {
+        _bits |= static_cast<uint32_t>(feature);
+        return *this;
+    }
+
+    /// \brief  Remove a feature from the set.
+    constexpr CpuFeatures &reset(CpuFeature feature) noexcept
+    {
+        _bits &= ~static_cast<uint32_t>(feature);
+        return *this;
+    }
+
+    /// \brief  Retrieve the lower-case name of a feature, such as "avx2".
+    static constexpr std::string_view name(CpuFeature feature) noexcept
+    {
+        for (const auto &entry : _names)
+            if (entry.feature == feature)
+                return entry.name;
+        return {};
+    }
+
+    /// \brief  Determine the features of the processor the program is
+    ///         running on.
+    /// \return The features reported by CPUID that the operating system
+    ///         has also enabled, or an empty set on a processor other than
+    ///         x86.
+    static CpuFeatures detect() noexcept
+    {
+        CpuFeatures rv;
+
+#if defined(BRACE_CPU_X86)
+        uint32_t    r[4];
+        const auto  max_leaf{cpuid(0, 0, r) ? r[0] : 0};
+
+        if (max_leaf < 1)
+            return rv;
+
+        cpuid(1, 0, r);
+
+        const uint32_t  ecx1{r[2]};
+        const uint32_t  edx1{r[3]};
+        uint32_t        ebx7{0};
+
+        if (max_leaf >= 7 && cpuid(7, 0, r))
+            ebx7 = r[1];
+
+        auto    add = [&rv](bool present, CpuFeature feature) { if (present) rv.set(feature); };
+
+        add(edx1 & (1u << 26), CpuFeature::SSE2);
+        add(ecx1 & (1u << 9),  CpuFeature::SSSE3);
+        add(ecx1 & (1u << 19), CpuFeature::SSE41);
+        add(ecx1 & (1u << 20), CpuFeature::SSE42);
+        add(ecx1 & (1u << 23), CpuFeature::POPCNT);
+        add(ecx1 & (1u << 1),  CpuFeature::PCLMUL);
+        add(ebx7 & (1u << 3),  CpuFeature::BMI1);
+        add(ebx7 & (1u << 8),  CpuFeature::BMI2);
+        add(ebx7 & (1u << 29), CpuFeature::SHA);
+
+        // The AVX registers are usable only if the operating system saves
+        // them, which it reports through XGETBV.
+        const uint64_t  xcr0{(ecx1 & (1u << 27)) ? xgetbv() : 0};
+        const bool      avx_state{(xcr0 & 0x06) == 0x06};
+        const bool      avx512_state{(xcr0 & 0xE6) == 0xE6};
+
+        add(avx_state && (ecx1 & (1u << 28)),       CpuFeature::AVX);
+        add(avx_state && (ebx7 & (1u << 5)),        CpuFeature::AVX2);
+        add(avx512_state && (ebx7 & (1u << 16)),    CpuFeature::AVX512F);
+        add(avx512_state && (ebx7 & (1u << 30)),    CpuFeature::AVX512BW);
+        add(avx512_state && (ebx7 & (1u << 31)),    CpuFeature::AVX512VL);
+#endif
+
+        return rv;
+    }
+
+    /// \brief  Restrict a set of features as directed by a specification.
+    /// \param spec A comma-separated list of feature names, as returned by
+    ///             name(). A name prefixed with \c - is removed from the
+    ///             set. If any name lacks the prefix, only the features so
+    ///             named are kept. The name \c none removes every feature.
+    ///             Unknown names are ignored.
+    /// \return The restricted set. Features are never added.
+    /// \details    For example, <tt>-avx512f,-avx512bw</tt> removes the
+    ///             AVX-512 features, and <tt>sse2,ssse3</tt> keeps just
+    ///             those two.
+    constexpr CpuFeatures restrict(std::string_view spec) const noexcept
+    {
+        uint32_t    keep{0};
+        uint32_t    remove{0};
+        bool        any_keep{false};
+
+        while (!spec.empty())
+        {
+            const size_t        comma{spec.find(',')};
+            std::string_view    item{spec.substr(0, comma)};
+
+            spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+
+            while (!item.empty() && item.front() == ' ')
+                item.remove_prefix(1);
+            while (!item.empty() && item.back() == ' ')
+                item.remove_suffix(1);
+
+            const bool  negate{!item.empty() && item.front() == '-'};
+
+            if (negate)
+                item.remove_prefix(1);
+
+            if (equal_names(item, "none"))
+            {
+                any_keep = true;
+                continue;
+            }
+            for (const auto &entry : _names)
+            {
+                if (equal_names(item, entry.name))
+                {
+                    if (negate)
+                    {
+                        remove |= static_cast<uint32_t>(entry.feature);
+                    }
+                    else
+                    {
+                        keep |= static_cast<uint32_t>(entry.feature);
+                        any_keep = true;
+                    }
+                }
+            }
+        }
+
+        return CpuFeatures{(any_keep ? _bits & keep : _bits) & ~remove};
+    }
+
+private:
+    struct NameEntry
+    {
+        CpuFeature          feature;
+        std::string_view    name;
+    };
+
+    static constexpr NameEntry  _names[]{
+        {CpuFeature::SSE2,      "sse2"},
+        {CpuFeature::SSSE3,     "ssse3"},
+        {CpuFeature::SSE41,     "sse4.1"},
+        {CpuFeature::SSE42,     "sse4.2"},
+        {CpuFeature::POPCNT,    "popcnt"},
+        {CpuFeature::PCLMUL,    "pclmul"},
+        {CpuFeature::AVX,       "avx"},
+        {CpuFeature::AVX2,      "avx2"},
+        {CpuFeature::BMI1,      "bmi1"},
+        {CpuFeature::BMI2,      "bmi2"},
+        {CpuFeature::SHA,       "sha"},
+        {CpuFeature::AVX512F,   "avx512f"},
+        {CpuFeature::AVX512BW,  "avx512bw"},
+        {CpuFeature::AVX512VL,  "avx512vl"}
+    };
+
+    // Compare a name without regard to ASCII case.
+    static constexpr bool equal_names(std::string_view a, std::string_view b) noexcept
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const char  ca{a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] | 0x20) : a[i]};
+
+            if (ca != b[i])
+                return false;
+        }
+        return true;
+    }
+
+#if defined(BRACE_CPU_X86)
+    static bool cpuid(uint32_t leaf, uint32_t subleaf, uint32_t (&r)[4]) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+
+        __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i)
+            r[i] = static_cast<uint32_t>(regs[i]);
+        return true;
+#else
+        unsigned    a, b, c, d;
+
+        if (leaf > __get_cpuid_max(leaf & 0x80000000u, nullptr))
+            return false;
+        __cpuid_count(leaf, subleaf, a, b, c, d);
+        r[0] = a;
+        r[1] = b;
+        r[2] = c;
+        r[3] = d;
+        return true;
+#endif
+    }
+
+    static uint64_t xgetbv() noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+#else
+        uint32_t    eax, edx;
+
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t{edx} << 32) | eax;
+#endif
+    }
+#endif
+
+    uint32_t    _bits{0};
+};
+
+/// \brief  Retrieve the features of the processor the program is running on.
+/// \return The set from CpuFeatures::detect(), restricted as directed by
+///         the \c BRACE_CPU_FEATURES environment variable if it is set
+///         (see CpuFeatures::restrict). The features are detected once, on
+///         the first call.
+/// \details    The environment variable lets tests and benchmarks exercise
+///             the kernels for older processors; for example,
+///             <tt>BRACE_CPU_FEATURES=none</tt> selects the portable kernels.
+inline const CpuFeatures &cpu_features() noexcept
+{
+    static const CpuFeatures    features{[]
+        {
+            const CpuFeatures   detected{CpuFeatures::detect()};
+            const char         *spec{std::getenv("BRACE_CPU_FEATURES")};
+
+            return spec ? detected.restrict(spec) : detected;
+        }()};
+
+    return features;
+}
+
+template <typename Selector, typename Signature>
+class KernelDispatch;
+
+/// \brief  Calls one of several implementations of a function, chosen for
+///         the running processor on the first call.
+/// \tparam Selector    A type with a static member function
+///                     <tt>R (*select(const CpuFeatures &))(Args...)</tt>
+///                     returning the kernel to use for a set of features.
+///                     Each Selector has its own dispatch state.
+/// \tparam R           Return type of the kernels.
+/// \tparam Args        Parameter types of the kernels.
+/// \details    The kernel pointer starts out pointing to a resolver, which
+///             asks the Selector for the kernel, stores it in place of
+///             itself, and forwards the call. Every later call is a relaxed
+///             atomic load and an indirect call, with no test of whether the
+///             choice has been made. Concurrent first calls may each resolve,
+///             but they all store the same kernel.
+///
+///             Kernels for instruction sets beyond the compiler's baseline
+///             are marked with BRACE_TARGET. Code compiled for a given
+///             instruction set (with \c __AVX2__ defined, for example) can
+///             call that kernel directly and skip dispatch.
+template <typename Selector, typename R, typename... Args>
+class KernelDispatch<Selector, R(Args...)>
+{
+public:
+    /// \brief  Type of a pointer to a kernel.
+    using function_type = R (*)(Args...);
+
+    /// \brief  Call the selected kernel.
+    static R call(Args... args)
+    {
+        return _kernel.load(std::memory_order_relaxed)(args...);
+    }
+
+    /// \brief  Retrieve the selected kernel, selecting it if needed.
+    static function_type kernel() noexcept
+    {
+        const function_type k{_kernel.load(std::memory_order_relaxed)};
+
+        return k == &resolve ? select() : k;
+    }
+
+private:
+    static function_type select() noexcept
+    {
+        const function_type k{Selector::select(cpu_features())};
+
+        _kernel.store(k, std::memory_order_relaxed);
+        return k;
+    }
+
+    static R resolve(Args... args)
+    {
+        return select()(args...);
+    }
+
+    inline static std::atomic<function_type>    _kernel{&resolve};
+};
+
+}
+
+#endif  // BRACE_LIB_CPU_FEATURES_INC
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file cpu_target.h
+/// \brief  Macros for compiling a function for a particular instruction
+///         set. Detecting the instruction sets of the running processor is
+///         left to cpu_features.h.
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_CPU_TARGET_INC
+#define BRACE_LIB_CPU_TARGET_INC
+
+/// \def    BRACE_CPU_X86
+/// \brief  Defined when compiling for an x86 or x86-64 processor.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BRACE_CPU_X86 1
+#endif
+
+/// \def    BRACE_TARGET(isa)
+/// \brief  Compile a function for an instruction set that the rest of the
+///         program may not be compiled for, such as \c "avx2".
+/// \details    A function so marked may use the intrinsics of that
+///             instruction set, and must only be called when cpu_features()
+///             reports it. The compilers that need no such marking to use
+///             intrinsics expand this to nothing.
+///
+/// \def    BRACE_RUNTIME_DISPATCH
+/// \brief  Defined when functions marked with BRACE_TARGET can be selected
+///         at run time.
+///
+/// \def    BRACE_FLATTEN
+/// \brief  Inline every call made by a function into it.
+///
+/// \def    BRACE_ALWAYS_INLINE
+/// \brief  Inline a function into every caller, even when optimization is
+///         off.
+/// \details    A template shared by kernels for several instruction sets
+///             passes vectors between its caller and the functions marked
+///             with BRACE_TARGET that it calls, whose calling convention
+///             depends on the instruction set. Such a template is marked
+///             BRACE_ALWAYS_INLINE, so that it is only ever compiled as part
+///             of a kernel, and the kernels are marked BRACE_FLATTEN, so that
+///             the whole computation is compiled for the kernel's
+///             instruction set. The template must not take or return vectors
+///             by value.
+#if defined(BRACE_CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BRACE_TARGET(isa) __attribute__((target(isa)))
+#define BRACE_RUNTIME_DISPATCH 1
+#elif defined(BRACE_CPU_X86) && defined(_MSC_VER)
+#define BRACE_TARGET(isa)
+#define BRACE_RUNTIME_DISPATCH 1
+#else
+#define BRACE_TARGET(isa)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BRACE_FLATTEN __attribute__((flatten))
+#define BRACE_ALWAYS_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+#define BRACE_FLATTEN
+#define BRACE_ALWAYS_INLINE __forceinline
+#else
+#define BRACE_FLATTEN
+#define BRACE_ALWAYS_INLINE inline
+#endif
+
+#endif  // BRACE_LIB_CPU_TARGET_INC
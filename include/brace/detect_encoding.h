@@ -0,0 +1,167 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file detect_encoding.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_DETECT_ENCODING_INC
+#define BRACE_LIB_DETECT_ENCODING_INC
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "brace/bits.h"
+#include "brace/encoding_registry.h"
+#include "brace/text_codec.h"
+#include "brace/text_encoding.h"
+#include "brace/utf8_encoding.h"
+
+namespace brace {
+
+/// \brief  The result of detecting the encoding of a buffer.
+struct DetectedEncoding
+{
+    /// \brief  The encoding the buffer appears to use. Never \c nullptr.
+    const TextEncoding *encoding;
+    /// \brief  Length in bytes of the byte order mark at the start of the
+    ///         buffer, or zero if there is none. The text begins at this
+    ///         offset.
+    size_t              bom_length;
+};
+
+/// \cond
+namespace detail {
+
+// Count the NUL bytes at each offset modulo four.
+inline void count_nuls(const unsigned char *bytes, size_t length, size_t (&nuls)[4]) noexcept
+{
+    size_t  pos{0};
+
+#if defined(__AVX2__)
+    for (; pos + 32 <= length; pos += 32)
+    {
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + pos))};
+        const uint32_t  mask{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())))};
+
+        for (int k = 0; k < 4; ++k)
+            nuls[k] += static_cast<size_t>(popcount(mask & (0x11111111U << k)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; pos + 16 <= length; pos += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + pos))};
+        const uint32_t  mask{static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())))};
+
+        for (int k = 0; k < 4; ++k)
+            nuls[k] += static_cast<size_t>(popcount(mask & (0x1111U << k)));
+    }
+#endif
+
+    for (; pos < length; ++pos)
+        nuls[pos % 4] += bytes[pos] == 0;
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Determine the encoding of a buffer of text.
+/// \param bytes        Pointer to the text.
+/// \param length       Number of bytes pointed to by \p bytes.
+/// \param sample_size  Maximum number of bytes to examine when the text
+///                     does not begin with a byte order mark.
+/// \return A DetectedEncoding giving one of the encodings returned by
+///         find_encoding and the length of any byte order mark.
+/// \details    A UTF-8, UTF-16 or UTF-32 byte order mark is definitive.
+///             Otherwise the first \p sample_size bytes are examined:
+///
+///             - NUL bytes in three of every four positions, or in every
+///               other position, indicate UTF-32 or UTF-16, with the
+///               position of the NULs giving the byte order. This reliably
+///               detects text that is mostly Latin script.
+///             - Otherwise text that is valid UTF-8 (including plain ASCII)
+///               is UTF-8, and anything else is ISO-8859-1.
+///
+///             The NULs are counted and the UTF-8 is validated 16 or 32
+///             bytes at a time when SSE2 or AVX2 is available.
+inline DetectedEncoding detect_encoding(const unsigned char *bytes, size_t length,
+                                        size_t sample_size = 4096) noexcept
+{
+    using detail::RegisteredEncoding;
+    using detail::registered_encoding;
+
+    auto    result = [](RegisteredEncoding encoding, size_t bom_length)
+            {
+                return DetectedEncoding{&registered_encoding(encoding), bom_length};
+            };
+
+    // Byte order marks. The UTF-32LE mark begins with the UTF-16LE mark,
+    // so it is checked first.
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+        return result(RegisteredEncoding::UTF8, 3);
+    if (length >= 4 && bytes[0] == 0xFF && bytes[1] == 0xFE && bytes[2] == 0x00 && bytes[3] == 0x00)
+        return result(RegisteredEncoding::UTF32LE, 4);
+    if (length >= 4 && bytes[0] == 0x00 && bytes[1] == 0x00 && bytes[2] == 0xFE && bytes[3] == 0xFF)
+        return result(RegisteredEncoding::UTF32BE, 4);
+    if (length >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
+        return result(RegisteredEncoding::UTF16BE, 2);
+    if (length >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
+        return result(RegisteredEncoding::UTF16LE, 2);
+
+    const size_t    sample{length < sample_size ? length : sample_size};
+
+    if (sample >= 4)
+    {
+        size_t  nuls[4]{};
+
+        detail::count_nuls(bytes, sample, nuls);
+
+        // A position is "mostly NUL" when at least half of its bytes are
+        // zero, and "rarely NUL" when fewer than one in ten are.
+        const size_t    per_position{sample / 4};
+        auto            mostly = [&nuls, per_position](int k) { return 2 * nuls[k] >= per_position; };
+        auto            rarely = [&nuls, per_position](int k) { return 10 * nuls[k] < per_position; };
+
+        if (mostly(2) && mostly(3) && rarely(0))
+            return result(RegisteredEncoding::UTF32LE, 0);
+        if (mostly(0) && mostly(1) && rarely(3))
+            return result(RegisteredEncoding::UTF32BE, 0);
+        if (mostly(1) && mostly(3) && rarely(0) && rarely(2))
+            return result(RegisteredEncoding::UTF16LE, 0);
+        if (mostly(0) && mostly(2) && rarely(1) && rarely(3))
+            return result(RegisteredEncoding::UTF16BE, 0);
+    }
+
+    const size_t    invalid{UTF8Encoding::find_invalid(bytes, sample)};
+
+    if (invalid == sample)
+        return result(RegisteredEncoding::UTF8, 0);
+
+    // The sample may end part way through a UTF-8 sequence, but only a
+    // valid prefix of one.
+    if (sample < length && sample - invalid < 4)
+    {
+        const auto  tail{decode_sequence<UTF8Codec>(bytes + invalid, static_cast<int>(sample - invalid))};
+
+        if (tail.code_point == DecodeResult::incomplete)
+            return result(RegisteredEncoding::UTF8, 0);
+    }
+
+    return result(RegisteredEncoding::Latin1, 0);
+}
+
+}
+
+#endif  // BRACE_LIB_DETECT_ENCODING_INC
@@ -0,0 +1,242 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file encoding_registry.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_ENCODING_REGISTRY_INC
+#define BRACE_LIB_ENCODING_REGISTRY_INC
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "brace/ascii_encoding.h"
+#include "brace/latin1_encoding.h"
+#include "brace/string.h"
+#include "brace/text_encoding.h"
+#include "brace/utf8_encoding.h"
+#include "brace/utf16_encoding.h"
+#include "brace/utf32_encoding.h"
+
+namespace brace {
+
+/// \cond
+namespace detail {
+
+// The encodings known to the registry, in the order of the
+// singletons returned by registered_encoding().
+enum class RegisteredEncoding : unsigned char
+{
+    ASCII,
+    Latin1,
+    UTF8,
+    UTF16BE,
+    UTF16LE,
+    UTF32BE,
+    UTF32LE
+};
+
+struct EncodingAlias
+{
+    std::string_view    name;
+    RegisteredEncoding  encoding;
+};
+
+// Every name the registry recognizes: the IANA preferred MIME name,
+// the IANA aliases, and the names accepted by each class's aka().
+// UTF-16 and UTF-32 without a byte order are big-endian, as RFC 2781
+// specifies for text without a byte order mark.
+inline constexpr EncodingAlias encoding_aliases[] {
+    {"US-ASCII",            RegisteredEncoding::ASCII},
+    {"ASCII",               RegisteredEncoding::ASCII},
+    {"iso-ir-6",            RegisteredEncoding::ASCII},
+    {"ANSI_X3.4-1968",      RegisteredEncoding::ASCII},
+    {"ANSI_X3.4-1986",      RegisteredEncoding::ASCII},
+    {"ISO_646.irv:1991",    RegisteredEncoding::ASCII},
+    {"ISO646-US",           RegisteredEncoding::ASCII},
+    {"us",                  RegisteredEncoding::ASCII},
+    {"IBM367",              RegisteredEncoding::ASCII},
+    {"cp367",               RegisteredEncoding::ASCII},
+    {"csASCII",             RegisteredEncoding::ASCII},
+
+    {"ISO-8859-1",          RegisteredEncoding::Latin1},
+    {"ISO_8859-1:1987",     RegisteredEncoding::Latin1},
+    {"ISO_8859-1",          RegisteredEncoding::Latin1},
+    {"iso-ir-100",          RegisteredEncoding::Latin1},
+    {"Latin1",              RegisteredEncoding::Latin1},
+    {"Latin-1",             RegisteredEncoding::Latin1},
+    {"l1",                  RegisteredEncoding::Latin1},
+    {"IBM819",              RegisteredEncoding::Latin1},
+    {"CP819",               RegisteredEncoding::Latin1},
+    {"csISOLatin1",         RegisteredEncoding::Latin1},
+
+    {"UTF-8",               RegisteredEncoding::UTF8},
+    {"UTF8",                RegisteredEncoding::UTF8},
+    {"csUTF8",              RegisteredEncoding::UTF8},
+
+    {"UTF-16",              RegisteredEncoding::UTF16BE},
+    {"UTF16",               RegisteredEncoding::UTF16BE},
+    {"csUTF16",             RegisteredEncoding::UTF16BE},
+    {"UTF-16BE",            RegisteredEncoding::UTF16BE},
+    {"csUTF16BE",           RegisteredEncoding::UTF16BE},
+    {"UTF-16LE",            RegisteredEncoding::UTF16LE},
+    {"csUTF16LE",           RegisteredEncoding::UTF16LE},
+
+    {"UTF-32",              RegisteredEncoding::UTF32BE},
+    {"UTF32",               RegisteredEncoding::UTF32BE},
+    {"csUTF32",             RegisteredEncoding::UTF32BE},
+    {"UTF-32BE",            RegisteredEncoding::UTF32BE},
+    {"csUTF32BE",           RegisteredEncoding::UTF32BE},
+    {"UTF-32LE",            RegisteredEncoding::UTF32LE},
+    {"csUTF32LE",           RegisteredEncoding::UTF32LE},
+};
+
+constexpr size_t    encoding_alias_count{sizeof(encoding_aliases) / sizeof(encoding_aliases[0])};
+
+// The aliases are placed in a table of alias_table_size slots by a
+// seeded, case-insensitive FNV-1a hash. The seed is found at compile
+// time by trying seeds in turn until no two aliases share a slot, which
+// makes the hash perfect: a lookup hashes the name once and compares it
+// against at most one alias.
+constexpr size_t    alias_table_size{128};
+constexpr size_t    alias_max_length{16};
+
+constexpr uint32_t alias_hash(std::string_view name, uint32_t seed) noexcept
+{
+    uint32_t    h{2166136261U ^ (seed * 0x9E3779B9U)};
+
+    for (char c : name)
+    {
+        unsigned char   b{static_cast<unsigned char>(c)};
+
+        if (b >= 'A' && b <= 'Z')
+            b += 'a' - 'A';
+        h = (h ^ b) * 16777619U;
+    }
+
+    return (h ^ (h >> 16)) & (alias_table_size - 1);
+}
+
+constexpr bool alias_seed_is_perfect(uint32_t seed) noexcept
+{
+    bool    used[alias_table_size]{};
+
+    for (const auto &alias : encoding_aliases)
+    {
+        const auto  slot{alias_hash(alias.name, seed)};
+
+        if (used[slot])
+            return false;
+        used[slot] = true;
+    }
+
+    return true;
+}
+
+constexpr uint32_t find_alias_seed() noexcept
+{
+    uint32_t    seed{0};
+
+    while (!alias_seed_is_perfect(seed))
+        ++seed;
+
+    return seed;
+}
+
+constexpr uint32_t  alias_seed{find_alias_seed()};
+
+struct AliasTable
+{
+    // Index into encoding_aliases, or -1 for an empty slot.
+    signed char slot[alias_table_size];
+};
+
+constexpr AliasTable build_alias_table() noexcept
+{
+    AliasTable  table{};
+
+    for (auto &s : table.slot)
+        s = -1;
+    for (size_t i = 0; i < encoding_alias_count; ++i)
+        table.slot[alias_hash(encoding_aliases[i].name, alias_seed)] = static_cast<signed char>(i);
+
+    return table;
+}
+
+inline constexpr AliasTable alias_table{build_alias_table()};
+
+constexpr bool aliases_fit() noexcept
+{
+    for (const auto &alias : encoding_aliases)
+        if (alias.name.size() > alias_max_length)
+            return false;
+
+    return encoding_alias_count <= alias_table_size / 2;
+}
+
+static_assert(aliases_fit(), "an encoding alias does not fit in the alias table");
+
+inline const TextEncoding &registered_encoding(RegisteredEncoding encoding) noexcept
+{
+    static const ASCIIEncoding      ascii;
+    static const Latin1Encoding     latin1;
+    static const UTF8Encoding       utf8;
+    static const UTF16Encoding      utf16be{Endian::Big};
+    static const UTF16Encoding      utf16le{Endian::Little};
+    static const UTF32Encoding      utf32be{Endian::Big};
+    static const UTF32Encoding      utf32le{Endian::Little};
+
+    static const TextEncoding *const    encodings[] {
+        &ascii, &latin1, &utf8, &utf16be, &utf16le, &utf32be, &utf32le
+    };
+
+    return *encodings[static_cast<size_t>(encoding)];
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Find a text encoding by name.
+/// \param name The name of an encoding, such as the \c charset parameter
+///             of a MIME \c Content-Type. Case is not significant.
+/// \return A pointer to a shared instance of the encoding, or \c nullptr
+///         if the name is not recognized.
+/// \details    Every IANA name and alias for US-ASCII, ISO-8859-1, UTF-8,
+///             UTF-16, UTF-16BE, UTF-16LE, UTF-32, UTF-32BE and UTF-32LE is
+///             recognized, as are the names accepted by each encoding's
+///             \c aka function. "UTF-16" and "UTF-32" are big-endian, as is
+///             assumed for text that has no byte order mark.
+///
+///             The lookup uses a perfect hash table built at compile time,
+///             so it hashes the name once, compares it against at most one
+///             candidate, and never allocates. The returned encodings are
+///             constructed on first use and live until the program exits.
+inline const TextEncoding *find_encoding(std::string_view name) noexcept
+{
+    if (name.empty() || name.size() > detail::alias_max_length)
+        return nullptr;
+
+    const int   index{detail::alias_table.slot[detail::alias_hash(name, detail::alias_seed)]};
+
+    if (index < 0)
+        return nullptr;
+
+    const auto &alias{detail::encoding_aliases[index]};
+
+    if (ci_compare(name, alias.name) != 0)
+        return nullptr;
+
+    return &detail::registered_encoding(alias.encoding);
+}
+
+}
+
+#endif  // BRACE_LIB_ENCODING_REGISTRY_INC
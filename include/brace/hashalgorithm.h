@@ -17,11 +17,15 @@
 /// \author Jeff Bienstadt
 
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <cstdint>
 #include <cstddef>
 #include <iomanip>
 #include <istream>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <sstream>
 #include <string>
 #include <vector>
@@ -203,15 +207,7 @@ public:
     ///         specific hashing algorithm.
     std::vector<uint8_t> compute_hash(std::istream &stream)
     {
-        constexpr size_t    buf_size = 4096;
-
-        uint8_t buffer[buf_size];
-
-        do
-        {
-            stream.read((char *)buffer, buf_size);
-            do_hash(buffer, static_cast<size_t>(stream.gcount()));
-        } while (stream);
+        hash_stream(stream);
 
         return finalize_hash();
     }
@@ -231,20 +227,7 @@ public:
     ///         specific hashing algorithm.
     std::vector<uint8_t> compute_hash(std::istream &stream, size_t length)
     {
-        constexpr size_t    buf_size = 4096;
-
-        uint8_t buffer[buf_size];
-
-        while (length > 0)
-        {
-            if (!stream)
-                break;
-
-            size_t  count = std::min(length, buf_size);
-            stream.read((char *)buffer, count);
-            do_hash(buffer, static_cast<size_t>(stream.gcount()));
-            length -= static_cast<size_t>(stream.gcount());
-        }
+        hash_stream(stream, length);
 
         return finalize_hash();
     }
@@ -259,15 +242,7 @@ public:
     ///         specific hashing algorithm.
     std::vector<uint8_t> compute_hash(brace::BinIStream &stream)
     {
-        constexpr size_t    buf_size = 4096;
-
-        brace::BinIStream::byte_type    buffer[buf_size];
-
-        do
-        {
-            stream.read(buffer, buf_size);
-            do_hash(buffer, static_cast<size_t>(stream.gcount()));
-        } while (stream);
+        hash_stream(stream);
 
         return finalize_hash();
     }
@@ -286,20 +261,7 @@ public:
     ///         specific hashing algorithm.
     std::vector<uint8_t> compute_hash(brace::BinIStream &stream, size_t length)
     {
-        constexpr size_t    buf_size = 4096;
-
-        brace::BinIStream::byte_type    buffer[buf_size];
-
-        while (length > 0)
-        {
-            if (!stream)
-                break;
-
-            size_t  count = std::min(length, buf_size);
-            stream.read(buffer, count);
-            do_hash(buffer, static_cast<size_t>(stream.gcount()));
-            length -= static_cast<size_t>(stream.gcount());
-        }
+        hash_stream(stream, length);
 
         return finalize_hash();
     }
@@ -390,6 +352,266 @@ public:
         return hash_to_string(compute_hash(stream, length));
     }
 
+#if defined(__cpp_lib_memory_resource)
+    /// \brief  Create a string representation of a hash, allocated
+    ///         from a memory resource.
+    ///
+    /// \param hash     Pointer to the bytes of the hash.
+    /// \param length   Number of bytes in the hash.
+    /// \param resource Memory resource from which to allocate the returned
+    ///                 string.
+    /// \return The hash as a sequence of <tt>length * 2</tt> upper-case hex digits.
+    template<typename Resource>
+    static auto hash_to_string(const uint8_t *hash, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        static constexpr char   digits[]{"0123456789ABCDEF"};
+        std::pmr::string        rv(length * 2, '0', resource);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            rv[2 * i] = digits[hash[i] >> 4];
+            rv[2 * i + 1] = digits[hash[i] & 0x0F];
+        }
+
+        return rv;
+    }
+
+    /// \brief  Compute a hash from raw bytes of a specified length, allocated
+    ///         from a memory resource.
+    ///
+    /// \param  buffer  A pointer to the raw data.
+    /// \param  length  Length of the data pointed to by \p buffer.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(const uint8_t *buffer, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        do_hash(buffer, length);
+
+        return finish_hash(resource);
+    }
+
+    /// \brief  Compute a hash from a vector of bytes, allocated from a
+    ///         memory resource.
+    ///
+    /// \param  buffer  A vector of \c uint8_t values.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(const std::vector<uint8_t> &buffer, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        return compute_hash(buffer.data(), buffer.size(), resource);
+    }
+
+    /// \brief  Compute a hash from a std::string, allocated from a
+    ///         memory resource.
+    ///
+    /// \param  s       A \c std::string containing the data to be hashed.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(const std::string &s, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        return compute_hash(reinterpret_cast<const uint8_t *>(s.data()), s.size(), resource);
+    }
+
+    /// \brief  Compute a hash from bytes read from a stream, allocated
+    ///         from a memory resource.
+    ///
+    /// \param  stream  An input stream from which to read bytes, until
+    ///                 end of file is reached.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(std::istream &stream, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        hash_stream(stream);
+
+        return finish_hash(resource);
+    }
+
+    /// \brief  Compute a hash from bytes read from a binary stream, allocated
+    ///         from a memory resource.
+    ///
+    /// \param  stream  A binary input stream from which to read bytes,
+    ///                 until end of file is reached.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(brace::BinIStream &stream, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        hash_stream(stream);
+
+        return finish_hash(resource);
+    }
+
+    /// \brief  Compute a hash from bytes read from a stream, allocated
+    ///         from a memory resource.
+    ///
+    /// \param  stream  An input stream from which to read bytes, until
+    ///                 \p length bytes are read or end of file is reached.
+    /// \param  length  Maximum number of bytes to process.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(std::istream &stream, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        hash_stream(stream, length);
+
+        return finish_hash(resource);
+    }
+
+    /// \brief  Compute a hash from bytes read from a binary stream, allocated
+    ///         from a memory resource.
+    ///
+    /// \param  stream  A binary input stream from which to read bytes,
+    ///                 until \p length bytes are read or end of file is
+    ///                 reached.
+    /// \param  length  Maximum number of bytes to process.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned vector.
+    /// \return A vector of \c uint8_t bytes containing the hash value.
+    template<typename Resource>
+    auto compute_hash(brace::BinIStream &stream, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::vector<uint8_t>>
+    {
+        hash_stream(stream, length);
+
+        return finish_hash(resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         raw bytes of a specified length, allocated from a memory resource.
+    ///
+    /// \param  buffer  A pointer to the raw data.
+    /// \param  length  Length of the data pointed to by \p buffer.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(const uint8_t *buffer, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        do_hash(buffer, length);
+
+        return finish_hash_string(resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         a vector of bytes, allocated from a memory resource.
+    ///
+    /// \param  buffer  A vector of \c uint8_t values.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(const std::vector<uint8_t> &buffer, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        return compute_hash_string(buffer.data(), buffer.size(), resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         a std::string, allocated from a memory resource.
+    ///
+    /// \param  s       A std::string to be used as the input data for the hash.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(const std::string &s, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        return compute_hash_string(reinterpret_cast<const uint8_t *>(s.data()), s.size(), resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         bytes read from a stream, allocated from a memory resource.
+    ///
+    /// \param  stream  An input stream from which to read bytes, until
+    ///                 end of file is reached.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(std::istream &stream, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        hash_stream(stream);
+
+        return finish_hash_string(resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         bytes read from a stream, allocated from a memory resource.
+    ///
+    /// \param  stream  An input stream from which to read bytes, until
+    ///                 \p length bytes are read or end of file is reached.
+    /// \param  length  Maximum number of bytes to process.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(std::istream &stream, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        hash_stream(stream, length);
+
+        return finish_hash_string(resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         bytes read from a binary stream, allocated from a memory
+    ///         resource.
+    ///
+    /// \param  stream  A binary input stream from which to read bytes,
+    ///                 until end of file is reached.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(brace::BinIStream &stream, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        hash_stream(stream);
+
+        return finish_hash_string(resource);
+    }
+
+    /// \brief  Create a string representation of a hash computed from
+    ///         bytes read from a binary stream, allocated from a memory
+    ///         resource.
+    ///
+    /// \param  stream  A binary input stream from which to read bytes,
+    ///                 until \p length bytes are read or end of file is
+    ///                 reached.
+    /// \param  length  Maximum number of bytes to process.
+    /// \param  resource    Memory resource from which to allocate the
+    ///                     returned string.
+    /// \return A string representation of the computed hash.
+    template<typename Resource>
+    auto compute_hash_string(brace::BinIStream &stream, size_t length, Resource *resource)
+            -> std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, Resource>, std::pmr::string>
+    {
+        hash_stream(stream, length);
+
+        return finish_hash_string(resource);
+    }
+#endif
+
     /// \brief  Get the size of the produced hash, in bits
     /// \return The size, in bits, of a hash produced by a hash algorithm.
     int hash_size() const noexcept
@@ -422,12 +644,110 @@ protected:
     /// of the hash and return the value of the hash.
     virtual std::vector<uint8_t> finalize_hash() = 0;
 
+    /// \brief  Finalize the hash operation, storing the resulting hash.
+    ///
+    /// \param  digest  Receives the hash, which is <tt>hash_size() / 8</tt>
+    ///                 bytes long.
+    ///
+    /// The default implementation copies the result of \c finalize_hash.
+    /// Override this function in derived classes to store the hash without
+    /// allocating.
+    virtual void finalize_hash_into(uint8_t *digest)
+    {
+        const auto  hash{finalize_hash()};
+
+        std::copy(hash.begin(), hash.end(), digest);
+    }
+
     /// \brief  Initialize or reinitialize the algorithm's internal state.
     ///
     /// Override this function in derived classes to initialize the hash algorithm.
     virtual void reset() = 0;
 
 private:
+    /// \brief  The size in bytes of the largest hash.
+    static constexpr size_t max_hash_bytes = 64;
+
+    void hash_stream(std::istream &stream)
+    {
+        constexpr size_t    buf_size = 4096;
+
+        uint8_t buffer[buf_size];
+
+        do
+        {
+            stream.read((char *)buffer, buf_size);
+            do_hash(buffer, static_cast<size_t>(stream.gcount()));
+        } while (stream);
+    }
+
+    void hash_stream(brace::BinIStream &stream)
+    {
+        constexpr size_t    buf_size = 4096;
+
+        brace::BinIStream::byte_type    buffer[buf_size];
+
+        do
+        {
+            stream.read(buffer, buf_size);
+            do_hash(buffer, static_cast<size_t>(stream.gcount()));
+        } while (stream);
+    }
+
+    void hash_stream(std::istream &stream, size_t length)
+    {
+        constexpr size_t    buf_size = 4096;
+
+        uint8_t buffer[buf_size];
+
+        while (length > 0)
+        {
+            if (!stream)
+                break;
+
+            size_t  count = std::min(length, buf_size);
+            stream.read((char *)buffer, count);
+            do_hash(buffer, static_cast<size_t>(stream.gcount()));
+            length -= static_cast<size_t>(stream.gcount());
+        }
+    }
+
+    void hash_stream(brace::BinIStream &stream, size_t length)
+    {
+        constexpr size_t    buf_size = 4096;
+
+        brace::BinIStream::byte_type    buffer[buf_size];
+
+        while (length > 0)
+        {
+            if (!stream)
+                break;
+
+            size_t  count = std::min(length, buf_size);
+            stream.read(buffer, count);
+            do_hash(buffer, static_cast<size_t>(stream.gcount()));
+            length -= static_cast<size_t>(stream.gcount());
+        }
+    }
+
+#if defined(__cpp_lib_memory_resource)
+    std::pmr::vector<uint8_t> finish_hash(std::pmr::memory_resource *resource)
+    {
+        std::pmr::vector<uint8_t>   rv(static_cast<size_t>(_hash_size / 8), resource);
+
+        finalize_hash_into(rv.data());
+        return rv;
+    }
+
+    std::pmr::string finish_hash_string(std::pmr::memory_resource *resource)
+    {
+        std::array<uint8_t, max_hash_bytes> digest;
+
+        finalize_hash_into(digest.data());
+        return hash_to_string(digest.data(), static_cast<size_t>(_hash_size / 8), resource);
+    }
+#endif
+
     int _hash_size; // Hash size in bits
 };
 
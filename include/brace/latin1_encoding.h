@@ -16,6 +16,7 @@
 
 #include "brace/text_encoding.h"
 #include "brace/string.h"
+#include "brace/text_codec.h"
 
 namespace brace {
 
@@ -36,7 +37,7 @@ public:
         _enable_control_codes = enable;
     }
 
-    bool controls_enabled()
+    bool controls_enabled() const noexcept
     {
         return _enable_control_codes;
     }
@@ -63,34 +64,25 @@ public:
 
     int decode(const unsigned char *bytes) const noexcept override
     {
-        if (!_enable_control_codes)
-        {
-            if (*bytes >= 0 && *bytes <= 0xFF)
-                return -1;
-            if (*bytes >= 0x7F && *bytes <= 0x9F)
-                return -1;
-        }
-
-        return *bytes;
+        return _enable_control_codes ? decode_sequence<Latin1Codec<true>>(bytes)
+                                     : decode_sequence<Latin1Codec<false>>(bytes);
     }
 
-    int encode(int ch, unsigned char *bytes, int length)
+    DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept override
     {
-        if (!_enable_control_codes)
-        {
-            if (   ch >= 0 && ch <= 0xFF
-                || ch >=0x7F && ch <= 0x9F)
-            {
-                return -1;
-            }
-        }
-
-        if (bytes && length >= 1)
-        {
-            *bytes = static_cast<unsigned char>(ch);
-        }
-
-        return 1;
+        return _enable_control_codes ? decode_sequence<Latin1Codec<true>>(bytes, length)
+                                     : decode_sequence<Latin1Codec<false>>(bytes, length);
+    }
+
+    int encode(int ch, unsigned char *bytes, int length) const noexcept override
+    {
+        return _enable_control_codes ? encode_sequence<Latin1Codec<true>>(ch, bytes, length)
+                                     : encode_sequence<Latin1Codec<false>>(ch, bytes, length);
+    }
+
+    int sequence_length(const unsigned char *bytes, int length) const noexcept override
+    {
+        return measure_sequence<Latin1Codec<>>(bytes, length);
     }
 
 private:
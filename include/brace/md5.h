@@ -106,7 +106,15 @@ private:
         memcpy(&_buffer[index], &input[i], length - i);
     }
 
-    std::vector<uint8_t> finalize_hash()
+    std::vector<uint8_t> finalize_hash() override
+    {
+        std::vector<uint8_t>    digest(sizeof _digest);
+
+        finalize_hash_into(digest.data());
+        return digest;
+    }
+
+    void finalize_hash_into(uint8_t *digest) override
     {
         static uint8_t padding[64] =
             {
@@ -139,7 +147,7 @@ private:
             _finalized = true;
         }
 
-        return std::vector<uint8_t>(std::begin(_digest), std::end(_digest));
+        std::copy(std::begin(_digest), std::end(_digest), digest);
     }
 
     void reset() override
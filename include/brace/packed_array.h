@@ -0,0 +1,433 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file packed_array.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_PACKED_ARRAY_INC
+#define BRACE_LIB_PACKED_ARRAY_INC
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "brace/binistream.h"
+#include "brace/binostream.h"
+
+namespace brace {
+
+/// \brief  An array of unsigned integers of a fixed width of 1 to 32 bits,
+///         packed end to end.
+/// \details    Element \e i occupies bits <tt>i * width()</tt> through
+///             <tt>(i + 1) * width() - 1</tt> of a sequence of 64-bit words,
+///             counting from the least significant bit of the first word,
+///             so an element may straddle two words. Only the low width()
+///             bits of a value are stored.
+///
+///             Elements are read and written individually with get() and
+///             set(), or in bulk with append() and unpack(). When AVX2 is
+///             available unpack() extracts eight elements of up to 25 bits
+///             at a time: a byte shuffle moves each element's bytes into a
+///             32-bit lane, and a variable shift and a mask finish it.
+class PackedArray
+{
+public:
+    /// \brief  The widest element supported, in bits.
+    static constexpr unsigned max_width{32};
+
+    /// \brief  Construct an empty array.
+    /// \param width    Width of each element in bits, from 1 to max_width.
+    /// \throws std::invalid_argument if \p width is out of range.
+    explicit PackedArray(unsigned width)
+      : PackedArray(width, 0)
+    {}
+
+    /// \brief  Construct an array of zeros.
+    /// \param width    Width of each element in bits, from 1 to max_width.
+    /// \param size     Number of elements.
+    /// \throws std::invalid_argument if \p width is out of range.
+    /// \throws std::length_error if \p size is greater than max_size().
+    PackedArray(unsigned width, size_t size)
+      : _width{checked_width(width)}
+      , _mask{(uint64_t{1} << _width) - 1}
+    {
+        resize(size);
+    }
+
+    /// \brief  Retrieve the width of each element in bits.
+    unsigned width() const noexcept
+    {
+        return _width;
+    }
+
+    /// \brief  Retrieve the number of elements.
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// \brief  Retrieve the largest number of elements whose bits can be
+    ///         counted in a \c size_t.
+    size_t max_size() const noexcept
+    {
+        return (std::numeric_limits<size_t>::max() - 63) / _width;
+    }
+
+    /// \brief  Determine if the array has no elements.
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    /// \brief  Retrieve the number of 64-bit words holding the elements.
+    size_t word_count() const noexcept
+    {
+        return words_for(_size);
+    }
+
+    /// \brief  Retrieve a pointer to the words holding the elements.
+    const uint64_t *words() const noexcept
+    {
+        return _words.data();
+    }
+
+    /// \brief  Retrieve an element.
+    /// \param index    Zero-based index of the element; must be less than size().
+    /// \return The value of the element.
+    uint32_t get(size_t index) const noexcept
+    {
+        const size_t    bit{index * _width};
+        const unsigned  shift{static_cast<unsigned>(bit % 64)};
+        const uint64_t *p{_words.data() + bit / 64};
+
+        // The second word is always present, since the storage is padded.
+        return static_cast<uint32_t>(((p[0] >> shift) | ((p[1] << 1) << (63 - shift))) & _mask);
+    }
+
+    /// \brief  Retrieve an element.
+    /// \param index    Zero-based index of the element; must be less than size().
+    /// \return The value of the element.
+    uint32_t operator[](size_t index) const noexcept
+    {
+        return get(index);
+    }
+
+    /// \brief  Replace an element.
+    /// \param index    Zero-based index of the element; must be less than size().
+    /// \param value    The new value. Only its low width() bits are stored.
+    void set(size_t index, uint32_t value) noexcept
+    {
+        const size_t    bit{index * _width};
+        const unsigned  shift{static_cast<unsigned>(bit % 64)};
+        uint64_t       *p{_words.data() + bit / 64};
+        const uint64_t  v{value & _mask};
+
+        p[0] = (p[0] & ~(_mask << shift)) | (v << shift);
+        p[1] = (p[1] & ~((_mask >> 1) >> (63 - shift))) | ((v >> 1) >> (63 - shift));
+    }
+
+    /// \brief  Add an element to the end of the array.
+    /// \param value    The value to add. Only its low width() bits are stored.
+    void push_back(uint32_t value)
+    {
+        resize(_size + 1);
+        set(_size - 1, value);
+    }
+
+    /// \brief  Add elements to the end of the array.
+    /// \param values   Pointer to the values to add. Only the low width()
+    ///                 bits of each are stored.
+    /// \param count    Number of values pointed to by \p values.
+    /// \details    The values are packed into a 64-bit accumulator that is
+    ///             stored as each word fills.
+    void append(const uint32_t *values, size_t count)
+    {
+        size_t  bit{_size * _width};
+
+        resize(_size + count);
+
+        uint64_t   *p{_words.data() + bit / 64};
+        unsigned    fill{static_cast<unsigned>(bit % 64)};
+        uint64_t    acc{*p};        // bits past the old end are zero
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t  v{values[i] & _mask};
+
+            acc |= v << fill;
+            fill += _width;
+            if (fill >= 64)
+            {
+                *p++ = acc;
+                fill -= 64;
+                acc = v >> (_width - fill);
+            }
+        }
+        if (fill)
+            *p = acc;
+    }
+
+    /// \brief  Copy a range of elements into an array of integers.
+    /// \param first    Index of the first element to copy.
+    /// \param count    Number of elements to copy. <tt>first + count</tt>
+    ///                 must not exceed size().
+    /// \param dst      Pointer to an array of at least \p count integers.
+    /// \details    Decoding a block of 128 or 256 elements takes 16 or 32
+    ///             vector steps when AVX2 is available and the width is at
+    ///             most 25 bits.
+    void unpack(size_t first, size_t count, uint32_t *dst) const noexcept
+    {
+        size_t  i{0};
+
+#if defined(__AVX2__)
+        if (_width <= 25 && count >= 8)
+        {
+            // Decode one element at a time to reach a multiple of eight,
+            // where the elements start on a byte boundary.
+            const size_t    head{(8 - first % 8) % 8};
+
+            unpack_scalar(first, head, dst);
+            i = head;
+            i += unpack_avx2(first + i, count - i, dst + i);
+        }
+#endif
+
+        unpack_scalar(first + i, count - i, dst + i);
+    }
+
+    /// \brief  Change the number of elements.
+    /// \param size The new number of elements. New elements are zero.
+    /// \throws std::length_error if \p size is greater than max_size().
+    void resize(size_t size)
+    {
+        check_size(size);
+
+        const size_t    words{words_for(size)};
+
+        if (size < _size)
+        {
+            // Clear the bits past the new end, so that appending and
+            // comparing words see zeros there.
+            const size_t    bit{size * _width};
+
+            if (bit % 64)
+                _words[bit / 64] &= (uint64_t{1} << (bit % 64)) - 1;
+            std::fill(_words.begin() + static_cast<std::ptrdiff_t>(words), _words.end(), 0);
+        }
+        _words.resize(words + padding_words, 0);
+        _size = size;
+    }
+
+    /// \brief  Reserve storage for a number of elements.
+    /// \param size Number of elements to reserve storage for.
+    /// \throws std::length_error if \p size is greater than max_size().
+    void reserve(size_t size)
+    {
+        check_size(size);
+        _words.reserve(words_for(size) + padding_words);
+    }
+
+    /// \brief  Remove all of the elements.
+    void clear() noexcept
+    {
+        resize(0);
+    }
+
+    /// \brief  Compare two arrays.
+    /// \return \c true if the arrays have the same width and elements.
+    friend bool operator==(const PackedArray &a, const PackedArray &b) noexcept
+    {
+        return a._width == b._width && a._size == b._size && a._words == b._words;
+    }
+
+    /// \brief  Compare two arrays.
+    /// \return \c true if the arrays differ in width or in any element.
+    friend bool operator!=(const PackedArray &a, const PackedArray &b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    friend BinIStream &operator>>(BinIStream &stream, PackedArray &array);
+
+    // Words past the end of the elements, which are always zero. They let
+    // get() and set() touch two words unconditionally, and let the vector
+    // loads in unpack() read past the last element.
+    static constexpr size_t padding_words{4};
+
+    // The width, once it is known to be valid, so that the mask can be
+    // computed from it.
+    static unsigned checked_width(unsigned width)
+    {
+        if (width == 0 || width > max_width)
+            throw std::invalid_argument("PackedArray width must be from 1 to 32 bits");
+        return width;
+    }
+
+    size_t words_for(size_t size) const noexcept
+    {
+        return (size * _width + 63) / 64;
+    }
+
+    void check_size(size_t size) const
+    {
+        if (size > max_size())
+            throw std::length_error("PackedArray size is too large");
+    }
+
+    void unpack_scalar(size_t first, size_t count, uint32_t *dst) const noexcept
+    {
+        const size_t    bit{first * _width};
+        const uint64_t *p{_words.data() + bit / 64};
+        unsigned        shift{static_cast<unsigned>(bit % 64)};
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] = static_cast<uint32_t>(((p[0] >> shift) | ((p[1] << 1) << (63 - shift))) & _mask);
+            shift += _width;
+            if (shift >= 64)
+            {
+                shift -= 64;
+                ++p;
+            }
+        }
+    }
+
+#if defined(__AVX2__)
+    // Decode groups of eight elements, the first of which starts on a byte
+    // boundary. Returns the number of elements decoded, a multiple of 8.
+    //
+    // The eight elements occupy width() bytes. Elements 0-3 lie within the
+    // 16 bytes at the start of the group and elements 4-7 within the 16
+    // bytes starting at the byte holding element 4, so each half is
+    // loaded into one 128-bit lane and a byte shuffle gathers the four
+    // bytes under each element into its 32-bit lane.
+    size_t unpack_avx2(size_t first, size_t count, uint32_t *dst) const noexcept
+    {
+        const auto     *bytes{reinterpret_cast<const unsigned char *>(_words.data()) + first * _width / 8};
+        const size_t    high_offset{4 * _width / 8};
+        alignas(32) unsigned char   shuffle[32];
+        alignas(32) uint32_t        shifts[8];
+
+        for (unsigned j = 0; j < 8; ++j)
+        {
+            const unsigned  start{j * _width};
+            const unsigned  base{static_cast<unsigned>(j < 4 ? 0 : high_offset)};
+
+            for (unsigned k = 0; k < 4; ++k)
+                shuffle[4 * j + k] = static_cast<unsigned char>(start / 8 - base + k);
+            shifts[j] = start % 8;
+        }
+
+        const __m256i   shuffle_v{_mm256_load_si256(reinterpret_cast<const __m256i *>(shuffle))};
+        const __m256i   shift_v{_mm256_load_si256(reinterpret_cast<const __m256i *>(shifts))};
+        const __m256i   mask_v{_mm256_set1_epi32(static_cast<int>(_mask))};
+        size_t          i{0};
+
+        for (; i + 8 <= count; i += 8, bytes += _width)
+        {
+            const __m128i   lo{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes))};
+            const __m128i   hi{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + high_offset))};
+            const __m256i   v{_mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle_v)};
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                                _mm256_and_si256(_mm256_srlv_epi32(v, shift_v), mask_v));
+        }
+
+        return i;
+    }
+#endif
+
+    unsigned                _width;
+    uint64_t                _mask;
+    size_t                  _size{0};
+    std::vector<uint64_t>   _words;
+};
+
+/// \brief  Write a PackedArray to a binary output stream.
+/// \param stream   The stream to write to.
+/// \param array    The array to write.
+/// \return \p stream
+/// \details    The width is written as an 8-bit value and the number of
+///             elements as a 64-bit value, followed by the words holding
+///             the elements, in the stream's byte order.
+inline BinOStream &operator<<(BinOStream &stream, const PackedArray &array)
+{
+    stream << static_cast<uint8_t>(array.width()) << static_cast<uint64_t>(array.size());
+    return stream.write_values(array.words(), array.word_count());
+}
+
+/// \brief  Read a PackedArray from a binary input stream.
+/// \param stream   The stream to read from.
+/// \param array    Receives the array. It is unchanged if the stream fails
+///                 or holds an invalid width or a size greater than
+///                 max_size(), which set \c failbit.
+/// \return \p stream
+/// \details    The words are read a block at a time, so a corrupt size fails
+///             when the stream runs out of data rather than first
+///             allocating memory for all of the words it claims to hold.
+inline BinIStream &operator>>(BinIStream &stream, PackedArray &array)
+{
+    constexpr size_t    block_words{size_t{1} << 16};
+    uint8_t             width{0};
+    uint64_t            size{0};
+
+    if (!(stream >> width >> size))
+        return stream;
+
+    if (width == 0 || width > PackedArray::max_width)
+    {
+        stream.setstate(std::ios_base::failbit);
+        return stream;
+    }
+
+    PackedArray result(width);
+
+    if (size > result.max_size())
+    {
+        stream.setstate(std::ios_base::failbit);
+        return stream;
+    }
+
+    const size_t    count{result.words_for(static_cast<size_t>(size))};
+
+    for (size_t first = 0; first < count; )
+    {
+        const size_t    n{std::min(block_words, count - first)};
+
+        result._words.resize(first + n + PackedArray::padding_words, 0);
+        if (!stream.read_values(result._words.data() + first, n))
+            return stream;
+        first += n;
+    }
+    result._size = static_cast<size_t>(size);
+
+    // Clear any bits past the last element.
+    const size_t    bit{result._size * result._width};
+
+    if (bit % 64)
+        result._words[bit / 64] &= (uint64_t{1} << (bit % 64)) - 1;
+    array = std::move(result);
+
+    return stream;
+}
+
+}
+
+#endif  // BRACE_LIB_PACKED_ARRAY_INC
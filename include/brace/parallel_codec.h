@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file parallel_codec.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_PARALLEL_CODEC_INC
+#define BRACE_LIB_PARALLEL_CODEC_INC
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace brace {
+
+/// \brief  Number of input bytes encoded by one task in parallel_encode().
+/// \details    The actual size is rounded up to a whole number of blocks.
+inline constexpr size_t parallel_encode_chunk{size_t{1} << 16};
+
+/// \brief  Encode a range of bytes with a Base16, Base32 or Base64 codec,
+///         in parallel.
+/// \param codec    The codec to encode with, such as brace::Base64.
+/// \param beg      Random-access iterator at the beginning of the data.
+/// \param end      Random-access iterator at one past the end of the data.
+/// \param wrapat   Position at which to wrap lines. If zero, no line
+///                 wrapping occurs.
+/// \param pool     The pool on which to run the work.
+/// \return The same string as <tt>codec.encode(beg, end, wrapat)</tt>.
+/// \details    The input is cut into chunks of a multiple of 15 bytes,
+///             which is a whole number of input groups for each of the
+///             codecs, so that only the last chunk is padded. When lines
+///             are wrapped the chunks are also a multiple of \p wrapat
+///             groups, so that every chunk but the last ends a line. The
+///             chunks are encoded on \p pool and joined in order.
+template <typename Codec, typename input_iterator>
+auto parallel_encode(const Codec &codec, input_iterator beg, input_iterator end, size_t wrapat = 0,
+                     ThreadPool &pool = ThreadPool::default_pool())
+        -> std::enable_if_t<sizeof(*beg) == 1
+                            && std::is_base_of_v<std::random_access_iterator_tag,
+                                                 typename std::iterator_traits<input_iterator>::iterator_category>,
+                            std::string>
+{
+    const size_t    size{static_cast<size_t>(end - beg)};
+    const size_t    block{15 * (wrapat ? wrapat : 1)};
+    const size_t    chunk{(parallel_encode_chunk + block - 1) / block * block};
+    const size_t    count{(size + chunk - 1) / chunk};
+
+    if (count <= 1)
+        return codec.encode(beg, end, wrapat);
+
+    std::vector<std::string>    parts(count);
+
+    pool.parallel_for(0, count, 1, [&](size_t first, size_t last)
+                      {
+                          for (size_t i = first; i < last; ++i)
+                          {
+                              const auto    b{beg + i * chunk};
+                              const auto    e{i + 1 < count ? b + chunk : end};
+
+                              parts[i] = codec.encode(b, e, wrapat);
+                          }
+                      });
+
+    size_t  total{0};
+
+    for (const auto &part : parts)
+        total += part.size();
+
+    std::string rv;
+
+    rv.reserve(total);
+    for (const auto &part : parts)
+        rv += part;
+
+    return rv;
+}
+
+}
+
+#endif  // BRACE_LIB_PARALLEL_CODEC_INC
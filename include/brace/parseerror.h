@@ -74,6 +74,55 @@ private:
     size_t  _pos;
 };
 
+/// \brief  The kinds of error that decoding can report.
+enum class CodecDecodeError
+{
+    None,               ///< The input was decoded successfully.
+    InvalidCharacter,   ///< A character outside the alphabet, or out of place.
+    InvalidLength,      ///< The input ended part way through a group, or was badly padded.
+    OutputFailed        ///< The decoded data could not all be written.
+};
+
+/// \brief  The outcome of a decoding operation that does not throw.
+/// \details    A CodecDecodeResult is small and trivially copyable, and building
+///             one never allocates, so reporting invalid input costs no more
+///             than reporting success.
+struct CodecDecodeResult
+{
+    /// \brief  The kind of error, or CodecDecodeError::None.
+    CodecDecodeError    error{CodecDecodeError::None};
+    /// \brief  The line number where the error occurred.
+    size_t              line{0};
+    /// \brief  The position (column) in the line where the error occurred.
+    size_t              position{0};
+    /// \brief  Static text describing the error, or \c nullptr.
+    const char         *message{nullptr};
+    /// \brief  The number of decoded bytes written.
+    size_t              size{0};
+
+    /// \brief  Determine if decoding succeeded.
+    constexpr bool ok() const noexcept
+    {
+        return error == CodecDecodeError::None;
+    }
+
+    /// \brief  Determine if decoding succeeded.
+    constexpr explicit operator bool() const noexcept
+    {
+        return ok();
+    }
+
+    /// \brief  Throw a BasicParseError if the input was invalid.
+    /// \details    Failure to write the output is not thrown; as with the
+    ///             throwing decode functions, the state of the output can be
+    ///             checked instead.
+    void throw_if_invalid() const
+    {
+        if (error == CodecDecodeError::InvalidCharacter || error == CodecDecodeError::InvalidLength)
+            throw BasicParseError(line, position, message);
+    }
+};
+
 }
 
 #endif  // BRACE_LIB_PARSEERROR_INC
@@ -0,0 +1,338 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file rank_select.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_RANK_SELECT_INC
+#define BRACE_LIB_RANK_SELECT_INC
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "brace/binistream.h"
+#include "brace/binostream.h"
+#include "brace/bits.h"
+
+namespace brace {
+
+/// \brief  An immutable bit vector answering rank queries in constant
+///         time and select queries in logarithmic time.
+/// \details    The bits are held in 64-bit words, bit \e i in bit <tt>i % 64</tt>
+///             of word <tt>i / 64</tt>. Alongside them is a directory with one
+///             64-bit entry for each superblock of 2048 bits: the number of
+///             set bits before the superblock, and the running counts of
+///             set bits in the first three of its four 512-bit blocks. A
+///             block is one 64-byte cache line of words, so a rank query
+///             reads one directory entry and popcounts within a single
+///             cache line. The directory adds 1/32 (about 3%) to the size of
+///             the bits.
+///
+///             For select, the superblock holding every 8192nd set bit is
+///             sampled. A query binary-searches the directory between two
+///             samples, picks the block from the running counts, popcounts
+///             to the word, and finds the bit within the word with
+///             select_bit(), which is a PDEP and a TZCNT when BMI2 is
+///             available. Where set bits are dense the samples are only a
+///             few superblocks apart and the search takes a step or two,
+///             but in a sparse vector two samples can be as far apart as
+///             <tt>size() / 2048</tt> superblocks, so a query takes time
+///             logarithmic in size() in the worst case.
+class RankSelect
+{
+public:
+    /// \brief  Value returned by select() when there is no such bit.
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /// \brief  Construct an empty bit vector.
+    RankSelect()
+    {
+        build();
+    }
+
+    /// \brief  Construct a bit vector from a vector of words.
+    /// \param words    The bits, with bit \e i in bit <tt>i % 64</tt> of
+    ///                 word <tt>i / 64</tt>.
+    explicit RankSelect(std::vector<uint64_t> words)
+      : _words{std::move(words)}
+      , _size{_words.size() * 64}
+    {
+        build();
+    }
+
+    /// \brief  Construct a bit vector from a vector of words.
+    /// \param words    The bits, with bit \e i in bit <tt>i % 64</tt> of
+    ///                 word <tt>i / 64</tt>. Words are added or removed as
+    ///                 needed to hold exactly \p size bits, and any bits
+    ///                 past \p size are cleared.
+    /// \param size     Number of bits in the vector.
+    RankSelect(std::vector<uint64_t> words, size_t size)
+      : _words{std::move(words)}
+      , _size{size}
+    {
+        _words.resize(word_count(size));
+        if (size % 64)
+            _words.back() &= (uint64_t{1} << (size % 64)) - 1;
+        build();
+    }
+
+    /// \brief  Construct a bit vector from an array of words.
+    /// \param words    Pointer to the bits, with bit \e i in bit <tt>i % 64</tt>
+    ///                 of word <tt>i / 64</tt>.
+    /// \param size     Number of bits pointed to by \p words.
+    RankSelect(const uint64_t *words, size_t size)
+      : RankSelect(std::vector<uint64_t>(words, words + word_count(size)), size)
+    {}
+
+    /// \brief  Retrieve the number of words needed to hold a number of bits.
+    static constexpr size_t word_count(size_t size) noexcept
+    {
+        return size / 64 + (size % 64 != 0);
+    }
+
+    /// \brief  Retrieve the number of bits in the vector.
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// \brief  Retrieve the number of set bits in the vector.
+    size_t count() const noexcept
+    {
+        return _count;
+    }
+
+    /// \brief  Retrieve the words holding the bits.
+    const std::vector<uint64_t> &words() const noexcept
+    {
+        return _words;
+    }
+
+    /// \brief  Test a bit.
+    /// \param pos  Zero-based position of the bit; must be less than size().
+    /// \return \c true if the bit is set.
+    bool operator[](size_t pos) const noexcept
+    {
+        return (_words[pos / 64] >> (pos % 64)) & 1;
+    }
+
+    /// \brief  Count the set bits before a position.
+    /// \param pos  Position, which may be from zero to size().
+    /// \return The number of set bits in positions 0 through <tt>pos - 1</tt>.
+    size_t rank(size_t pos) const noexcept
+    {
+        const size_t    superblock{pos / superblock_bits};
+        const size_t    block{pos / block_bits};
+        const size_t    last{pos / 64};
+        size_t          rv{superblock_rank(superblock) + block_rank(_directory[superblock], block % blocks_per_superblock)};
+
+        for (size_t w = block * words_per_block; w < last; ++w)
+            rv += static_cast<size_t>(popcount(_words[w]));
+        if (pos % 64)
+            rv += static_cast<size_t>(popcount(_words[last] & ((uint64_t{1} << (pos % 64)) - 1)));
+
+        return rv;
+    }
+
+    /// \brief  Count the clear bits before a position.
+    /// \param pos  Position, which may be from zero to size().
+    /// \return The number of clear bits in positions 0 through <tt>pos - 1</tt>.
+    size_t rank_zero(size_t pos) const noexcept
+    {
+        return pos - rank(pos);
+    }
+
+    /// \brief  Find a set bit by its rank.
+    /// \param n    Zero-based index of the set bit to find.
+    /// \details    Takes time logarithmic in the number of superblocks
+    ///             between the samples bounding \p n; see the class
+    ///             description.
+    /// \return The position of the set bit with \p n set bits before it,
+    ///         or npos if \p n is not less than count().
+    size_t select(size_t n) const noexcept
+    {
+        if (n >= _count)
+            return npos;
+
+        // Find the last superblock that starts with at most n set bits
+        // before it. The samples bound the search.
+        size_t  lo{_samples[n / select_sample]};
+        size_t  hi{_samples[n / select_sample + 1]};
+
+        while (lo < hi)
+        {
+            const size_t    mid{lo + (hi - lo + 1) / 2};
+
+            if (superblock_rank(mid) <= n)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+
+        const uint64_t  entry{_directory[lo]};
+        size_t          remaining{n - superblock_rank(lo)};
+        size_t          block{0};
+
+        while (block + 1 < blocks_per_superblock && block_rank(entry, block + 1) <= remaining)
+            ++block;
+        remaining -= block_rank(entry, block);
+
+        size_t  w{(lo * blocks_per_superblock + block) * words_per_block};
+
+        for (;; ++w)
+        {
+            const auto  bits{static_cast<size_t>(popcount(_words[w]))};
+
+            if (remaining < bits)
+                break;
+            remaining -= bits;
+        }
+
+        return w * 64 + static_cast<size_t>(select_bit(_words[w], static_cast<int>(remaining)));
+    }
+
+private:
+    static constexpr size_t block_bits{512};
+    static constexpr size_t words_per_block{block_bits / 64};
+    static constexpr size_t blocks_per_superblock{4};
+    static constexpr size_t superblock_bits{block_bits * blocks_per_superblock};
+    static constexpr size_t superblocks_per_chunk{size_t{1} << 21};     // 2^32 bits
+    static constexpr size_t select_sample{8192};
+
+    // A directory entry holds, in its low 32 bits, the number of set bits
+    // before the superblock counted from the start of its chunk of 2^32
+    // bits. The high 32 bits hold the number of set bits before blocks
+    // 1, 2 and 3 of the superblock, in fields of 10, 11 and 11 bits.
+    static size_t block_rank(uint64_t entry, size_t block) noexcept
+    {
+        constexpr int       shifts[blocks_per_superblock]{0, 32, 42, 53};
+        constexpr uint64_t  masks[blocks_per_superblock]{0, 0x3FF, 0x7FF, 0x7FF};
+
+        return static_cast<size_t>((entry >> shifts[block]) & masks[block]);
+    }
+
+    size_t superblock_rank(size_t superblock) const noexcept
+    {
+        return static_cast<size_t>(_chunks[superblock / superblocks_per_chunk] + static_cast<uint32_t>(_directory[superblock]));
+    }
+
+    void build()
+    {
+        // One more superblock than needed, so that rank(size()) and the
+        // select search always have an entry to read.
+        const size_t    superblocks{_size / superblock_bits + 1};
+        uint64_t        total{0};
+
+        _directory.assign(superblocks, 0);
+        _chunks.assign((superblocks - 1) / superblocks_per_chunk + 1, 0);
+        _samples.clear();
+
+        for (size_t sb = 0; sb < superblocks; ++sb)
+        {
+            if (sb % superblocks_per_chunk == 0)
+                _chunks[sb / superblocks_per_chunk] = total;
+
+            uint64_t    entry{total - _chunks[sb / superblocks_per_chunk]};
+            uint64_t    in_superblock{0};
+
+            for (size_t block = 0; block < blocks_per_superblock; ++block)
+            {
+                if (block > 0)
+                    entry |= in_superblock << (block == 1 ? 32 : block == 2 ? 42 : 53);
+
+                const size_t    first{(sb * blocks_per_superblock + block) * words_per_block};
+                const size_t    end{first + words_per_block < _words.size() ? first + words_per_block : _words.size()};
+
+                if (first < end)
+                    in_superblock += popcount(_words.data() + first, end - first);
+            }
+            _directory[sb] = entry;
+
+            // Sample the superblock holding each 8192nd set bit.
+            while (_samples.size() * select_sample < total + in_superblock)
+                _samples.push_back(sb);
+            total += in_superblock;
+        }
+
+        _samples.push_back(superblocks - 1);
+        _count = static_cast<size_t>(total);
+    }
+
+    std::vector<uint64_t>   _words;
+    size_t                  _size{0};
+    size_t                  _count{0};
+    std::vector<uint64_t>   _directory;
+    std::vector<uint64_t>   _chunks;
+    std::vector<size_t>     _samples;
+};
+
+/// \brief  Write a RankSelect to a binary output stream.
+/// \param stream   The stream to write to.
+/// \param bits     The bit vector to write.
+/// \return \p stream
+/// \details    The number of bits is written as a 64-bit value, followed by
+///             the words holding them, in the stream's byte order. The
+///             directory is not written; it is rebuilt when the bit vector
+///             is read.
+inline BinOStream &operator<<(BinOStream &stream, const RankSelect &bits)
+{
+    stream << static_cast<uint64_t>(bits.size());
+    return stream.write_values(bits.words().data(), bits.words().size());
+}
+
+/// \brief  Read a RankSelect from a binary input stream.
+/// \param stream   The stream to read from.
+/// \param bits     Receives the bit vector. It is unchanged if the stream
+///                 fails or holds a size too large to represent, which sets
+///                 \c failbit.
+/// \return \p stream
+/// \details    The words are read a block at a time, so a corrupt size fails
+///             when the stream runs out of data rather than first
+///             allocating memory for all of the words it claims to hold.
+inline BinIStream &operator>>(BinIStream &stream, RankSelect &bits)
+{
+    constexpr size_t    block_words{size_t{1} << 16};
+    uint64_t            size{0};
+
+    if (!(stream >> size))
+        return stream;
+
+    if (size > std::numeric_limits<size_t>::max()
+        || RankSelect::word_count(static_cast<size_t>(size)) > std::vector<uint64_t>().max_size())
+    {
+        stream.setstate(std::ios_base::failbit);
+        return stream;
+    }
+
+    const size_t            count{RankSelect::word_count(static_cast<size_t>(size))};
+    std::vector<uint64_t>   words;
+
+    while (words.size() < count)
+    {
+        const size_t    first{words.size()};
+        const size_t    n{std::min(block_words, count - first)};
+
+        words.resize(first + n);
+        if (!stream.read_values(words.data() + first, n))
+            return stream;
+    }
+
+    bits = RankSelect(std::move(words), static_cast<size_t>(size));
+    return stream;
+}
+
+}
+
+#endif  // BRACE_LIB_RANK_SELECT_INC
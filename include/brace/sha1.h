@@ -64,16 +64,20 @@ private:
 
     std::vector<uint8_t> finalize_hash() override
     {
-        pad_message();
-
         std::vector<uint8_t>    digest(20);
 
-        for (size_t i=0; i < digest.size(); i++)
+        finalize_hash_into(digest.data());
+        return digest;
+    }
+
+    void finalize_hash_into(uint8_t *digest) override
+    {
+        pad_message();
+
+        for (size_t i=0; i < 20; i++)
             digest[i] = (uint8_t)(_state[i >> 2] >> (8 * (3 - (i & 0x03))));
 
         reset();    // clear any potentially sensitive information
-
-        return digest;
     }
 
     void reset() override
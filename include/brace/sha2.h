@@ -108,19 +108,23 @@ private:
     }
 
     std::vector<uint8_t> finalize_hash() override
+    {
+        std::vector<uint8_t>    digest(static_cast<size_t>(hash_size() / 8));
+
+        finalize_hash_into(digest.data());
+        return digest;
+    }
+
+    void finalize_hash_into(uint8_t *digest) override
     {
         pad_message();
 
         auto    nbytes{hash_size() / 8};
 
-        std::vector<uint8_t>    digest(nbytes);
-
         for (int i = 0; i < nbytes; ++i)
             digest[i] = (uint8_t)(_state[i >> 2] >> 8 * (3 - (i & 0x03)));
 
         reset();
-
-        return digest;
     }
 
     void process_message_block()
@@ -398,19 +402,23 @@ private:
     }
 
     std::vector<uint8_t> finalize_hash() override
+    {
+        std::vector<uint8_t>    digest(static_cast<size_t>(hash_size() / 8));
+
+        finalize_hash_into(digest.data());
+        return digest;
+    }
+
+    void finalize_hash_into(uint8_t *digest) override
     {
         pad_message();
 
         auto    nbytes{hash_size() / 8};
 
-        std::vector<uint8_t>    digest(nbytes);
-
         for (int i = 0; i < nbytes; ++i)
             digest[i] = (uint8_t)(_state[i >> 3] >> 8 * (7 - (i % 8)));
 
         reset();
-
-        return digest;
     }
 
     void process_message_block()
@@ -14,13 +14,440 @@
 #ifndef BRACE_LIB_STRING_INC
 #define BRACE_LIB_STRING_INC
 
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 #include <brace/ascii.h>
+#include <brace/bits.h>
+#include <brace/byteorder.h>
 
 namespace brace {
 
+/// \cond
+namespace detail {
+
+// Fold the ASCII upper-case letters in a vector of bytes to lower case.
+// Bytes above 0x7F compare as negative, so they are never in range.
+#if defined(__AVX2__)
+inline __m256i fold_case(__m256i v) noexcept
+{
+    const __m256i   upper{_mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v))};
+
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+inline __m128i fold_case(__m128i v) noexcept
+{
+    const __m128i   upper{_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)))};
+
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+// Find the first position at which two character arrays differ other
+// than in the case of an ASCII letter, or length if they do not.
+inline size_t ci_mismatch(const char *s1, const char *s2, size_t length) noexcept
+{
+    size_t  pos{0};
+
+#if defined(__AVX2__)
+    for (; pos + 32 <= length; pos += 32)
+    {
+        const __m256i   v1{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s1 + pos))};
+        const __m256i   v2{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s2 + pos))};
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(fold_case(v1), fold_case(v2))) != -1)
+            break;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; pos + 16 <= length; pos += 16)
+    {
+        const __m128i   v1{_mm_loadu_si128(reinterpret_cast<const __m128i *>(s1 + pos))};
+        const __m128i   v2{_mm_loadu_si128(reinterpret_cast<const __m128i *>(s2 + pos))};
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(fold_case(v1), fold_case(v2))) != 0xFFFF)
+            break;
+    }
+#endif
+
+    // Finish the tail, or locate the difference in the block that
+    // stopped the vector loop.
+    for (; pos < length; ++pos)
+    {
+        if (s1[pos] != s2[pos] && Ascii::to_lower(s1[pos]) != Ascii::to_lower(s2[pos]))
+            break;
+    }
+
+    return pos;
+}
+
+// Flip the case of every byte of in that lies in the range first to
+// first + 25, writing the result to out, which may be the same as in.
+// Passing 'a' converts to upper case, and 'A' to lower case.
+inline void flip_case(const char *in, size_t length, char *out, char first) noexcept
+{
+    size_t  pos{0};
+
+    // Subtracting first and adding 0x80 moves the range to the bottom of
+    // the signed byte range, so one signed compare tests both ends.
+#if defined(__AVX512BW__)
+    {
+        const __m512i   offset{_mm512_set1_epi8(static_cast<char>(0x80 - first))};
+        const __m512i   limit{_mm512_set1_epi8(static_cast<char>(0x80 + 26))};
+        const __m512i   bit{_mm512_set1_epi8(0x20)};
+
+        for (; pos + 64 <= length; pos += 64)
+        {
+            const __m512i   v{_mm512_loadu_si512(in + pos)};
+            const __mmask64 letters{_mm512_cmplt_epi8_mask(_mm512_add_epi8(v, offset), limit)};
+
+            _mm512_storeu_si512(out + pos, _mm512_xor_si512(v, _mm512_maskz_mov_epi8(letters, bit)));
+        }
+    }
+#endif
+#if defined(__AVX2__)
+    {
+        const __m256i   offset{_mm256_set1_epi8(static_cast<char>(0x80 - first))};
+        const __m256i   limit{_mm256_set1_epi8(static_cast<char>(0x80 + 26))};
+        const __m256i   bit{_mm256_set1_epi8(0x20)};
+
+        for (; pos + 32 <= length; pos += 32)
+        {
+            const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + pos))};
+            const __m256i   letters{_mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, offset))};
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + pos),
+                                _mm256_xor_si256(v, _mm256_and_si256(letters, bit)));
+        }
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    {
+        const __m128i   offset{_mm_set1_epi8(static_cast<char>(0x80 - first))};
+        const __m128i   limit{_mm_set1_epi8(static_cast<char>(0x80 + 26))};
+        const __m128i   bit{_mm_set1_epi8(0x20)};
+
+        for (; pos + 16 <= length; pos += 16)
+        {
+            const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos))};
+            const __m128i   letters{_mm_cmplt_epi8(_mm_add_epi8(v, offset), limit)};
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos),
+                             _mm_xor_si128(v, _mm_and_si128(letters, bit)));
+        }
+    }
+#endif
+
+    for (; pos < length; ++pos)
+    {
+        const auto  ch{static_cast<unsigned char>(in[pos])};
+
+        out[pos] = static_cast<char>(static_cast<unsigned>(ch - first) < 26 ? ch ^ 0x20 : ch);
+    }
+}
+
+// Find the first byte that is one of the bytes in set, which holds at
+// most max_vector_set bytes, or length if there is none.
+constexpr size_t    max_vector_set{16};
+
+inline size_t find_any_of(const char *str, size_t length, std::string_view set) noexcept
+{
+    size_t  pos{0};
+
+#if defined(__AVX2__)
+    for (; pos + 32 <= length; pos += 32)
+    {
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + pos))};
+        __m256i         found{_mm256_setzero_si256()};
+
+        for (char c : set)
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+        if (_mm256_movemask_epi8(found))
+            break;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; pos + 16 <= length; pos += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + pos))};
+        __m128i         found{_mm_setzero_si128()};
+
+        for (char c : set)
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+        if (_mm_movemask_epi8(found))
+            break;
+    }
+#endif
+
+    for (; pos < length; ++pos)
+    {
+        if (set.find(str[pos]) != std::string_view::npos)
+            break;
+    }
+
+    return pos;
+}
+
+// Fold the ASCII upper-case letters in eight packed bytes to lower case.
+inline uint64_t fold_case(uint64_t word) noexcept
+{
+    constexpr uint64_t  ones{0x0101010101010101};
+    constexpr uint64_t  high{0x8080808080808080};
+
+    // With the top bit of each byte cleared, adding these constants sets
+    // it again exactly when the byte is at least 'A', or greater than 'Z'.
+    const uint64_t  low7{word & ~high};
+    const uint64_t  at_least_a{low7 + (0x80 - 'A') * ones};
+    const uint64_t  above_z{low7 + (0x7F - 'Z') * ones};
+    const uint64_t  upper{(at_least_a ^ above_z) & ~word & high};
+
+    return word | (upper >> 2);
+}
+
+inline size_t ci_hash_bytes(const char *str, size_t length) noexcept
+{
+    constexpr uint64_t  multiplier{0x9E3779B97F4A7C15};
+
+    uint64_t    h{length * multiplier};
+    size_t      pos{0};
+
+    for (; pos + 8 <= length; pos += 8)
+    {
+        uint64_t    word;
+
+        std::memcpy(&word, str + pos, 8);
+        h = (rotate_left(h, 23) ^ fold_case(word)) * multiplier;
+    }
+    if (pos < length)
+    {
+        uint64_t    word{0};
+
+        std::memcpy(&word, str + pos, length - pos);
+        h = (rotate_left(h, 23) ^ fold_case(word)) * multiplier;
+    }
+
+    // Final avalanche, so that the low bits used for bucket selection
+    // depend on every input bit.
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCD;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53;
+    h ^= h >> 33;
+
+    return static_cast<size_t>(h);
+}
+
+// Needles at least this long are searched for with Horspool's algorithm,
+// whose skips then outrun the vector filter.
+constexpr size_t    ci_horspool_threshold{32};
+
+// Find the first occurrence of pattern in str without regard to case,
+// with a case-folded Boyer-Moore-Horspool search. The pattern must not
+// be empty. Returns npos if there is none.
+inline size_t ci_horspool(const char *str, size_t length, const char *pattern, size_t plen) noexcept
+{
+    const size_t    last_pos{plen - 1};
+    const int       last{Ascii::to_lower(static_cast<unsigned char>(pattern[last_pos]))};
+    size_t          shift[256];
+
+    // The shift table is indexed by folded characters, so a character
+    // shifts by the distance of the last occurrence of either case.
+    for (auto &distance : shift)
+        distance = plen;
+    for (size_t k = 0; k < last_pos; ++k)
+        shift[Ascii::to_lower(static_cast<unsigned char>(pattern[k]))] = last_pos - k;
+
+    for (size_t pos = 0; pos + plen <= length; )
+    {
+        const int   ch{Ascii::to_lower(static_cast<unsigned char>(str[pos + last_pos]))};
+
+        if (ch == last && ci_mismatch(str + pos, pattern, last_pos) == last_pos)
+            return pos;
+        pos += shift[ch];
+    }
+
+    return std::string_view::npos;
+}
+
+// Find the first occurrence of pattern in str without regard to case.
+// The pattern must not be empty. Returns npos if there is none.
+//
+// Short patterns use a vector filter: each block of candidate positions
+// is compared, folded, against the pattern's first and last characters,
+// and only the positions that match both are verified in full.
+inline size_t ci_search(const char *str, size_t length, const char *pattern, size_t plen) noexcept
+{
+    if (plen > length)
+        return std::string_view::npos;
+    if (plen >= ci_horspool_threshold)
+        return ci_horspool(str, length, pattern, plen);
+
+    const size_t    last_pos{plen - 1};
+    const size_t    middle{plen > 2 ? plen - 2 : 0};
+    const size_t    end{length - last_pos};     // number of candidate positions
+    const int       first_ch{Ascii::to_lower(static_cast<unsigned char>(pattern[0]))};
+    const int       last_ch{Ascii::to_lower(static_cast<unsigned char>(pattern[last_pos]))};
+    size_t          pos{0};
+
+#if defined(__AVX2__)
+    {
+        const __m256i   first{_mm256_set1_epi8(static_cast<char>(first_ch))};
+        const __m256i   last{_mm256_set1_epi8(static_cast<char>(last_ch))};
+
+        for (; pos + 32 <= end; pos += 32)
+        {
+            const __m256i   v1{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + pos))};
+            const __m256i   v2{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + pos + last_pos))};
+            auto            mask{static_cast<uint32_t>(_mm256_movemask_epi8(
+                                    _mm256_and_si256(_mm256_cmpeq_epi8(fold_case(v1), first),
+                                                     _mm256_cmpeq_epi8(fold_case(v2), last))))};
+
+            for (; mask; mask &= mask - 1)
+            {
+                const size_t    candidate{pos + static_cast<size_t>(countr_zero(mask))};
+
+                if (ci_mismatch(str + candidate + 1, pattern + 1, middle) == middle)
+                    return candidate;
+            }
+        }
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    {
+        const __m128i   first{_mm_set1_epi8(static_cast<char>(first_ch))};
+        const __m128i   last{_mm_set1_epi8(static_cast<char>(last_ch))};
+
+        for (; pos + 16 <= end; pos += 16)
+        {
+            const __m128i   v1{_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + pos))};
+            const __m128i   v2{_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + pos + last_pos))};
+            auto            mask{static_cast<uint32_t>(_mm_movemask_epi8(
+                                    _mm_and_si128(_mm_cmpeq_epi8(fold_case(v1), first),
+                                                  _mm_cmpeq_epi8(fold_case(v2), last))))};
+
+            for (; mask; mask &= mask - 1)
+            {
+                const size_t    candidate{pos + static_cast<size_t>(countr_zero(mask))};
+
+                if (ci_mismatch(str + candidate + 1, pattern + 1, middle) == middle)
+                    return candidate;
+            }
+        }
+    }
+#endif
+
+    for (; pos < end; ++pos)
+    {
+        if (   Ascii::to_lower(static_cast<unsigned char>(str[pos])) == first_ch
+            && Ascii::to_lower(static_cast<unsigned char>(str[pos + last_pos])) == last_ch
+            && ci_mismatch(str + pos + 1, pattern + 1, middle) == middle)
+        {
+            return pos;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Convert all of the lower-case characters in str to upper case.
+/// \tparam S   type of string
+/// \param str  string to convert
+template <typename S>
+void to_upper_in_place(S &str)
+{
+    for (auto &ch : str)
+        ch = static_cast<typename S::value_type>(Ascii::to_upper(ch));
+}
+
+/// \brief  Convert all of the upper-case characters in str to lower case.
+/// \tparam S   type of string
+/// \param str  string to convert
+template <typename S>
+void to_lower_in_place(S &str)
+{
+    for (auto &ch : str)
+        ch = static_cast<typename S::value_type>(Ascii::to_lower(ch));
+}
+
+/// \brief  Convert all of the lower-case characters in a buffer to upper case.
+/// \param str      pointer to the characters to convert
+/// \param length   number of characters pointed to by \p str
+/// \details    The buffer is converted 16, 32 or 64 characters at a time
+///             when SSE2, AVX2 or AVX-512BW is available.
+inline void to_upper_in_place(char *str, size_t length) noexcept
+{
+    detail::flip_case(str, length, str, 'a');
+}
+
+/// \brief  Convert all of the upper-case characters in a buffer to lower case.
+/// \param str      pointer to the characters to convert
+/// \param length   number of characters pointed to by \p str
+/// \details    The buffer is converted 16, 32 or 64 characters at a time
+///             when SSE2, AVX2 or AVX-512BW is available.
+inline void to_lower_in_place(char *str, size_t length) noexcept
+{
+    detail::flip_case(str, length, str, 'A');
+}
+
+/// \brief  Convert all of the lower-case characters in str to upper case.
+/// \param str  string to convert
+inline void to_upper_in_place(std::string &str) noexcept
+{
+    to_upper_in_place(str.data(), str.size());
+}
+
+/// \brief  Convert all of the upper-case characters in str to lower case.
+/// \param str  string to convert
+inline void to_lower_in_place(std::string &str) noexcept
+{
+    to_lower_in_place(str.data(), str.size());
+}
+
+/// \brief  Write an upper-case copy of str to a buffer.
+/// \param str  original string
+/// \param dst  pointer to a buffer of at least str.size() characters. It may
+///             be str.data() itself.
+/// \return The number of characters written, which is str.size().
+inline size_t to_upper(std::string_view str, char *dst) noexcept
+{
+    detail::flip_case(str.data(), str.size(), dst, 'a');
+    return str.size();
+}
+
+/// \brief  Write a lower-case copy of str to a buffer.
+/// \param str  original string
+/// \param dst  pointer to a buffer of at least str.size() characters. It may
+///             be str.data() itself.
+/// \return The number of characters written, which is str.size().
+inline size_t to_lower(std::string_view str, char *dst) noexcept
+{
+    detail::flip_case(str.data(), str.size(), dst, 'A');
+    return str.size();
+}
+
 /// \brief  Return a copy of str containing all upper-case characters.
 /// \tparam S   type of string
 /// \param str  original string
@@ -30,17 +457,7 @@ S to_upper(const S &str)
 {
     S   rv{str};
 
-    auto    it{rv.begin()};
-    auto    end{rv.end()};
-
-    while (it != end)
-    {
-        int     ch{static_cast<unsigned char>(*it)};
-
-        *it = static_cast<typename S::value_type>(Ascii::to_upper(ch));
-        ++it;
-    }
-
+    to_upper_in_place(rv);
     return rv;
 }
 
@@ -54,17 +471,7 @@ S to_lower(const S &str)
 {
     S   rv{str};
 
-    auto    it{rv.begin()};
-    auto    end{rv.end()};
-
-    while (it != end)
-    {
-        int     ch{static_cast<unsigned char>(*it)};
-
-        *it = static_cast<typename S::value_type>(Ascii::to_lower(ch));
-        ++it;
-    }
-
+    to_lower_in_place(rv);
     return rv;
 }
 
@@ -120,9 +527,21 @@ inline int ci_compare(std::basic_string_view<CharT, Traits> sv1,
 ///         string_view, the function returns a value < 0. If the first string_view
 ///         compares greater than the second string_view, the function returns
 ///         a value > 0.
+/// \details    The strings are compared 16 or 32 characters at a time when
+///             SSE2 or AVX2 is available. The result is the same as that of
+///             the generic template.
 inline int ci_compare(std::string_view sv1, std::string_view sv2)
 {
-    return ci_compare<char>(sv1, sv2);
+    const size_t    length{sv1.size() < sv2.size() ? sv1.size() : sv2.size()};
+    const size_t    pos{detail::ci_mismatch(sv1.data(), sv2.data(), length)};
+
+    if (pos == length)
+        return sv1.size() == sv2.size() ? 0 : (sv1.size() < sv2.size() ? -1 : 1);
+
+    const auto  c1{static_cast<char>(Ascii::to_lower(sv1[pos]))};
+    const auto  c2{static_cast<char>(Ascii::to_lower(sv2[pos]))};
+
+    return c1 < c2 ? -1 : 1;
 }
 /// \brief  Compare two wstring_view objects without regard to case.
 /// \param sv1 First wstring_view to compare.
@@ -164,6 +583,1066 @@ inline int ci_compare(std::u32string_view sv1, std::u32string_view sv2)
     return ci_compare<char32_t>(sv1, sv2);
 }
 
+/// \brief  Determine if two string_view objects are equal without regard
+///         to case.
+/// \tparam CharT   Character type for string_view
+/// \tparam Traits  Traits for string_view
+/// \param sv1 First string_view to compare.
+/// \param sv2 Second string_view to compare.
+/// \return true if the string_views are the same length and equal
+///         (regardless of case), false otherwise.
+template <typename CharT,
+          typename Traits = std::char_traits<CharT>>
+inline bool ci_equal(std::basic_string_view<CharT, Traits> sv1,
+                     std::basic_string_view<CharT, Traits> sv2)
+{
+    return sv1.size() == sv2.size() && ci_compare<CharT, Traits>(sv1, sv2) == 0;
+}
+
+/// \brief  Determine if two string_view objects are equal without regard
+///         to case.
+/// \param sv1 First string_view to compare.
+/// \param sv2 Second string_view to compare.
+/// \return true if the string_views are the same length and equal
+///         (regardless of case), false otherwise.
+/// \details    Strings of different lengths are rejected without examining
+///             their contents; otherwise the strings are compared 16 or 32
+///             characters at a time when SSE2 or AVX2 is available.
+inline bool ci_equal(std::string_view sv1, std::string_view sv2)
+{
+    return sv1.size() == sv2.size() && detail::ci_mismatch(sv1.data(), sv2.data(), sv1.size()) == sv1.size();
+}
+/// \brief  Determine if two wstring_view objects are equal without regard
+///         to case.
+/// \param sv1 First wstring_view to compare.
+/// \param sv2 Second wstring_view to compare.
+/// \return true if the string_views are the same length and equal
+///         (regardless of case), false otherwise.
+inline bool ci_equal(std::wstring_view sv1, std::wstring_view sv2)
+{
+    return ci_equal<wchar_t>(sv1, sv2);
+}
+/// \brief  Determine if two u16string_view objects are equal without regard
+///         to case.
+/// \param sv1 First u16string_view to compare.
+/// \param sv2 Second u16string_view to compare.
+/// \return true if the string_views are the same length and equal
+///         (regardless of case), false otherwise.
+inline bool ci_equal(std::u16string_view sv1, std::u16string_view sv2)
+{
+    return ci_equal<char16_t>(sv1, sv2);
+}
+/// \brief  Determine if two u32string_view objects are equal without regard
+///         to case.
+/// \param sv1 First u32string_view to compare.
+/// \param sv2 Second u32string_view to compare.
+/// \return true if the string_views are the same length and equal
+///         (regardless of case), false otherwise.
+inline bool ci_equal(std::u32string_view sv1, std::u32string_view sv2)
+{
+    return ci_equal<char32_t>(sv1, sv2);
+}
+
+/// \brief  Determine if a string_view begins with a prefix without regard
+///         to case.
+/// \tparam CharT   Character type for string_view
+/// \tparam Traits  Traits for string_view
+/// \param sv       The string_view to examine.
+/// \param prefix   The prefix to look for.
+/// \return true if \p sv begins with \p prefix (regardless of case),
+///         false otherwise.
+template <typename CharT,
+          typename Traits = std::char_traits<CharT>>
+inline bool ci_starts_with(std::basic_string_view<CharT, Traits> sv,
+                           std::basic_string_view<CharT, Traits> prefix)
+{
+    return sv.size() >= prefix.size() && ci_equal<CharT, Traits>(sv.substr(0, prefix.size()), prefix);
+}
+
+/// \brief  Determine if a string_view begins with a prefix without regard
+///         to case.
+/// \param sv       The string_view to examine.
+/// \param prefix   The prefix to look for.
+/// \return true if \p sv begins with \p prefix (regardless of case),
+///         false otherwise.
+inline bool ci_starts_with(std::string_view sv, std::string_view prefix)
+{
+    return    sv.size() >= prefix.size()
+           && detail::ci_mismatch(sv.data(), prefix.data(), prefix.size()) == prefix.size();
+}
+/// \brief  Determine if a wstring_view begins with a prefix without regard
+///         to case.
+/// \param sv       The wstring_view to examine.
+/// \param prefix   The prefix to look for.
+/// \return true if \p sv begins with \p prefix (regardless of case),
+///         false otherwise.
+inline bool ci_starts_with(std::wstring_view sv, std::wstring_view prefix)
+{
+    return ci_starts_with<wchar_t>(sv, prefix);
+}
+/// \brief  Determine if a u16string_view begins with a prefix without regard
+///         to case.
+/// \param sv       The u16string_view to examine.
+/// \param prefix   The prefix to look for.
+/// \return true if \p sv begins with \p prefix (regardless of case),
+///         false otherwise.
+inline bool ci_starts_with(std::u16string_view sv, std::u16string_view prefix)
+{
+    return ci_starts_with<char16_t>(sv, prefix);
+}
+/// \brief  Determine if a u32string_view begins with a prefix without regard
+///         to case.
+/// \param sv       The u32string_view to examine.
+/// \param prefix   The prefix to look for.
+/// \return true if \p sv begins with \p prefix (regardless of case),
+///         false otherwise.
+inline bool ci_starts_with(std::u32string_view sv, std::u32string_view prefix)
+{
+    return ci_starts_with<char32_t>(sv, prefix);
+}
+
+/// \brief  Find the first occurrence of a substring without regard to case.
+/// \tparam CharT   Character type
+/// \tparam Traits  Traits for string_view
+/// \param str      The string_view to search.
+/// \param substr   The substring to look for.
+/// \param pos      The position in \p str at which to start the search.
+/// \return The position of the first occurrence of \p substr at or after
+///         \p pos (regardless of case), or npos if there is none.
+template <typename CharT,
+          typename Traits = std::char_traits<CharT>>
+inline size_t ci_find(std::basic_string_view<CharT, Traits> str,
+                      std::basic_string_view<CharT, Traits> substr,
+                      size_t pos = 0)
+{
+    if (pos > str.size() || substr.size() > str.size() - pos)
+        return str.npos;
+
+    for (const size_t last{str.size() - substr.size()}; pos <= last; ++pos)
+    {
+        if (ci_equal<CharT, Traits>(str.substr(pos, substr.size()), substr))
+            return pos;
+    }
+
+    return str.npos;
+}
+
+/// \brief  Find the first occurrence of a substring in a string_view
+///         without regard to case.
+/// \param str      The string_view to search.
+/// \param substr   The substring to look for.
+/// \param pos      The position in \p str at which to start the search.
+/// \return The position of the first occurrence of \p substr at or after
+///         \p pos (regardless of case), or npos if there is none.
+/// \details    Short substrings are found by comparing 16 or 32 positions
+///             at a time against the substring's first and last characters
+///             when SSE2 or AVX2 is available, verifying only the positions
+///             where both match. Substrings of 32 or more characters are
+///             found with a case-folded Boyer-Moore-Horspool search.
+inline size_t ci_find(std::string_view str, std::string_view substr, size_t pos = 0) noexcept
+{
+    if (pos > str.size())
+        return str.npos;
+    if (substr.empty())
+        return pos;
+
+    const size_t    found{detail::ci_search(str.data() + pos, str.size() - pos, substr.data(), substr.size())};
+
+    return found == str.npos ? str.npos : pos + found;
+}
+/// \brief  Find the first occurrence of a substring in a wstring_view
+///         without regard to case.
+/// \param str      The wstring_view to search.
+/// \param substr   The substring to look for.
+/// \param pos      The position in \p str at which to start the search.
+/// \return The position of the first occurrence of \p substr at or after
+///         \p pos (regardless of case), or npos if there is none.
+inline size_t ci_find(std::wstring_view str, std::wstring_view substr, size_t pos = 0)
+{
+    return ci_find<wchar_t>(str, substr, pos);
+}
+/// \brief  Find the first occurrence of a substring in a u16string_view
+///         without regard to case.
+/// \param str      The u16string_view to search.
+/// \param substr   The substring to look for.
+/// \param pos      The position in \p str at which to start the search.
+/// \return The position of the first occurrence of \p substr at or after
+///         \p pos (regardless of case), or npos if there is none.
+inline size_t ci_find(std::u16string_view str, std::u16string_view substr, size_t pos = 0)
+{
+    return ci_find<char16_t>(str, substr, pos);
+}
+/// \brief  Find the first occurrence of a substring in a u32string_view
+///         without regard to case.
+/// \param str      The u32string_view to search.
+/// \param substr   The substring to look for.
+/// \param pos      The position in \p str at which to start the search.
+/// \return The position of the first occurrence of \p substr at or after
+///         \p pos (regardless of case), or npos if there is none.
+inline size_t ci_find(std::u32string_view str, std::u32string_view substr, size_t pos = 0)
+{
+    return ci_find<char32_t>(str, substr, pos);
+}
+
+/// \brief  Determine if a string_view contains a substring without regard
+///         to case.
+/// \param str      The string_view to search.
+/// \param substr   The substring to look for.
+/// \return true if \p substr occurs in \p str (regardless of case),
+///         false otherwise.
+inline bool ci_contains(std::string_view str, std::string_view substr) noexcept
+{
+    return ci_find(str, substr) != str.npos;
+}
+/// \brief  Determine if a wstring_view contains a substring without regard
+///         to case.
+/// \param str      The wstring_view to search.
+/// \param substr   The substring to look for.
+/// \return true if \p substr occurs in \p str (regardless of case),
+///         false otherwise.
+inline bool ci_contains(std::wstring_view str, std::wstring_view substr)
+{
+    return ci_find(str, substr) != str.npos;
+}
+/// \brief  Determine if a u16string_view contains a substring without
+///         regard to case.
+/// \param str      The u16string_view to search.
+/// \param substr   The substring to look for.
+/// \return true if \p substr occurs in \p str (regardless of case),
+///         false otherwise.
+inline bool ci_contains(std::u16string_view str, std::u16string_view substr)
+{
+    return ci_find(str, substr) != str.npos;
+}
+/// \brief  Determine if a u32string_view contains a substring without
+///         regard to case.
+/// \param str      The u32string_view to search.
+/// \param substr   The substring to look for.
+/// \return true if \p substr occurs in \p str (regardless of case),
+///         false otherwise.
+inline bool ci_contains(std::u32string_view str, std::u32string_view substr)
+{
+    return ci_find(str, substr) != str.npos;
+}
+
+/// \brief  Hash function object for strings that ignores ASCII case.
+/// \details    Strings that compare equal with ci_equal have the same hash,
+///             so together with ci_equal_to this makes unordered containers
+///             keyed case-insensitively without normalizing the keys. Case is
+///             folded eight bytes at a time while hashing, so no copy of the
+///             string is made. Both function objects are transparent: with
+///             C++20 a container keyed by std::string can be searched with a
+///             std::string_view or string literal without converting it.
+struct ci_hash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const noexcept
+    {
+        return detail::ci_hash_bytes(str.data(), str.size());
+    }
+};
+
+/// \brief  Equality function object for strings that ignores ASCII case.
+/// \details    Intended for use with ci_hash.
+struct ci_equal_to
+{
+    using is_transparent = void;
+
+    bool operator()(std::string_view sv1, std::string_view sv2) const noexcept
+    {
+        return ci_equal(sv1, sv2);
+    }
+};
+
+/// \brief  Remove the white space from the start of a string_view.
+/// \param str  string to trim
+/// \return A string_view of \p str without its leading white space.
+inline std::string_view trim_left(std::string_view str) noexcept
+{
+    str.remove_prefix(Ascii::span(str, Ascii::SPACE));
+    return str;
+}
+
+/// \brief  Remove the white space from the end of a string_view.
+/// \param str  string to trim
+/// \return A string_view of \p str without its trailing white space.
+inline std::string_view trim_right(std::string_view str) noexcept
+{
+    size_t  length{str.size()};
+
+    while (length > 0 && Ascii::is_space(static_cast<unsigned char>(str[length - 1])))
+        --length;
+
+    return str.substr(0, length);
+}
+
+/// \brief  Remove the white space from both ends of a string_view.
+/// \param str  string to trim
+/// \return A string_view of \p str without its leading and trailing white space.
+inline std::string_view trim(std::string_view str) noexcept
+{
+    return trim_right(trim_left(str));
+}
+
+/// \brief  Options controlling how split() divides a string.
+enum class SplitOptions : unsigned
+{
+    /// \brief  Return every piece as it is.
+    None        = 0,
+    /// \brief  Remove leading and trailing white space from each piece.
+    Trim        = 1,
+    /// \brief  Omit pieces that are empty (after trimming, if requested).
+    SkipEmpty   = 2
+};
+
+/// \brief  Combine SplitOptions.
+constexpr SplitOptions operator|(SplitOptions a, SplitOptions b) noexcept
+{
+    return static_cast<SplitOptions>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+/// \brief  A range of the pieces of a string separated by delimiters.
+/// \details    A SplitRange is created by split() or tokenize(). It finds
+///             each piece only as iteration reaches it, and each piece is a
+///             std::string_view into the original string, so splitting never
+///             allocates. The string, and for a set of delimiters the set,
+///             must outlive the range and its iterators.
+///
+///             Delimiters are searched for 16 or 32 bytes at a time when SSE2
+///             or AVX2 is available; white space is found with
+///             Ascii::find_first.
+class SplitRange
+{
+public:
+    /// \brief  Forward iterator over the pieces of a SplitRange.
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string_view *;
+        using reference         = const std::string_view &;
+
+        /// \brief  Construct an end iterator.
+        iterator() = default;
+
+        reference operator*() const noexcept
+        {
+            return _piece;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_piece;
+        }
+
+        iterator &operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator    rv{*this};
+
+            advance();
+            return rv;
+        }
+
+        bool operator==(const iterator &other) const noexcept
+        {
+            return _range == other._range && _next == other._next && _piece.data() == other._piece.data();
+        }
+
+        bool operator!=(const iterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class SplitRange;
+
+        explicit iterator(const SplitRange *range) noexcept
+          : _range{range}
+          , _next{0}
+        {
+            advance();
+        }
+
+        void advance() noexcept
+        {
+            for (;;)
+            {
+                if (_next == std::string_view::npos)
+                {
+                    *this = iterator{};
+                    return;
+                }
+
+                const std::string_view  str{_range->_str};
+                const size_t            start{_next};
+                const size_t            found{_range->find_delimiter(start)};
+
+                _piece = str.substr(start, found - start);
+                _next = found == str.size() ? std::string_view::npos : _range->skip_delimiter(found);
+
+                if (_range->has(SplitOptions::Trim))
+                    _piece = trim(_piece);
+                if (!_piece.empty() || !_range->has(SplitOptions::SkipEmpty))
+                    return;
+            }
+        }
+
+        const SplitRange   *_range{nullptr};
+        size_t              _next{std::string_view::npos};
+        std::string_view    _piece;
+    };
+
+    using const_iterator = iterator;
+
+    iterator begin() const noexcept
+    {
+        return iterator{this};
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator{};
+    }
+
+private:
+    friend SplitRange split(std::string_view str, char delimiter, SplitOptions options) noexcept;
+    friend SplitRange split(std::string_view str, std::string_view delimiters, SplitOptions options) noexcept;
+    friend SplitRange tokenize(std::string_view str) noexcept;
+
+    enum class Kind
+    {
+        Char,
+        Set,
+        Space
+    };
+
+    SplitRange(std::string_view str, Kind kind, char delimiter, std::string_view delimiters,
+               SplitOptions options) noexcept
+      : _str{str}
+      , _delimiters{delimiters}
+      , _delimiter{delimiter}
+      , _kind{kind}
+      , _options{options}
+    {}
+
+    bool has(SplitOptions option) const noexcept
+    {
+        return (static_cast<unsigned>(_options) & static_cast<unsigned>(option)) != 0;
+    }
+
+    // Find the next delimiter at or after pos, or the end of the string.
+    size_t find_delimiter(size_t pos) const noexcept
+    {
+        const char     *p{_str.data() + pos};
+        const size_t    length{_str.size() - pos};
+
+        switch (_kind)
+        {
+            case Kind::Space:
+                return pos + Ascii::find_first(std::string_view(p, length), Ascii::SPACE);
+
+            case Kind::Set:
+                if (_delimiters.size() > detail::max_vector_set)
+                {
+                    const size_t    found{_str.find_first_of(_delimiters, pos)};
+
+                    return found == std::string_view::npos ? _str.size() : found;
+                }
+                return pos + detail::find_any_of(p, length, _delimiters);
+
+            case Kind::Char:
+            default:
+                return pos + detail::find_any_of(p, length, std::string_view(&_delimiter, 1));
+        }
+    }
+
+    // Find where the piece after the delimiter at pos begins. A run of
+    // white space is a single delimiter.
+    size_t skip_delimiter(size_t pos) const noexcept
+    {
+        if (_kind == Kind::Space)
+            return pos + Ascii::span(_str.substr(pos), Ascii::SPACE);
+
+        return pos + 1;
+    }
+
+    std::string_view    _str;
+    std::string_view    _delimiters;
+    char                _delimiter;
+    Kind                _kind;
+    SplitOptions        _options;
+};
+
+/// \brief  Split a string at each occurrence of a delimiter.
+/// \param str          string to split
+/// \param delimiter    character separating the pieces
+/// \param options      whether to trim the pieces and omit empty ones
+/// \return A SplitRange of the pieces. Without SplitOptions::SkipEmpty,
+///         adjacent delimiters produce an empty piece, and a string with n
+///         delimiters always has n + 1 pieces.
+inline SplitRange split(std::string_view str, char delimiter,
+                        SplitOptions options = SplitOptions::None) noexcept
+{
+    return {str, SplitRange::Kind::Char, delimiter, {}, options};
+}
+
+/// \brief  Split a string at each occurrence of any of a set of delimiters.
+/// \param str          string to split
+/// \param delimiters   the characters that separate the pieces. The set
+///                     must outlive the returned range.
+/// \param options      whether to trim the pieces and omit empty ones
+/// \return A SplitRange of the pieces, as for split(std::string_view, char, SplitOptions).
+inline SplitRange split(std::string_view str, std::string_view delimiters,
+                        SplitOptions options = SplitOptions::None) noexcept
+{
+    return {str, SplitRange::Kind::Set, '\0', delimiters, options};
+}
+
+/// \brief  Divide a string into tokens separated by white space.
+/// \param str  string to divide
+/// \return A SplitRange of the tokens. A run of white space separates two
+///         tokens, and white space at either end of \p str is ignored, so
+///         no token is empty.
+inline SplitRange tokenize(std::string_view str) noexcept
+{
+    return {str, SplitRange::Kind::Space, '\0', {}, SplitOptions::SkipEmpty};
+}
+
+/// \brief  Divide a string into tokens separated by runs of delimiters.
+/// \param str          string to divide
+/// \param delimiters   the characters that separate the tokens. The set
+///                     must outlive the returned range.
+/// \return A SplitRange of the tokens. As with \c strtok, adjacent delimiters
+///         and delimiters at either end of \p str produce no empty tokens.
+inline SplitRange tokenize(std::string_view str, std::string_view delimiters) noexcept
+{
+    return split(str, delimiters, SplitOptions::SkipEmpty);
+}
+
+
+/// \brief  Indicates the outcome of parsing a number.
+enum class ParseStatus
+{
+    /// \brief  A number was parsed.
+    Ok,
+    /// \brief  The text does not begin with a number.
+    Invalid,
+    /// \brief  The number cannot be represented in the destination type.
+    OutOfRange
+};
+
+/// \brief  The result of parsing a number.
+struct ParseResult
+{
+    /// \brief  Outcome of the parse.
+    ParseStatus status;
+    /// \brief  If the status is ParseStatus::Invalid, the position at which
+    ///         a digit was expected. Otherwise the number of characters
+    ///         making up the number, which is the position of the first
+    ///         character following it.
+    size_t      position;
+
+    /// \brief  Determine if the parse succeeded.
+    /// \return \c true if a number was parsed and stored.
+    bool ok() const noexcept
+    {
+        return status == ParseStatus::Ok;
+    }
+};
+
+/// \brief  Size of a buffer large enough for any integer written by
+///         format_integer() or format_hex().
+constexpr size_t    max_integer_chars{21};
+/// \brief  Size of a buffer large enough for any value written by
+///         format_float().
+constexpr size_t    max_float_chars{24};
+
+/// \cond
+namespace detail {
+
+// Read eight bytes with the first in the low byte.
+inline uint64_t load_digits(const char *str) noexcept
+{
+    uint64_t    word;
+
+    std::memcpy(&word, str, 8);
+    return from_little_endian(word);
+}
+
+// Determine if all eight bytes of a word loaded by load_digits are
+// decimal digits. Adding six carries out of the low nibble of any byte
+// above '9', so both high nibbles are three only for '0' to '9'.
+inline bool is_eight_digits(uint64_t word) noexcept
+{
+    constexpr uint64_t  high_nibbles{0xF0F0F0F0F0F0F0F0};
+
+    return (  (word & high_nibbles)
+            | (((word + 0x0606060606060606) & high_nibbles) >> 4)) == 0x3333333333333333;
+}
+
+// Convert eight decimal digits loaded by load_digits to their value,
+// combining adjacent pairs, then pairs of pairs, then the two halves.
+inline uint32_t parse_eight_digits(uint64_t word) noexcept
+{
+    constexpr uint64_t  mask{0x000000FF000000FF};
+    constexpr uint64_t  mul1{100 + (1000000ULL << 32)};
+    constexpr uint64_t  mul2{1 + (10000ULL << 32)};
+
+    word -= 0x3030303030303030;
+    word = word * 10 + (word >> 8);
+    word = ((word & mask) * mul1 + ((word >> 16) & mask) * mul2) >> 32;
+
+    return static_cast<uint32_t>(word);
+}
+
+#if defined(__SSSE3__)
+// Convert sixteen decimal digits to their value, or return false if they
+// are not all digits.
+inline bool parse_sixteen_digits(const char *str, uint64_t &value) noexcept
+{
+    const __m128i   digits{_mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(str)),
+                                        _mm_set1_epi8('0'))};
+    const __m128i   bad{_mm_or_si128(_mm_cmplt_epi8(digits, _mm_setzero_si128()),
+                                     _mm_cmpgt_epi8(digits, _mm_set1_epi8(9)))};
+
+    if (_mm_movemask_epi8(bad))
+        return false;
+
+    // Multiply and add adjacent lanes to combine 2, then 4, then 8 digits.
+    const __m128i   pairs{_mm_maddubs_epi16(digits, _mm_set_epi8(1, 10, 1, 10, 1, 10, 1, 10,
+                                                                 1, 10, 1, 10, 1, 10, 1, 10))};
+    const __m128i   quads{_mm_madd_epi16(pairs, _mm_set_epi16(1, 100, 1, 100, 1, 100, 1, 100))};
+    const __m128i   packed{_mm_packs_epi32(quads, quads)};
+    const __m128i   eights{_mm_madd_epi16(packed, _mm_set_epi16(1, 10000, 1, 10000, 1, 10000, 1, 10000))};
+
+    value =   static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(eights))) * 100000000
+            + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(eights, 4)));
+    return true;
+}
+#endif
+
+// Accumulate the decimal digits at the start of str into value. Digits
+// that would overflow value set overflow and are skipped. Returns the
+// number of digits.
+inline size_t parse_decimal_digits(const char *str, size_t length, uint64_t &value, bool &overflow) noexcept
+{
+    size_t  pos{0};
+
+    // The vector and SWAR steps are taken only while the result cannot
+    // overflow; the scalar loop checks every digit.
+#if defined(__SSSE3__)
+    for (uint64_t sixteen; value < 1000 && pos + 16 <= length && parse_sixteen_digits(str + pos, sixteen); pos += 16)
+        value = value * 10000000000000000 + sixteen;
+#endif
+    for (; value < 100000000000 && pos + 8 <= length; pos += 8)
+    {
+        const uint64_t  word{load_digits(str + pos)};
+
+        if (!is_eight_digits(word))
+            break;
+        value = value * 100000000 + parse_eight_digits(word);
+    }
+
+    for (; pos < length; ++pos)
+    {
+        const unsigned  digit{static_cast<unsigned char>(str[pos]) - unsigned{'0'}};
+
+        if (digit > 9)
+            break;
+        if (overflow || value > (UINT64_MAX - digit) / 10)
+            overflow = true;
+        else
+            value = value * 10 + digit;
+    }
+
+    return pos;
+}
+
+// Accumulate the hexadecimal digits at the start of str into value, as
+// parse_decimal_digits does.
+inline size_t parse_hex_digits(const char *str, size_t length, uint64_t &value, bool &overflow) noexcept
+{
+    size_t  pos{0};
+
+    for (; pos < length; ++pos)
+    {
+        const int   ch{static_cast<unsigned char>(str[pos])};
+
+        if (!Ascii::is_hexdigit(ch))
+            break;
+        if (overflow || (value >> 60) != 0)
+            overflow = true;
+        else
+            value = (value << 4) | static_cast<unsigned>(Ascii::is_digit(ch) ? ch - '0' : (ch | 0x20) - 'a' + 10);
+    }
+
+    return pos;
+}
+
+// Parse an optionally signed integer whose digits are read by parse_digits.
+template <typename T, typename ParseDigits>
+ParseResult parse_integer(std::string_view str, T &value, ParseDigits parse_digits) noexcept
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t), "T must be an integer of at most 64 bits");
+
+    using U = std::make_unsigned_t<T>;
+
+    size_t  pos{0};
+    bool    negative{false};
+
+    if (!str.empty() && (str[0] == '-' || str[0] == '+'))
+    {
+        negative = str[0] == '-';
+        if (negative && std::is_unsigned_v<T>)
+            return {ParseStatus::Invalid, 0};
+        pos = 1;
+    }
+
+    uint64_t        magnitude{0};
+    bool            overflow{false};
+    const size_t    count{parse_digits(str.data() + pos, str.size() - pos, magnitude, overflow)};
+
+    if (count == 0)
+        return {ParseStatus::Invalid, pos};
+    pos += count;
+
+    const uint64_t  limit{static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0)};
+
+    if (overflow || magnitude > limit)
+        return {ParseStatus::OutOfRange, pos};
+
+    value = static_cast<T>(negative ? static_cast<U>(U{0} - static_cast<U>(magnitude)) : static_cast<U>(magnitude));
+    return {ParseStatus::Ok, pos};
+}
+
+// Write the decimal digits of value to dst, returning their number.
+inline size_t format_decimal(uint64_t value, char *dst) noexcept
+{
+    static constexpr char   digit_pairs[]{"00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899"};
+
+    size_t  length{1};
+
+    for (uint64_t power = 10; length < 20 && value >= power; power *= 10)
+        ++length;
+
+    // Write two digits at a time, from the end.
+    char   *p{dst + length};
+
+    for (; value >= 100; value /= 100)
+    {
+        p -= 2;
+        std::memcpy(p, digit_pairs + (value % 100) * 2, 2);
+    }
+    if (value >= 10)
+        std::memcpy(p - 2, digit_pairs + value * 2, 2);
+    else
+        p[-1] = static_cast<char>('0' + value);
+
+    return length;
+}
+
+// Write the lower-case hexadecimal digits of value to dst, returning
+// their number.
+inline size_t format_hex_digits(uint64_t value, char *dst) noexcept
+{
+    size_t  length{1};
+
+    while (length < 16 && (value >> (4 * length)) != 0)
+        ++length;
+
+    for (size_t i = length; i-- > 0; value >>= 4)
+        dst[i] = "0123456789abcdef"[value & 0xF];
+
+    return length;
+}
+
+// Write an integer's sign, if negative, then its magnitude with
+// format_digits.
+template <typename T, typename FormatDigits>
+size_t format_integer(T value, char *dst, FormatDigits format_digits) noexcept
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t), "T must be an integer of at most 64 bits");
+
+    using U = std::make_unsigned_t<T>;
+
+    auto    magnitude{static_cast<U>(value)};
+
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < 0)
+        {
+            *dst = '-';
+            return 1 + format_digits(static_cast<U>(U{0} - magnitude), dst + 1);
+        }
+    }
+
+    return format_digits(magnitude, dst);
+}
+
+// Powers of ten that are exactly representable as doubles.
+inline double exact_power_of_ten(int exponent) noexcept
+{
+    static constexpr double powers[]{1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                     1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                     1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    return powers[exponent];
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Parse a decimal integer from the start of a string.
+/// \tparam T       An integer type of at most 64 bits.
+/// \param str      The text to parse.
+/// \param value    Receives the value of the integer. It is unchanged
+///                 unless the parse succeeds.
+/// \return A ParseResult giving the outcome and either the length of the
+///         number or the position of the error.
+/// \details    The number is an optional sign followed by one or more
+///             decimal digits; a minus sign is invalid for an unsigned
+///             type. Parsing stops at the first character that is not a
+///             digit, so a caller that requires the whole string to be a
+///             number should check that \c position is \c str.size().
+///             Unlike \c std::stoi, leading white space is not skipped,
+///             the result does not depend on the locale, and nothing is
+///             allocated or thrown.
+///
+///             Runs of digits are converted 8 at a time with SWAR
+///             arithmetic, or 16 at a time when SSSE3 is available.
+template <typename T>
+ParseResult parse_integer(std::string_view str, T &value) noexcept
+{
+    return detail::parse_integer(str, value, detail::parse_decimal_digits);
+}
+
+/// \brief  Parse a hexadecimal integer from the start of a string.
+/// \tparam T       An integer type of at most 64 bits.
+/// \param str      The text to parse.
+/// \param value    Receives the value of the integer. It is unchanged
+///                 unless the parse succeeds.
+/// \return A ParseResult giving the outcome and either the length of the
+///         number or the position of the error.
+/// \details    As parse_integer(), with digits in either case as recognized
+///             by Ascii::is_hexdigit. No \c 0x prefix is accepted.
+template <typename T>
+ParseResult parse_hex(std::string_view str, T &value) noexcept
+{
+    return detail::parse_integer(str, value, detail::parse_hex_digits);
+}
+
+/// \brief  Parse a floating-point number from the start of a string.
+/// \param str      The text to parse.
+/// \param value    Receives the value of the number. It is unchanged
+///                 unless the parse succeeds.
+/// \return A ParseResult giving the outcome and either the length of the
+///         number or the position of the error.
+/// \details    The number is an optional sign followed by decimal digits
+///             with an optional decimal point and an optional exponent, or
+///             by \c inf, \c infinity or \c nan in any case. The decimal
+///             point is always a period, whatever the locale.
+///
+///             The digits are converted as by parse_integer(). A number
+///             whose digits form an integer of at most 2^53 and whose
+///             decimal exponent is within ±22 is then computed exactly by a
+///             single multiplication or division; any other number is
+///             converted with
+///             \c std::from_chars, which is correctly rounded. Without a
+///             floating-point \c std::from_chars, such numbers are computed
+///             in \c long double and may differ in the last place.
+inline ParseResult parse_float(std::string_view str, double &value) noexcept
+{
+    const char     *data{str.data()};
+    const size_t    length{str.size()};
+    size_t          pos{0};
+    bool            negative{false};
+
+    if (length > 0 && (data[0] == '-' || data[0] == '+'))
+    {
+        negative = data[0] == '-';
+        pos = 1;
+    }
+
+    const size_t    start{pos};
+
+    if (ci_starts_with(str.substr(pos), "inf"))
+    {
+        value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return {ParseStatus::Ok, pos + (ci_starts_with(str.substr(pos), "infinity") ? 8 : 3)};
+    }
+    if (ci_starts_with(str.substr(pos), "nan"))
+    {
+        value = negative ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN();
+        return {ParseStatus::Ok, pos + 3};
+    }
+
+    uint64_t    mantissa{0};
+    bool        overflow{false};
+    long        exponent{0};
+    size_t      digits{detail::parse_decimal_digits(data + pos, length - pos, mantissa, overflow)};
+
+    pos += digits;
+    if (pos < length && data[pos] == '.')
+    {
+        const size_t    fraction{detail::parse_decimal_digits(data + pos + 1, length - pos - 1, mantissa, overflow)};
+
+        if (digits + fraction > 0)
+            pos += 1 + fraction;
+        digits += fraction;
+        exponent -= static_cast<long>(fraction);
+    }
+    if (digits == 0)
+        return {ParseStatus::Invalid, start};
+
+    // The exponent is part of the number only if it has digits.
+    if (pos < length && (data[pos] | 0x20) == 'e')
+    {
+        size_t  epos{pos + 1};
+        bool    eneg{false};
+
+        if (epos < length && (data[epos] == '-' || data[epos] == '+'))
+            eneg = data[epos++] == '-';
+
+        uint64_t        e{0};
+        bool            eoverflow{false};
+        const size_t    edigits{detail::parse_decimal_digits(data + epos, length - epos, e, eoverflow)};
+
+        if (edigits > 0)
+        {
+            const long  clamped{eoverflow || e > 100000 ? 100000 : static_cast<long>(e)};
+
+            exponent += eneg ? -clamped : clamped;
+            pos = epos + edigits;
+        }
+    }
+
+    if (!overflow && (mantissa == 0 || (mantissa <= (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22)))
+    {
+        double  result{static_cast<double>(mantissa)};
+
+        if (mantissa != 0)
+        {
+            result = exponent < 0 ? result / detail::exact_power_of_ten(static_cast<int>(-exponent))
+                                  : result * detail::exact_power_of_ten(static_cast<int>(exponent));
+        }
+        value = negative ? -result : result;
+        return {ParseStatus::Ok, pos};
+    }
+
+#if defined(__cpp_lib_to_chars)
+    double  result;
+    const auto  rv{std::from_chars(data + start, data + pos, result)};
+
+    if (rv.ec == std::errc::result_out_of_range)
+        return {ParseStatus::OutOfRange, pos};
+#else
+    // Accumulate the significant digits and scale by the exponent.
+    long double result{0};
+    long        scale{exponent};
+
+    for (size_t i = start; i < pos && (data[i] | 0x20) != 'e'; ++i)
+    {
+        if (data[i] != '.')
+            result = result * 10 + (data[i] - '0');
+    }
+    while (scale > 0 && result < std::numeric_limits<long double>::max() / 10)
+    {
+        result *= 10;
+        --scale;
+    }
+    while (scale < 0 && result > 0)
+    {
+        result /= 10;
+        ++scale;
+    }
+    if (   scale > 0
+        || result > std::numeric_limits<double>::max()
+        || (result > 0 && result < std::numeric_limits<double>::denorm_min() / 2))
+    {
+        return {ParseStatus::OutOfRange, pos};
+    }
+#endif
+
+    value = negative ? -static_cast<double>(result) : static_cast<double>(result);
+    return {ParseStatus::Ok, pos};
+}
+
+/// \brief  Write an integer in decimal to a buffer.
+/// \tparam T       An integer type of at most 64 bits.
+/// \param value    The integer to write.
+/// \param dst      Pointer to a buffer of at least max_integer_chars
+///                 characters.
+/// \return The number of characters written. No terminating NUL is written.
+/// \details    Digits are produced two at a time from a table of pairs.
+template <typename T>
+size_t format_integer(T value, char *dst) noexcept
+{
+    return detail::format_integer(value, dst, detail::format_decimal);
+}
+
+/// \brief  Write an integer in hexadecimal to a buffer.
+/// \tparam T       An integer type of at most 64 bits.
+/// \param value    The integer to write.
+/// \param dst      Pointer to a buffer of at least max_integer_chars
+///                 characters.
+/// \return The number of characters written. No terminating NUL is written.
+/// \details    The digits are lower case, without a \c 0x prefix. A negative
+///             value is written as a minus sign and its magnitude, which
+///             parse_hex() reads back.
+template <typename T>
+size_t format_hex(T value, char *dst) noexcept
+{
+    return detail::format_integer(value, dst, detail::format_hex_digits);
+}
+
+/// \brief  Write a floating-point number to a buffer.
+/// \param value    The number to write.
+/// \param dst      Pointer to a buffer of at least max_float_chars
+///                 characters.
+/// \return The number of characters written. No terminating NUL is written.
+/// \details    The number is written with \c std::to_chars, giving the
+///             shortest text that parse_float() reads back as the same
+///             value, with a period as the decimal point whatever the locale.
+///             Without a floating-point \c std::to_chars, seventeen
+///             significant digits are written with \c snprintf.
+inline size_t format_float(double value, char *dst) noexcept
+{
+#if defined(__cpp_lib_to_chars)
+    return static_cast<size_t>(std::to_chars(dst, dst + max_float_chars, value).ptr - dst);
+#else
+    char        buffer[max_float_chars + 8];
+    const int   length{std::snprintf(buffer, sizeof(buffer), "%.17g", value)};
+
+    // Replace the locale's decimal point, whatever it is, with a period.
+    for (int i = 0; i < length; ++i)
+    {
+        const int   ch{static_cast<unsigned char>(buffer[i])};
+
+        dst[i] = Ascii::is_alphanumeric(ch) || ch == '-' || ch == '+' ? buffer[i] : '.';
+    }
+
+    return static_cast<size_t>(length);
+#endif
+}
+
 }
 
 #endif  // BRACE_LIB_STRING_INC
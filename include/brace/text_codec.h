@@ -0,0 +1,486 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file text_codec.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_TEXT_CODEC_INC
+#define BRACE_LIB_TEXT_CODEC_INC
+
+#include <cstddef>
+#include <cstdint>
+
+#include "brace/byteorder.h"
+#include "brace/text_encoding.h"
+
+namespace brace {
+
+/// \cond
+namespace detail {
+
+constexpr bool is_surrogate(int cp) noexcept
+{
+    return cp >= 0xD800 && cp <= 0xDFFF;
+}
+
+}   // namespace detail
+/// \endcond
+
+// The codecs below are the non-virtual counterparts of the TextEncoding
+// classes. Every member is static, and any byte order or option is a
+// template argument, so a generic algorithm instantiated with a codec
+// inlines every call. Each codec provides:
+//
+//  static int decode(const unsigned char *p, size_t avail, size_t &used)
+//      Decode one character from p, which holds avail (> 0) bytes.
+//      Returns the code point and sets used, or returns
+//      DecodeResult::invalid or DecodeResult::incomplete. On invalid,
+//      used is set to the number of bytes to skip past the bad sequence.
+//
+//  static size_t encoded_length(int cp)
+//      The number of bytes needed to encode cp, or zero if cp
+//      cannot be encoded.
+//
+//  static void encode(int cp, unsigned char *p)
+//      Encode cp, which must be encodable, into p.
+//
+//  static size_t sequence_length(const unsigned char *p, size_t avail)
+//      The length of the sequence that starts at p, as announced by
+//      its first code unit, or zero if avail bytes are too few to
+//      tell. The sequence itself is not checked.
+//
+//  static constexpr size_t max_length
+//      The longest sequence the codec produces.
+
+/// \brief  Static codec for UTF-8.
+/// \details    Overlong forms, surrogates and values above U+10FFFF are
+///             rejected. An invalid sequence is skipped by its longest
+///             valid prefix, following the Unicode Standard's recommended
+///             practice.
+struct UTF8Codec
+{
+    static constexpr size_t max_length{4};
+
+    static int decode(const unsigned char *p, size_t avail, size_t &used) noexcept
+    {
+        const unsigned char b0{p[0]};
+
+        if (b0 < 0x80)
+        {
+            used = 1;
+            return b0;
+        }
+
+        size_t          n;
+        int             cp;
+        unsigned char   lo{0x80};
+        unsigned char   hi{0xBF};
+
+        if (b0 < 0xC2)
+        {
+            used = 1;
+            return DecodeResult::invalid;
+        }
+        else if (b0 < 0xE0)
+        {
+            n = 2;
+            cp = b0 & 0x1F;
+        }
+        else if (b0 < 0xF0)
+        {
+            n = 3;
+            cp = b0 & 0x0F;
+            if (b0 == 0xE0)
+                lo = 0xA0;
+            else if (b0 == 0xED)
+                hi = 0x9F;
+        }
+        else if (b0 < 0xF5)
+        {
+            n = 4;
+            cp = b0 & 0x07;
+            if (b0 == 0xF0)
+                lo = 0x90;
+            else if (b0 == 0xF4)
+                hi = 0x8F;
+        }
+        else
+        {
+            used = 1;
+            return DecodeResult::invalid;
+        }
+
+        // The second byte has a restricted range for some lead bytes;
+        // all remaining bytes must be plain continuation bytes.
+        for (size_t i = 1; i < n; ++i)
+        {
+            if (i == avail)
+                return DecodeResult::incomplete;
+
+            const unsigned char b{p[i]};
+
+            if (b < lo || b > hi)
+            {
+                used = i;
+                return DecodeResult::invalid;
+            }
+            cp = (cp << 6) | (b & 0x3F);
+            lo = 0x80;
+            hi = 0xBF;
+        }
+
+        used = n;
+        return cp;
+    }
+
+    static size_t encoded_length(int cp) noexcept
+    {
+        if (cp < 0)
+            return 0;
+        if (cp < 0x80)
+            return 1;
+        if (cp < 0x800)
+            return 2;
+        if (cp < 0x10000)
+            return detail::is_surrogate(cp) ? 0 : 3;
+        if (cp <= 0x10FFFF)
+            return 4;
+        return 0;
+    }
+
+    static void encode(int cp, unsigned char *p) noexcept
+    {
+        if (cp < 0x80)
+        {
+            *p = static_cast<unsigned char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+            *p++ = static_cast<unsigned char>(0xC0 | (cp >> 6));
+            *p   = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            *p++ = static_cast<unsigned char>(0xE0 | (cp >> 12));
+            *p++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *p   = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *p++ = static_cast<unsigned char>(0xF0 | (cp >> 18));
+            *p++ = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+            *p++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *p   = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    static size_t sequence_length(const unsigned char *p, size_t avail) noexcept
+    {
+        if (avail == 0)
+            return 0;
+        if (*p < 0xC0)
+            return 1;           // a single byte, or a stray continuation byte
+        if (*p < 0xE0)
+            return 2;
+        if (*p < 0xF0)
+            return 3;
+        if (*p < 0xF8)
+            return 4;
+        return 1;
+    }
+};
+
+/// \brief  Static codec for UTF-16 in a fixed byte order.
+/// \tparam E   The byte order of each code unit.
+/// \details    An unpaired surrogate is invalid, and is skipped as a
+///             single code unit.
+template <Endian E>
+struct UTF16Codec
+{
+    static constexpr size_t max_length{4};
+    static constexpr bool   big_endian{E == Endian::Big};
+
+    /// \brief  Read one code unit.
+    static int unit(const unsigned char *p) noexcept
+    {
+        return big_endian ? (p[0] << 8) | p[1]
+                          : (p[1] << 8) | p[0];
+    }
+
+    /// \brief  Write one code unit.
+    static void put_unit(int u, unsigned char *p) noexcept
+    {
+        const auto  hi{static_cast<unsigned char>(u >> 8)};
+        const auto  lo{static_cast<unsigned char>(u & 0xFF)};
+
+        p[0] = big_endian ? hi : lo;
+        p[1] = big_endian ? lo : hi;
+    }
+
+    static int decode(const unsigned char *p, size_t avail, size_t &used) noexcept
+    {
+        if (avail < 2)
+            return DecodeResult::incomplete;
+
+        const int   u1{unit(p)};
+
+        used = 2;
+        if (u1 < 0xD800 || u1 > 0xDFFF)
+            return u1;
+        if (u1 >= 0xDC00)
+            return DecodeResult::invalid;       // unpaired low surrogate
+        if (avail < 4)
+            return DecodeResult::incomplete;
+
+        const int   u2{unit(p + 2)};
+
+        if (u2 < 0xDC00 || u2 > 0xDFFF)
+            return DecodeResult::invalid;       // unpaired high surrogate
+
+        used = 4;
+        return (((u1 & 0x3FF) << 10) | (u2 & 0x3FF)) + 0x10000;
+    }
+
+    static size_t encoded_length(int cp) noexcept
+    {
+        if (cp < 0 || cp > 0x10FFFF || detail::is_surrogate(cp))
+            return 0;
+        return cp < 0x10000 ? 2 : 4;
+    }
+
+    static void encode(int cp, unsigned char *p) noexcept
+    {
+        if (cp < 0x10000)
+        {
+            put_unit(cp, p);
+        }
+        else
+        {
+            cp -= 0x10000;
+            put_unit(0xD800 | (cp >> 10), p);
+            put_unit(0xDC00 | (cp & 0x3FF), p + 2);
+        }
+    }
+
+    static size_t sequence_length(const unsigned char *p, size_t avail) noexcept
+    {
+        if (avail < 2)
+            return 0;
+
+        const int   u{unit(p)};
+
+        return (u >= 0xD800 && u < 0xDC00) ? 4 : 2;
+    }
+};
+
+/// \brief  Static codec for UTF-32 in a fixed byte order.
+/// \tparam E   The byte order of each code unit.
+template <Endian E>
+struct UTF32Codec
+{
+    static constexpr size_t max_length{4};
+    static constexpr bool   big_endian{E == Endian::Big};
+
+    static int decode(const unsigned char *p, size_t avail, size_t &used) noexcept
+    {
+        if (avail < 4)
+            return DecodeResult::incomplete;
+
+        const uint32_t  cp{big_endian ? (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3]
+                                      : (uint32_t{p[3]} << 24) | (uint32_t{p[2]} << 16) | (uint32_t{p[1]} << 8) | p[0]};
+
+        used = 4;
+        if (cp > 0x10FFFF || detail::is_surrogate(static_cast<int>(cp)))
+            return DecodeResult::invalid;
+
+        return static_cast<int>(cp);
+    }
+
+    static size_t encoded_length(int cp) noexcept
+    {
+        if (cp < 0 || cp > 0x10FFFF || detail::is_surrogate(cp))
+            return 0;
+        return 4;
+    }
+
+    static void encode(int cp, unsigned char *p) noexcept
+    {
+        const auto  u{static_cast<uint32_t>(cp)};
+
+        if constexpr (big_endian)
+        {
+            p[0] = static_cast<unsigned char>(u >> 24);
+            p[1] = static_cast<unsigned char>(u >> 16);
+            p[2] = static_cast<unsigned char>(u >> 8);
+            p[3] = static_cast<unsigned char>(u);
+        }
+        else
+        {
+            p[0] = static_cast<unsigned char>(u);
+            p[1] = static_cast<unsigned char>(u >> 8);
+            p[2] = static_cast<unsigned char>(u >> 16);
+            p[3] = static_cast<unsigned char>(u >> 24);
+        }
+    }
+
+    static size_t sequence_length(const unsigned char *, size_t) noexcept
+    {
+        return 4;
+    }
+};
+
+/// \brief  Static codec for ISO-8859-1.
+/// \tparam ControlsEnabled If \c false, the C0 and C1 control characters
+///                         and DEL are neither decoded nor encoded.
+template <bool ControlsEnabled = true>
+struct Latin1Codec
+{
+    static constexpr size_t max_length{1};
+    static constexpr bool   controls_enabled{ControlsEnabled};
+
+    static bool is_control(int ch) noexcept
+    {
+        return ch <= 0x1F || (ch >= 0x7F && ch <= 0x9F);
+    }
+
+    static int decode(const unsigned char *p, size_t, size_t &used) noexcept
+    {
+        used = 1;
+        if (!ControlsEnabled && is_control(*p))
+            return DecodeResult::invalid;
+
+        return *p;
+    }
+
+    static size_t encoded_length(int cp) noexcept
+    {
+        if (cp < 0 || cp > 0xFF)
+            return 0;
+        if (!ControlsEnabled && is_control(cp))
+            return 0;
+        return 1;
+    }
+
+    static void encode(int cp, unsigned char *p) noexcept
+    {
+        *p = static_cast<unsigned char>(cp);
+    }
+
+    static size_t sequence_length(const unsigned char *, size_t avail) noexcept
+    {
+        return avail == 0 ? 0 : 1;
+    }
+};
+
+/// \brief  Static codec for US-ASCII.
+struct ASCIICodec
+{
+    static constexpr size_t max_length{1};
+
+    static int decode(const unsigned char *p, size_t, size_t &used) noexcept
+    {
+        used = 1;
+        if (*p > 0x7F)
+            return DecodeResult::invalid;
+
+        return *p;
+    }
+
+    static size_t encoded_length(int cp) noexcept
+    {
+        return (cp >= 0 && cp <= 0x7F) ? 1 : 0;
+    }
+
+    static void encode(int cp, unsigned char *p) noexcept
+    {
+        *p = static_cast<unsigned char>(cp);
+    }
+
+    static size_t sequence_length(const unsigned char *, size_t avail) noexcept
+    {
+        return avail == 0 ? 0 : 1;
+    }
+};
+
+/// \brief  Decode the sequence at the start of a bounded byte sequence
+///         with a static codec.
+/// \tparam Codec   One of the codecs above.
+/// \param bytes    Pointer to a byte sequence.
+/// \param length   Number of bytes available at \p bytes.
+/// \return A DecodeResult, as returned by TextEncoding::decode_bounded().
+template <typename Codec>
+DecodeResult decode_sequence(const unsigned char *bytes, int length) noexcept
+{
+    if (length <= 0)
+        return {DecodeResult::incomplete, 0};
+
+    size_t      used{0};
+    const int   cp{Codec::decode(bytes, static_cast<size_t>(length), used)};
+
+    if (cp == DecodeResult::incomplete)
+        return {cp, length};
+
+    return {cp, static_cast<int>(used)};
+}
+
+/// \brief  Decode the sequence at the start of a byte sequence with a
+///         static codec, trusting the sequence to be complete.
+/// \tparam Codec   One of the codecs above.
+/// \param bytes    Pointer to a byte sequence.
+/// \return The Unicode scalar value, or DecodeResult::invalid, as returned
+///         by TextEncoding::decode(const unsigned char *).
+template <typename Codec>
+int decode_sequence(const unsigned char *bytes) noexcept
+{
+    size_t  used{0};
+
+    // No sequence is longer than max_length, so none is incomplete.
+    return Codec::decode(bytes, Codec::max_length, used);
+}
+
+/// \brief  Encode a code point into a bounded byte sequence with a static
+///         codec.
+/// \tparam Codec   One of the codecs above.
+/// \param cp       The code point to encode.
+/// \param bytes    Pointer to the bytes to encode into, or \c nullptr.
+/// \param length   Number of bytes available at \p bytes.
+/// \return The number of bytes the encoding of \p cp needs, or zero if
+///         \p cp cannot be encoded, as returned by TextEncoding::encode().
+///         The bytes are only written if all of them fit.
+template <typename Codec>
+int encode_sequence(int cp, unsigned char *bytes, int length) noexcept
+{
+    const size_t    n{Codec::encoded_length(cp)};
+
+    if (n != 0 && bytes != nullptr && length >= static_cast<int>(n))
+        Codec::encode(cp, bytes);
+
+    return static_cast<int>(n);
+}
+
+/// \brief  Determine the length of the sequence at the start of a bounded
+///         byte sequence with a static codec.
+/// \tparam Codec   One of the codecs above.
+/// \param bytes    Pointer to a byte sequence.
+/// \param length   Number of bytes available at \p bytes.
+/// \return The length announced by the first code unit, or -1 if there are
+///         too few bytes to tell, as returned by
+///         TextEncoding::sequence_length().
+template <typename Codec>
+int measure_sequence(const unsigned char *bytes, int length) noexcept
+{
+    const size_t    n{length > 0 ? Codec::sequence_length(bytes, static_cast<size_t>(length)) : 0};
+
+    return n == 0 ? -1 : static_cast<int>(n);
+}
+
+}
+
+#endif  // BRACE_LIB_TEXT_CODEC_INC
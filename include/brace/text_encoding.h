@@ -17,6 +17,34 @@
 #include <string_view>
 
 namespace brace {
+
+/// \brief  The result of decoding a single character from a bounded
+///         byte sequence.
+struct DecodeResult
+{
+    /// \brief  Value of \c code_point when the bytes do not begin with a
+    ///         valid sequence.
+    static constexpr int invalid    = -1;
+    /// \brief  Value of \c code_point when the bytes end before the
+    ///         sequence they begin is complete.
+    static constexpr int incomplete = -2;
+
+    /// \brief  The decoded Unicode scalar value, or \c invalid or \c incomplete.
+    int code_point;
+    /// \brief  The number of bytes consumed. When \c code_point is \c invalid
+    ///         this is the number of bytes to skip before decoding can resume
+    ///         (always at least one); when it is \c incomplete, it is the
+    ///         number of bytes that were available.
+    int length;
+
+    /// \brief  Determine if a character was decoded.
+    /// \return \c true if \c code_point holds a Unicode scalar value.
+    bool ok() const noexcept
+    {
+        return code_point >= 0;
+    }
+};
+
 class TextEncoding
 {
 public:
@@ -52,6 +80,37 @@ public:
         return static_cast<int>(*bytes);
     }
 
+    /// \brief  Decode the multi-byte sequence at the start of a bounded
+    ///         byte sequence to a Unicode scalar value.
+    /// \param bytes    Pointer to a byte sequence.
+    /// \param length   Number of bytes available at \p bytes.
+    /// \return A DecodeResult holding the Unicode scalar value and the
+    ///         number of bytes it occupied.
+    /// \details    Unlike decode(const unsigned char *), this never reads
+    ///             beyond \p length bytes. The default implementation is
+    ///             built on sequence_length() and decode(const unsigned char *);
+    ///             the encodings in this library override it to do both in
+    ///             a single pass.
+    virtual DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept
+    {
+        if (length <= 0)
+            return {DecodeResult::incomplete, 0};
+
+        const int   n{sequence_length(bytes, length)};
+
+        if (n <= 0)
+            return {DecodeResult::invalid, 1};
+        if (n > length)
+            return {DecodeResult::incomplete, length};
+
+        const int   cp{decode(bytes)};
+
+        if (cp < 0)
+            return {DecodeResult::invalid, n};
+
+        return {cp, n};
+    }
+
     /// \brief  Encode the Unicode character ch into a byte sequence.
     /// \param ch       Unicode character to encode.
     /// \param bytes    Pointer to sequence of bytes to encode into.
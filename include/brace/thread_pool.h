@@ -0,0 +1,371 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file thread_pool.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_THREAD_POOL_INC
+#define BRACE_LIB_THREAD_POOL_INC
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace brace {
+
+/// \brief  A work-stealing pool of threads.
+/// \details    Each worker thread owns a deque of tasks. A worker takes
+///             tasks from the back of its own deque, so the most recently
+///             split work stays in its cache, and when that is empty it
+///             steals from the front of the other workers' deques, where
+///             the largest pieces of work are. Tasks submitted from a
+///             worker go to that worker's deque; tasks submitted from any
+///             other thread are dealt round-robin across the deques.
+///
+///             A thread waiting in parallel_for() runs queued tasks while
+///             it waits, so parallel_for() may be nested inside tasks
+///             without deadlock. When there is nothing left to run it
+///             sleeps until the last of its subranges finishes.
+class ThreadPool
+{
+public:
+    /// \brief  Construct a pool and start its threads.
+    /// \param threads  Number of worker threads. If zero, one thread is
+    ///                 started.
+    explicit ThreadPool(size_t threads = default_thread_count())
+    {
+        if (threads == 0)
+            threads = 1;
+
+        _queues.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            _queues.push_back(std::make_unique<Queue>());
+
+        _threads.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            _threads.emplace_back([this, i] { work(i); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// \brief  Run any tasks still queued, then stop the threads.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{_sleep_mutex};
+
+            _stopping = true;
+        }
+        _wake.notify_all();
+
+        for (auto &thread : _threads)
+            thread.join();
+    }
+
+    /// \brief  Retrieve the number of worker threads.
+    size_t size() const noexcept
+    {
+        return _threads.size();
+    }
+
+    /// \brief  Retrieve the number of threads a pool starts by default.
+    /// \return The number of hardware threads, or one if that is unknown.
+    static size_t default_thread_count() noexcept
+    {
+        const unsigned  n{std::thread::hardware_concurrency()};
+
+        return n ? n : 1;
+    }
+
+    /// \brief  Retrieve the process-wide pool.
+    /// \details    The pool is created, with default_thread_count()
+    ///             threads, on the first call.
+    static ThreadPool &default_pool()
+    {
+        static ThreadPool   pool;
+
+        return pool;
+    }
+
+    /// \brief  Run a function on a worker thread.
+    /// \param fn   The function to run.
+    /// \param args Arguments to pass to \p fn. They are copied or moved
+    ///             into the task.
+    /// \return A future that receives the result of \p fn, or the exception
+    ///         it throws.
+    template <typename F, typename... Args>
+    auto submit(F &&fn, Args &&...args)
+            -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+    {
+        using result_type = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+        auto    task{std::make_shared<std::packaged_task<result_type()>>(
+                    [fn = std::forward<F>(fn), args = std::make_tuple(std::forward<Args>(args)...)]() mutable
+                    {
+                        return std::apply(std::move(fn), std::move(args));
+                    })};
+        auto    rv{task->get_future()};
+
+        push([task] { (*task)(); });
+        return rv;
+    }
+
+    /// \brief  Call a function over a range of indices, in parallel.
+    /// \param first    The first index.
+    /// \param last     One past the last index.
+    /// \param grain    The largest number of indices to pass in one call.
+    ///                 Ranges are split in halves until they are no larger,
+    ///                 so each call gets between <tt>grain / 2</tt> and
+    ///                 \p grain indices. Zero is taken as one.
+    /// \param fn       A function called as <tt>fn(begin, end)</tt> for
+    ///                 disjoint subranges that together cover \p first to
+    ///                 \p last, possibly from several threads at once.
+    /// \details    Returns when every call has returned. The calling thread
+    ///             takes part in the work. If a call throws, the remaining
+    ///             subranges are skipped and the first exception is
+    ///             rethrown here.
+    template <typename F>
+    void parallel_for(size_t first, size_t last, size_t grain, F &&fn)
+    {
+        if (first >= last)
+            return;
+
+        ParallelRange<std::remove_reference_t<F>>   range{*this, fn, grain ? grain : 1};
+
+        range.run(first, last);
+        while (range.outstanding.load(std::memory_order_acquire) != 0)
+        {
+            if (run_one())
+                continue;
+
+            // Nothing left to take; sleep until the last subrange finishes
+            // or more work is queued.
+            std::unique_lock<std::mutex>    lock{_sleep_mutex};
+
+            _wake.wait(lock, [this, &range]
+                       {
+                           return range.outstanding.load(std::memory_order_acquire) == 0
+                               || _pending.load(std::memory_order_acquire) != 0;
+                       });
+        }
+
+        if (range.error)
+            std::rethrow_exception(range.error);
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue
+    {
+        std::mutex          mutex;
+        std::deque<Task>    tasks;
+    };
+
+    // The pool and index of the worker running on this thread, if any.
+    struct Worker
+    {
+        const ThreadPool   *pool{nullptr};
+        size_t              index{0};
+    };
+
+    static Worker &this_worker() noexcept
+    {
+        thread_local Worker worker;
+
+        return worker;
+    }
+
+    template <typename F>
+    struct ParallelRange
+    {
+        ParallelRange(ThreadPool &pool, F &fn, size_t grain)
+          : pool{pool}
+          , fn{fn}
+          , grain{grain}
+        {}
+
+        // Split off the upper halves as tasks until the range is no
+        // larger than the grain, then run what is left.
+        void run(size_t begin, size_t end)
+        {
+            while (end - begin > grain)
+            {
+                const size_t    mid{begin + (end - begin) / 2};
+
+                outstanding.fetch_add(1, std::memory_order_relaxed);
+                pool.push([this, mid, end] { run(mid, end); });
+                end = mid;
+            }
+
+            if (!failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    fn(begin, end);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock{error_mutex};
+
+                    if (!error)
+                        error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            // The range may be destroyed as soon as this reaches zero, so
+            // keep the pool to wake the thread waiting in parallel_for().
+            ThreadPool &owner{pool};
+
+            if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                owner.wake_all();
+        }
+
+        ThreadPool             &pool;
+        F                      &fn;
+        size_t                  grain;
+        std::atomic<size_t>     outstanding{1};
+        std::atomic<bool>       failed{false};
+        std::mutex              error_mutex;
+        std::exception_ptr      error;
+    };
+
+    void push(Task task)
+    {
+        const Worker   &worker{this_worker()};
+        const size_t    index{worker.pool == this ? worker.index
+                                                  : _next.fetch_add(1, std::memory_order_relaxed) % _queues.size()};
+
+        // Count the task before it can be taken, so that _pending is never
+        // less than the number of queued tasks.
+        _pending.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock{_queues[index]->mutex};
+
+            _queues[index]->tasks.push_back(std::move(task));
+        }
+
+        // Taking the lock orders this with a worker about to sleep.
+        {
+            std::lock_guard<std::mutex> lock{_sleep_mutex};
+        }
+        _wake.notify_one();
+    }
+
+    void wake_all()
+    {
+        {
+            std::lock_guard<std::mutex> lock{_sleep_mutex};
+        }
+        _wake.notify_all();
+    }
+
+    // Take a task from the back of our own deque, or else from the front
+    // of another. A thread outside the pool passes an index past the last
+    // deque, and steals from them all.
+    bool try_pop(size_t self, Task &task)
+    {
+        const size_t    n{_queues.size()};
+        const bool      own{self < n};
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            Queue  &queue{*_queues[((own ? self : 0) + k) % n]};
+
+            std::lock_guard<std::mutex> lock{queue.mutex};
+
+            if (!queue.tasks.empty())
+            {
+                if (own && k == 0)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Run one queued task on the calling thread, if there is one.
+    bool run_one()
+    {
+        const Worker   &worker{this_worker()};
+        Task            task;
+
+        if (!try_pop(worker.pool == this ? worker.index : _queues.size(), task))
+            return false;
+        task();
+        return true;
+    }
+
+    void work(size_t index)
+    {
+        this_worker() = Worker{this, index};
+
+        for (;;)
+        {
+            Task    task;
+
+            if (try_pop(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex>    lock{_sleep_mutex};
+
+            _wake.wait(lock, [this] { return _stopping || _pending.load(std::memory_order_acquire) != 0; });
+            if (_stopping && _pending.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread>            _threads;
+    std::atomic<size_t>                 _pending{0};
+    std::atomic<size_t>                 _next{0};
+    std::mutex                          _sleep_mutex;
+    std::condition_variable             _wake;
+    bool                                _stopping{false};
+};
+
+/// \brief  Call a function over a range of indices, in parallel on the
+///         default pool.
+/// \see    ThreadPool::parallel_for
+template <typename F>
+void parallel_for(size_t first, size_t last, size_t grain, F &&fn)
+{
+    ThreadPool::default_pool().parallel_for(first, last, grain, std::forward<F>(fn));
+}
+
+}
+
+#endif  // BRACE_LIB_THREAD_POOL_INC
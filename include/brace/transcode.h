@@ -0,0 +1,1218 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file transcode.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_TRANSCODE_INC
+#define BRACE_LIB_TRANSCODE_INC
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <typeinfo>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "brace/ascii_encoding.h"
+#include "brace/bits.h"
+#include "brace/latin1_encoding.h"
+#include "brace/text_codec.h"
+#include "brace/text_encoding.h"
+#include "brace/utf8_encoding.h"
+#include "brace/utf16_encoding.h"
+#include "brace/utf32_encoding.h"
+
+namespace brace {
+
+/// \brief  Indicates the outcome of a transcoding operation.
+enum class TranscodeStatus
+{
+    /// \brief  All of the source bytes were converted.
+    Ok,
+    /// \brief  The source contains a byte sequence that is not valid
+    ///         in the source encoding.
+    InvalidSequence,
+    /// \brief  The source ends in the middle of a multi-byte sequence.
+    IncompleteSequence,
+    /// \brief  The source contains a character that cannot be represented
+    ///         in the destination encoding.
+    Unencodable,
+    /// \brief  The destination buffer is too small to hold the next character.
+    OutputFull
+};
+
+/// \brief  Selects what a conversion does when it meets invalid input.
+enum class ErrorHandling
+{
+    /// \brief  Stop at the first invalid or incomplete sequence.
+    Stop,
+    /// \brief  Substitute U+FFFD REPLACEMENT CHARACTER for each invalid or
+    ///         incomplete sequence and continue.
+    Replace
+};
+
+/// \brief  The result of a transcoding operation.
+struct TranscodeResult
+{
+    /// \brief  Value of \c error_offset when no error occurred.
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /// \brief  Outcome of the operation.
+    TranscodeStatus status;
+    /// \brief  Number of source bytes consumed.
+    size_t          bytes_read;
+    /// \brief  Number of bytes written to the destination buffer.
+    size_t          bytes_written;
+    /// \brief  Offset within the source of the first offending sequence, or
+    ///         \c npos if the source was converted without error.
+    size_t          error_offset;
+
+    /// \brief  Determine if the operation completed successfully.
+    /// \return \c true if all of the source bytes were converted.
+    bool ok() const noexcept
+    {
+        return status == TranscodeStatus::Ok;
+    }
+};
+
+/// \cond
+namespace detail {
+
+// Values returned by the kernel decode functions when the input
+// does not begin with a complete, valid sequence.
+constexpr int decode_invalid{DecodeResult::invalid};
+constexpr int decode_incomplete{DecodeResult::incomplete};
+
+// A kernel is one of the static codecs in text_codec.h, or VirtualKernel,
+// which presents any other TextEncoding through the same interface. The
+// transcode_kernel template combines any two of them into a conversion
+// loop in which every call can be inlined, and the overloads that follow
+// it replace that loop with specialized ones for particular pairings.
+
+// Adapts any other TextEncoding through its virtual interface.
+struct VirtualKernel
+{
+    explicit VirtualKernel(const TextEncoding &enc) noexcept
+      : _enc{enc}
+    {}
+
+    int decode(const unsigned char *p, size_t avail, size_t &used) const noexcept
+    {
+        const int   len{avail > INT_MAX ? INT_MAX : static_cast<int>(avail)};
+        const auto  rv{_enc.decode_bounded(p, len)};
+
+        used = static_cast<size_t>(rv.length);
+        return rv.code_point;
+    }
+
+    size_t encoded_length(int cp) const noexcept
+    {
+        const int   n{_enc.encode(cp, nullptr, 0)};
+
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    void encode(int cp, unsigned char *p) const noexcept
+    {
+        _enc.encode(cp, p, static_cast<int>(encoded_length(cp)));
+    }
+
+    const TextEncoding &_enc;
+};
+
+// Convert the single character at in[i] and advance i and o past it.
+template <typename SrcKernel, typename DstKernel>
+TranscodeStatus transcode_step(const SrcKernel &src, const unsigned char *in, size_t in_length, size_t &i,
+                               const DstKernel &dst, unsigned char *out, size_t out_length, size_t &o) noexcept
+{
+    size_t  used;
+    int     cp{src.decode(in + i, in_length - i, used)};
+
+    if (cp < 0)
+        return cp == decode_incomplete ? TranscodeStatus::IncompleteSequence
+                                       : TranscodeStatus::InvalidSequence;
+
+    size_t  n{dst.encoded_length(cp)};
+
+    if (n == 0)
+        return TranscodeStatus::Unencodable;
+    if (out_length - o < n)
+        return TranscodeStatus::OutputFull;
+
+    dst.encode(cp, out + o);
+    i += used;
+    o += n;
+
+    return TranscodeStatus::Ok;
+}
+
+inline TranscodeResult make_result(TranscodeStatus status, size_t bytes_read, size_t bytes_written) noexcept
+{
+    const bool  is_error{status != TranscodeStatus::Ok && status != TranscodeStatus::OutputFull};
+
+    return {status, bytes_read, bytes_written, is_error ? bytes_read : TranscodeResult::npos};
+}
+
+template <typename SrcKernel, typename DstKernel>
+TranscodeResult transcode_kernel(const SrcKernel &src, const unsigned char *in, size_t in_length,
+                                 const DstKernel &dst, unsigned char *out, size_t out_length) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+    while (i < in_length)
+    {
+        auto    status{transcode_step(src, in, in_length, i, dst, out, out_length, o)};
+
+        if (status != TranscodeStatus::Ok)
+            return make_result(status, i, o);
+    }
+
+    return make_result(TranscodeStatus::Ok, i, o);
+}
+
+// Conversions between encodings that share a byte layout reduce to
+// validating the input and copying it.
+template <typename Kernel>
+TranscodeResult transcode_copy(const Kernel &src, const unsigned char *in, size_t in_length,
+                               unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    limit{in_length < out_length ? in_length : out_length};
+    size_t          i{0};
+    TranscodeResult rv{TranscodeStatus::Ok, 0, 0, TranscodeResult::npos};
+
+    while (i < in_length)
+    {
+        size_t  used;
+        int     cp{src.decode(in + i, in_length - i, used)};
+
+        if (cp < 0)
+        {
+            rv = {cp == decode_incomplete ? TranscodeStatus::IncompleteSequence
+                                          : TranscodeStatus::InvalidSequence,
+                  i, i, i};
+            break;
+        }
+        if (i + used > limit)
+        {
+            rv = {TranscodeStatus::OutputFull, i, i, TranscodeResult::npos};
+            break;
+        }
+        i += used;
+    }
+
+    if (rv.ok())
+        rv.bytes_read = rv.bytes_written = i;
+
+    std::memcpy(out, in, rv.bytes_written);
+    return rv;
+}
+
+inline TranscodeResult transcode_kernel(const UTF8Codec &src, const unsigned char *in, size_t in_length,
+                                        const UTF8Codec &, unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    limit{in_length < out_length ? in_length : out_length};
+    const size_t    valid{UTF8Encoding::find_invalid(in, limit)};
+    TranscodeResult rv{TranscodeStatus::Ok, valid, valid, TranscodeResult::npos};
+
+    if (valid < in_length)
+    {
+        // Either the input is bad at this point, or the character
+        // there is valid but does not fit in the output.
+        size_t  used;
+        int     cp{src.decode(in + valid, in_length - valid, used)};
+
+        if (cp >= 0)
+        {
+            rv.status = TranscodeStatus::OutputFull;
+        }
+        else
+        {
+            rv.status = cp == decode_incomplete ? TranscodeStatus::IncompleteSequence
+                                                : TranscodeStatus::InvalidSequence;
+            rv.error_offset = valid;
+        }
+    }
+
+    std::memcpy(out, in, valid);
+    return rv;
+}
+
+// Copy ASCII text to an encoding in which ASCII is represented unchanged.
+inline TranscodeResult ascii_copy(const unsigned char *in, size_t in_length,
+                                  unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    limit{in_length < out_length ? in_length : out_length};
+    const size_t    valid{ASCIIEncoding::find_invalid(in, limit)};
+
+    std::memcpy(out, in, valid);
+    if (valid < limit || (limit < in_length && in[limit] > 0x7F))
+        return make_result(TranscodeStatus::InvalidSequence, valid, valid);
+
+    return make_result(limit < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, limit, limit);
+}
+
+inline TranscodeResult transcode_kernel(const ASCIICodec &, const unsigned char *in, size_t in_length,
+                                        const ASCIICodec &, unsigned char *out, size_t out_length) noexcept
+{
+    return ascii_copy(in, in_length, out, out_length);
+}
+
+inline TranscodeResult transcode_kernel(const ASCIICodec &, const unsigned char *in, size_t in_length,
+                                        const UTF8Codec &, unsigned char *out, size_t out_length) noexcept
+{
+    return ascii_copy(in, in_length, out, out_length);
+}
+
+inline TranscodeResult transcode_kernel(const ASCIICodec &, const unsigned char *in, size_t in_length,
+                                        const Latin1Codec<true> &, unsigned char *out, size_t out_length) noexcept
+{
+    return ascii_copy(in, in_length, out, out_length);
+}
+
+template <bool SrcControls, bool DstControls>
+TranscodeResult transcode_kernel(const Latin1Codec<SrcControls> &src, const unsigned char *in, size_t in_length,
+                                 const Latin1Codec<DstControls> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    if constexpr (SrcControls && !DstControls)
+        return transcode_kernel<Latin1Codec<SrcControls>, Latin1Codec<DstControls>>(src, in, in_length,
+                                                                                     dst, out, out_length);
+    else
+        return transcode_copy(src, in, in_length, out, out_length);
+}
+
+// UTF-16 or UTF-32 to the same encoding in the same byte order validates
+// and copies. Between byte orders the generic loop is used.
+template <Endian E>
+TranscodeResult transcode_kernel(const UTF16Codec<E> &src, const unsigned char *in, size_t in_length,
+                                 const UTF16Codec<E> &, unsigned char *out, size_t out_length) noexcept
+{
+    return transcode_copy(src, in, in_length, out, out_length);
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const UTF32Codec<E> &src, const unsigned char *in, size_t in_length,
+                                 const UTF32Codec<E> &, unsigned char *out, size_t out_length) noexcept
+{
+    return transcode_copy(src, in, in_length, out, out_length);
+}
+
+// Vectorized UTF-8 <-> UTF-16 conversion.
+//
+// Each helper below converts as many leading characters of one simple
+// shape as it can (a run of ASCII, or a run of characters that all take
+// two bytes in UTF-8) and returns how many it converted, leaving anything
+// else to the scalar kernels. None of the characters they accept can be
+// part of a surrogate pair, so surrogate validation is always done by
+// UTF16Codec::decode. Vector stores may write past the converted
+// characters, but never past the end of the output buffer.
+
+#if defined(__SSE2__) || defined(_M_X64)
+inline __m128i swap_bytes16(__m128i v) noexcept
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+#if defined(__AVX2__)
+inline __m256i swap_bytes16(__m256i v) noexcept
+{
+    return _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+}
+#endif
+
+// Widen leading bytes to UTF-16, stopping at the first byte above 0x7F
+// if ascii_only is set. Returns the number of bytes converted.
+inline size_t widen_to_utf16(const unsigned char *in, size_t in_length,
+                             unsigned char *out, size_t out_length, bool big, bool ascii_only) noexcept
+{
+    const size_t    limit{in_length < out_length / 2 ? in_length : out_length / 2};
+    size_t          i{0};
+
+#if defined(__AVX2__)
+    for (; i + 32 <= limit; i += 32)
+    {
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i))};
+        const unsigned  mask{static_cast<unsigned>(_mm256_movemask_epi8(v))};
+        __m256i         lo{_mm256_cvtepu8_epi16(_mm256_castsi256_si128(v))};
+        __m256i         hi{_mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1))};
+
+        if (big)
+        {
+            lo = swap_bytes16(lo);
+            hi = swap_bytes16(hi);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i + 32), hi);
+        if (ascii_only && mask)
+            return i + static_cast<size_t>(countr_zero(mask));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i   zero{_mm_setzero_si128()};
+
+    for (; i + 16 <= limit; i += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const unsigned  mask{static_cast<unsigned>(_mm_movemask_epi8(v))};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i),
+                         big ? _mm_unpacklo_epi8(zero, v) : _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i + 16),
+                         big ? _mm_unpackhi_epi8(zero, v) : _mm_unpackhi_epi8(v, zero));
+        if (ascii_only && mask)
+            return i + static_cast<size_t>(countr_zero(mask));
+    }
+#endif
+
+    for (; i < limit && (!ascii_only || in[i] < 0x80); ++i)
+    {
+        out[2 * i]     = big ? 0 : in[i];
+        out[2 * i + 1] = big ? in[i] : 0;
+    }
+
+    return i;
+}
+
+// Convert leading two-byte UTF-8 sequences (U+0080 to U+07FF), eight at a
+// time, to UTF-16. Returns the number of characters converted.
+inline size_t utf8_two_byte_to_utf16(const unsigned char *in, size_t in_length,
+                                     unsigned char *out, size_t out_length, bool big) noexcept
+{
+    const size_t    limit{in_length < out_length ? in_length : out_length};
+    size_t          i{0};
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // Viewed as little-endian 16-bit lanes, each sequence is lead | cont << 8.
+    const __m128i   shape_mask{_mm_set1_epi16(static_cast<short>(0xC0E0))};
+    const __m128i   shape{_mm_set1_epi16(static_cast<short>(0x80C0))};
+    const __m128i   overlong_mask{_mm_set1_epi16(0x001E)};
+    const __m128i   zero{_mm_setzero_si128()};
+
+    for (; i + 16 <= limit; i += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const __m128i   ok{_mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(v, overlong_mask), zero),
+                                            _mm_cmpeq_epi16(_mm_and_si128(v, shape_mask), shape))};
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+            break;
+
+        __m128i units{_mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x001F)), 6),
+                                   _mm_and_si128(_mm_srli_epi16(v, 8), _mm_set1_epi16(0x003F)))};
+
+        if (big)
+            units = swap_bytes16(units);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), units);
+    }
+#endif
+
+    return i / 2;
+}
+
+// Narrow leading ASCII UTF-16 code units to UTF-8. Returns the number of
+// code units converted.
+inline size_t utf16_ascii_to_utf8(const unsigned char *in, size_t in_length,
+                                  unsigned char *out, size_t out_length, bool big) noexcept
+{
+    const size_t    units{in_length / 2};
+    const size_t    limit{units < out_length ? units : out_length};
+    size_t          i{0};
+
+#if defined(__AVX2__)
+    const __m256i   non_ascii32{_mm256_set1_epi16(static_cast<short>(0xFF80))};
+
+    for (; i + 32 <= limit; i += 32)
+    {
+        __m256i a{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 2 * i))};
+        __m256i b{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 2 * i + 32))};
+
+        if (big)
+        {
+            a = swap_bytes16(a);
+            b = swap_bytes16(b);
+        }
+
+        const __m256i   ascii{_mm256_packs_epi16(_mm256_cmpeq_epi16(_mm256_and_si256(a, non_ascii32), _mm256_setzero_si256()),
+                                                 _mm256_cmpeq_epi16(_mm256_and_si256(b, non_ascii32), _mm256_setzero_si256()))};
+        const unsigned  mask{static_cast<unsigned>(_mm256_movemask_epi8(_mm256_permute4x64_epi64(ascii, 0xD8)))};
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+        if (mask != 0xFFFFFFFF)
+            return i + static_cast<size_t>(countr_zero(~mask));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i   non_ascii{_mm_set1_epi16(static_cast<short>(0xFF80))};
+    const __m128i   zero{_mm_setzero_si128()};
+
+    for (; i + 16 <= limit; i += 16)
+    {
+        __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i))};
+        __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i + 16))};
+
+        if (big)
+        {
+            a = swap_bytes16(a);
+            b = swap_bytes16(b);
+        }
+
+        const unsigned  mask{static_cast<unsigned>(_mm_movemask_epi8(
+                                _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(a, non_ascii), zero),
+                                                _mm_cmpeq_epi16(_mm_and_si128(b, non_ascii), zero))))};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(a, b));
+        if (mask != 0xFFFF)
+            return i + static_cast<size_t>(countr_zero(~mask));
+    }
+#endif
+
+    for (; i < limit; ++i)
+    {
+        const unsigned char hi{in[2 * i + (big ? 0 : 1)]};
+        const unsigned char lo{in[2 * i + (big ? 1 : 0)]};
+
+        if (hi != 0 || lo >= 0x80)
+            break;
+        out[i] = lo;
+    }
+
+    return i;
+}
+
+// Convert leading UTF-16 code units in the range U+0080 to U+07FF, which
+// take exactly two bytes each in UTF-8. Returns the number of code units
+// converted.
+inline size_t utf16_two_byte_to_utf8(const unsigned char *in, size_t in_length,
+                                     unsigned char *out, size_t out_length, bool big) noexcept
+{
+    const size_t    units{in_length / 2};
+    const size_t    limit{units < out_length / 2 ? units : out_length / 2};
+    size_t          i{0};
+
+#if defined(__AVX2__)
+    for (; i + 16 <= limit; i += 16)
+    {
+        __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 2 * i))};
+
+        if (big)
+            v = swap_bytes16(v);
+
+        const __m256i   zero{_mm256_setzero_si256()};
+        const __m256i   ok{_mm256_andnot_si256(
+                                _mm256_cmpeq_epi16(_mm256_and_si256(v, _mm256_set1_epi16(static_cast<short>(0xFF80))), zero),
+                                _mm256_cmpeq_epi16(_mm256_and_si256(v, _mm256_set1_epi16(static_cast<short>(0xF800))), zero))};
+
+        if (static_cast<unsigned>(_mm256_movemask_epi8(ok)) != 0xFFFFFFFF)
+            break;
+
+        // Lead byte in the low half of each lane, continuation byte in the high.
+        const __m256i   lead{_mm256_or_si256(_mm256_srli_epi16(v, 6), _mm256_set1_epi16(0x00C0))};
+        const __m256i   cont{_mm256_or_si256(_mm256_and_si256(v, _mm256_set1_epi16(0x003F)), _mm256_set1_epi16(0x0080))};
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i),
+                            _mm256_or_si256(lead, _mm256_slli_epi16(cont, 8)));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i   zero{_mm_setzero_si128()};
+
+    for (; i + 8 <= limit; i += 8)
+    {
+        __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i))};
+
+        if (big)
+            v = swap_bytes16(v);
+
+        const __m128i   ok{_mm_andnot_si128(
+                                _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), zero),
+                                _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800))), zero))};
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+            break;
+
+        const __m128i   lead{_mm_or_si128(_mm_srli_epi16(v, 6), _mm_set1_epi16(0x00C0))};
+        const __m128i   cont{_mm_or_si128(_mm_and_si128(v, _mm_set1_epi16(0x003F)), _mm_set1_epi16(0x0080))};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i),
+                         _mm_or_si128(lead, _mm_slli_epi16(cont, 8)));
+    }
+#endif
+
+    return i;
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const UTF8Codec &src, const unsigned char *in, size_t in_length,
+                                 const UTF16Codec<E> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+    while (i < in_length)
+    {
+        size_t  n{widen_to_utf16(in + i, in_length - i, out + o, out_length - o, dst.big_endian, true)};
+
+        i += n;
+        o += 2 * n;
+
+        n = utf8_two_byte_to_utf16(in + i, in_length - i, out + o, out_length - o, dst.big_endian);
+        i += 2 * n;
+        o += 2 * n;
+
+        if (i == in_length)
+            break;
+
+        // Convert one character, then keep going while the text stays in
+        // the three- and four-byte range where the vector paths don't apply.
+        do
+        {
+            auto    status{transcode_step(src, in, in_length, i, dst, out, out_length, o)};
+
+            if (status != TranscodeStatus::Ok)
+                return make_result(status, i, o);
+        } while (i < in_length && in[i] >= 0xE0);
+    }
+
+    return make_result(TranscodeStatus::Ok, i, o);
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const UTF16Codec<E> &src, const unsigned char *in, size_t in_length,
+                                 const UTF8Codec &dst, unsigned char *out, size_t out_length) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+    while (i < in_length)
+    {
+        size_t  n{utf16_ascii_to_utf8(in + i, in_length - i, out + o, out_length - o, src.big_endian)};
+
+        i += 2 * n;
+        o += n;
+
+        n = utf16_two_byte_to_utf8(in + i, in_length - i, out + o, out_length - o, src.big_endian);
+        i += 2 * n;
+        o += 2 * n;
+
+        if (i == in_length)
+            break;
+
+        do
+        {
+            auto    status{transcode_step(src, in, in_length, i, dst, out, out_length, o)};
+
+            if (status != TranscodeStatus::Ok)
+                return make_result(status, i, o);
+        } while (in_length - i >= 2 && src.unit(in + i) >= 0x800);
+    }
+
+    return make_result(TranscodeStatus::Ok, i, o);
+}
+
+// Vectorized Latin-1 and ASCII conversion.
+//
+// Every Latin-1 byte is a code point, and every ASCII byte is the same
+// code point as in Latin-1, so converting either to UTF-16 or UTF-32 is
+// a plain widening. Latin-1 to UTF-8 expands each byte above 0x7F into
+// two bytes, and UTF-8 to Latin-1 reverses that; with SSSE3 both are
+// done eight bytes at a time, using a shuffle chosen by the mask of
+// bytes that expand or are removed.
+
+// Widen leading bytes to UTF-32, stopping at the first byte above 0x7F
+// if ascii_only is set. Returns the number of bytes converted.
+inline size_t widen_to_utf32(const unsigned char *in, size_t in_length,
+                             unsigned char *out, size_t out_length, bool big, bool ascii_only) noexcept
+{
+    const size_t    limit{in_length < out_length / 4 ? in_length : out_length / 4};
+    size_t          i{0};
+
+#if defined(__AVX2__)
+    for (; i + 16 <= limit; i += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const unsigned  mask{static_cast<unsigned>(_mm_movemask_epi8(v))};
+        __m256i         lo{_mm256_cvtepu8_epi32(v)};
+        __m256i         hi{_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8))};
+
+        if (big)
+        {
+            lo = _mm256_slli_epi32(lo, 24);
+            hi = _mm256_slli_epi32(hi, 24);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i + 32), hi);
+        if (ascii_only && mask)
+            return i + static_cast<size_t>(countr_zero(mask));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i   zero{_mm_setzero_si128()};
+
+    for (; i + 16 <= limit; i += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const unsigned  mask{static_cast<unsigned>(_mm_movemask_epi8(v))};
+        const __m128i   lo{_mm_unpacklo_epi8(v, zero)};
+        const __m128i   hi{_mm_unpackhi_epi8(v, zero)};
+        __m128i         w[4] {
+            _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+        };
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (big)
+                w[k] = _mm_slli_epi32(w[k], 24);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * i + 16 * k), w[k]);
+        }
+        if (ascii_only && mask)
+            return i + static_cast<size_t>(countr_zero(mask));
+    }
+#endif
+
+    for (; i < limit && (!ascii_only || in[i] < 0x80); ++i)
+    {
+        unsigned char  *p{out + 4 * i};
+
+        p[0] = big ? 0 : in[i];
+        p[1] = 0;
+        p[2] = 0;
+        p[3] = big ? in[i] : 0;
+    }
+
+    return i;
+}
+
+#if defined(__SSSE3__)
+// Shuffles that pack or unpack eight bytes according to an 8-bit mask.
+struct ByteShuffleTable
+{
+    uint8_t shuffle[256][16];
+    uint8_t length[256];
+};
+
+// For each mask of bytes above 0x7F, gather the low byte of every 16-bit
+// lane, and the high byte too where the mask bit is set.
+constexpr ByteShuffleTable make_expand_table() noexcept
+{
+    ByteShuffleTable    table{};
+
+    for (int m = 0; m < 256; ++m)
+    {
+        int k{0};
+
+        for (int i = 0; i < 8; ++i)
+        {
+            table.shuffle[m][k++] = static_cast<uint8_t>(2 * i);
+            if (m & (1 << i))
+                table.shuffle[m][k++] = static_cast<uint8_t>(2 * i + 1);
+        }
+        table.length[m] = static_cast<uint8_t>(k);
+        while (k < 16)
+            table.shuffle[m][k++] = 0x80;
+    }
+
+    return table;
+}
+
+// For each mask of bytes to be removed, gather the remaining bytes.
+constexpr ByteShuffleTable make_compress_table() noexcept
+{
+    ByteShuffleTable    table{};
+
+    for (int m = 0; m < 256; ++m)
+    {
+        int k{0};
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (!(m & (1 << i)))
+                table.shuffle[m][k++] = static_cast<uint8_t>(i);
+        }
+        table.length[m] = static_cast<uint8_t>(k);
+        while (k < 16)
+            table.shuffle[m][k++] = 0x80;
+    }
+
+    return table;
+}
+
+inline constexpr ByteShuffleTable   expand_table{make_expand_table()};
+inline constexpr ByteShuffleTable   compress_table{make_compress_table()};
+
+inline __m128i load_shuffle(const ByteShuffleTable &table, unsigned mask) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.shuffle[mask]));
+}
+#endif
+
+// Convert Latin-1 to UTF-8 until the input is exhausted or the output
+// is full. Returns the number of bytes read and sets written.
+inline size_t latin1_to_utf8(const unsigned char *in, size_t in_length,
+                             unsigned char *out, size_t out_length, size_t &written) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 16 <= in_length && o + 32 <= out_length; i += 16)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const unsigned  mask{static_cast<unsigned>(_mm_movemask_epi8(v))};
+
+        if (mask == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + o), v);
+            o += 16;
+            continue;
+        }
+#if defined(__SSSE3__)
+        const __m128i   zero{_mm_setzero_si128()};
+        const __m128i   halves[2] {_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero)};
+
+        for (int h = 0; h < 2; ++h)
+        {
+            // Each 16-bit lane holds either the ASCII byte, or the lead
+            // byte followed by the continuation byte.
+            const __m128i   w{halves[h]};
+            const __m128i   lead{_mm_or_si128(_mm_srli_epi16(w, 6), _mm_set1_epi16(0x00C0))};
+            const __m128i   cont{_mm_or_si128(_mm_and_si128(w, _mm_set1_epi16(0x003F)), _mm_set1_epi16(0x0080))};
+            const __m128i   ascii{_mm_cmplt_epi16(w, _mm_set1_epi16(0x0080))};
+            const __m128i   lanes{_mm_or_si128(_mm_and_si128(ascii, w),
+                                               _mm_andnot_si128(ascii, _mm_or_si128(lead, _mm_slli_epi16(cont, 8))))};
+            const unsigned  m{(mask >> (8 * h)) & 0xFF};
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + o),
+                             _mm_shuffle_epi8(lanes, load_shuffle(expand_table, m)));
+            o += expand_table.length[m];
+        }
+#else
+        // Without SSSE3, convert this block a byte at a time and return to
+        // the vector loop for the next one.
+        for (size_t j = i; j < i + 16; ++j)
+        {
+            const unsigned char b{in[j]};
+
+            if (b < 0x80)
+            {
+                out[o++] = b;
+            }
+            else
+            {
+                out[o++] = static_cast<unsigned char>(0xC0 | (b >> 6));
+                out[o++] = static_cast<unsigned char>(0x80 | (b & 0x3F));
+            }
+        }
+#endif
+    }
+#endif
+
+    for (; i < in_length; ++i)
+    {
+        const unsigned char b{in[i]};
+
+        if (b < 0x80)
+        {
+            if (o == out_length)
+                break;
+            out[o++] = b;
+        }
+        else
+        {
+            if (out_length - o < 2)
+                break;
+            out[o++] = static_cast<unsigned char>(0xC0 | (b >> 6));
+            out[o++] = static_cast<unsigned char>(0x80 | (b & 0x3F));
+        }
+    }
+
+    written = o;
+    return i;
+}
+
+// Convert leading 16-byte blocks of UTF-8 that hold only ASCII and
+// two-byte sequences for U+0080 to U+00FF, none of them split across
+// blocks, to Latin-1. Returns the number of bytes read and sets written.
+inline size_t utf8_to_latin1_blocks(const unsigned char *in, size_t in_length,
+                                    unsigned char *out, size_t out_length, size_t &written) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+#if defined(__SSE2__) || defined(_M_X64)
+    while (i + 16 <= in_length && o + 16 <= out_length)
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))};
+        const unsigned  high{static_cast<unsigned>(_mm_movemask_epi8(v))};
+
+        if (high == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + o), v);
+            i += 16;
+            o += 16;
+            continue;
+        }
+#if defined(__SSSE3__)
+        const __m128i   cont_bytes{_mm_cmplt_epi8(v, _mm_set1_epi8(-64))};
+        const unsigned  cont{static_cast<unsigned>(_mm_movemask_epi8(cont_bytes))};
+        const unsigned  lead{static_cast<unsigned>(_mm_movemask_epi8(
+                            _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(static_cast<char>(0xFE))),
+                                           _mm_set1_epi8(static_cast<char>(0xC2)))))};
+
+        // A lead byte in the last position is left for the next block.
+        const size_t    block{(lead & 0x8000) ? size_t{15} : size_t{16}};
+        const unsigned  in_block{(lead & 0x8000) ? 0x7FFFU : 0xFFFFU};
+
+        // Every byte above 0x7F must be a C2 or C3 lead byte immediately
+        // followed by a continuation byte within the block.
+        if (   (high & in_block) != ((lead | cont) & in_block)
+            || (cont & in_block) != ((lead << 1) & 0xFFFF))
+        {
+            break;
+        }
+
+        // Combine each continuation byte with the two payload bits of the
+        // lead byte before it, then squeeze out the lead bytes.
+        const __m128i   prev{_mm_slli_si128(v, 1)};
+        const __m128i   value{_mm_or_si128(_mm_slli_epi16(_mm_and_si128(prev, _mm_set1_epi8(0x03)), 6),
+                                           _mm_and_si128(v, _mm_set1_epi8(0x3F)))};
+        const __m128i   bytes{_mm_or_si128(_mm_and_si128(cont_bytes, value), _mm_andnot_si128(cont_bytes, v))};
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + o),
+                         _mm_shuffle_epi8(bytes, load_shuffle(compress_table, lead & 0xFF)));
+        o += compress_table.length[lead & 0xFF];
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + o),
+                         _mm_shuffle_epi8(_mm_srli_si128(bytes, 8), load_shuffle(compress_table, lead >> 8)));
+        o += compress_table.length[lead >> 8];
+        i += block;
+#else
+        break;
+#endif
+    }
+#endif
+
+    written = o;
+    return i;
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const ASCIICodec &, const unsigned char *in, size_t in_length,
+                                 const UTF16Codec<E> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    n{widen_to_utf16(in, in_length, out, out_length, dst.big_endian, true)};
+
+    if (n < in_length && in[n] > 0x7F)
+        return make_result(TranscodeStatus::InvalidSequence, n, 2 * n);
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, 2 * n);
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const ASCIICodec &, const unsigned char *in, size_t in_length,
+                                 const UTF32Codec<E> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    n{widen_to_utf32(in, in_length, out, out_length, dst.big_endian, true)};
+
+    if (n < in_length && in[n] > 0x7F)
+        return make_result(TranscodeStatus::InvalidSequence, n, 4 * n);
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, 4 * n);
+}
+
+// With control characters disabled, Latin-1 needs validating and so
+// uses the generic loop.
+template <Endian E>
+TranscodeResult transcode_kernel(const Latin1Codec<true> &, const unsigned char *in, size_t in_length,
+                                 const UTF16Codec<E> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    n{widen_to_utf16(in, in_length, out, out_length, dst.big_endian, false)};
+
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, 2 * n);
+}
+
+template <Endian E>
+TranscodeResult transcode_kernel(const Latin1Codec<true> &, const unsigned char *in, size_t in_length,
+                                 const UTF32Codec<E> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    const size_t    n{widen_to_utf32(in, in_length, out, out_length, dst.big_endian, false)};
+
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, 4 * n);
+}
+
+inline TranscodeResult transcode_kernel(const Latin1Codec<true> &, const unsigned char *in, size_t in_length,
+                                        const UTF8Codec &, unsigned char *out, size_t out_length) noexcept
+{
+    size_t          written;
+    const size_t    n{latin1_to_utf8(in, in_length, out, out_length, written)};
+
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, written);
+}
+
+inline TranscodeResult transcode_kernel(const UTF8Codec &src, const unsigned char *in, size_t in_length,
+                                        const Latin1Codec<true> &dst, unsigned char *out, size_t out_length) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+
+    while (i < in_length)
+    {
+        size_t  written;
+
+        i += utf8_to_latin1_blocks(in + i, in_length - i, out + o, out_length - o, written);
+        o += written;
+
+        // Finish the block that stopped the vector loop one character at
+        // a time; characters above U+00FF are reported as unencodable.
+        const size_t    block_end{in_length - i < 16 ? in_length : i + 16};
+
+        while (i < block_end)
+        {
+            auto    status{transcode_step(src, in, in_length, i, dst, out, out_length, o)};
+
+            if (status != TranscodeStatus::Ok)
+                return make_result(status, i, o);
+        }
+    }
+
+    return make_result(TranscodeStatus::Ok, i, o);
+}
+
+// Call f with the kernel for enc.
+template <typename F>
+auto visit_kernel(const TextEncoding &enc, F &&f)
+{
+    const std::type_info   &type{typeid(enc)};
+
+    if (type == typeid(UTF8Encoding))
+        return f(UTF8Codec{});
+    if (type == typeid(UTF16Encoding))
+    {
+        if (static_cast<const UTF16Encoding &>(enc).endian() == Endian::Big)
+            return f(UTF16Codec<Endian::Big>{});
+        return f(UTF16Codec<Endian::Little>{});
+    }
+    if (type == typeid(UTF32Encoding))
+    {
+        if (static_cast<const UTF32Encoding &>(enc).endian() == Endian::Big)
+            return f(UTF32Codec<Endian::Big>{});
+        return f(UTF32Codec<Endian::Little>{});
+    }
+    if (type == typeid(Latin1Encoding))
+    {
+        if (static_cast<const Latin1Encoding &>(enc).controls_enabled())
+            return f(Latin1Codec<true>{});
+        return f(Latin1Codec<false>{});
+    }
+    if (type == typeid(ASCIIEncoding))
+        return f(ASCIICodec{});
+
+    return f(VirtualKernel{enc});
+}
+
+template <typename Kernel>
+TranscodeResult decode_kernel(const Kernel &src, const unsigned char *in, size_t in_length,
+                              char32_t *out, size_t out_length, ErrorHandling errors) noexcept
+{
+    size_t  i{0};
+    size_t  o{0};
+    size_t  first_error{TranscodeResult::npos};
+
+    while (i < in_length && o < out_length)
+    {
+        size_t  used;
+        int     cp{src.decode(in + i, in_length - i, used)};
+
+        if (cp < 0)
+        {
+            if (errors == ErrorHandling::Stop)
+                return make_result(cp == decode_incomplete ? TranscodeStatus::IncompleteSequence
+                                                           : TranscodeStatus::InvalidSequence,
+                                   i, o);
+
+            if (first_error == TranscodeResult::npos)
+                first_error = i;
+            if (cp == decode_incomplete)
+                used = in_length - i;
+            cp = 0xFFFD;
+        }
+
+        out[o++] = static_cast<char32_t>(cp);
+        i += used;
+    }
+
+    return {i < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, i, o, first_error};
+}
+
+inline TranscodeResult decode_kernel(const ASCIICodec &src, const unsigned char *in, size_t in_length,
+                                     char32_t *out, size_t out_length, ErrorHandling errors) noexcept
+{
+    const size_t    n{widen_to_utf32(in, in_length, reinterpret_cast<unsigned char *>(out),
+                                     out_length * sizeof(char32_t), Endian::Native == Endian::Big, true)};
+
+    if (n == in_length || n == out_length)
+        return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, n);
+
+    // Handle the rest, starting with the byte that is not ASCII.
+    auto    rv{decode_kernel<ASCIICodec>(src, in + n, in_length - n, out + n, out_length - n, errors)};
+
+    rv.bytes_read += n;
+    rv.bytes_written += n;
+    if (rv.error_offset != TranscodeResult::npos)
+        rv.error_offset += n;
+
+    return rv;
+}
+
+inline TranscodeResult decode_kernel(const Latin1Codec<true> &, const unsigned char *in, size_t in_length,
+                                     char32_t *out, size_t out_length, ErrorHandling) noexcept
+{
+    const size_t    n{widen_to_utf32(in, in_length, reinterpret_cast<unsigned char *>(out),
+                                     out_length * sizeof(char32_t), Endian::Native == Endian::Big, false)};
+
+    return make_result(n < in_length ? TranscodeStatus::OutputFull : TranscodeStatus::Ok, n, n);
+}
+
+}   // namespace detail
+/// \endcond
+
+/// \brief  Convert text from one encoding to another.
+/// \param src_encoding Encoding of the source bytes.
+/// \param src          Pointer to the bytes to be converted.
+/// \param src_length   Number of bytes pointed to by \p src.
+/// \param dst_encoding Encoding into which the text is to be converted.
+/// \param dst          Pointer to a buffer to receive the converted bytes.
+/// \param dst_length   Size in bytes of the buffer pointed to by \p dst.
+/// \return A TranscodeResult describing how many bytes were consumed and
+///         produced, and where in the source the conversion stopped if
+///         it did not complete.
+/// \details    Conversion stops at the first invalid or unencodable character,
+///             at an incomplete sequence at the end of the source, or when the
+///             destination buffer cannot hold the next character. In each case
+///             everything before the stopping point has been converted, so the
+///             operation can be resumed from \c bytes_read.
+///
+///             Every pairing of UTF8Encoding, UTF16Encoding, UTF32Encoding,
+///             Latin1Encoding and ASCIIEncoding is handled by a specialized
+///             kernel that makes no virtual calls. Other TextEncoding classes
+///             are converted through their virtual \c decode and \c encode
+///             functions.
+inline TranscodeResult transcode(const TextEncoding &src_encoding, const unsigned char *src, size_t src_length,
+                                 const TextEncoding &dst_encoding, unsigned char *dst, size_t dst_length) noexcept
+{
+    return detail::visit_kernel(src_encoding, [&](const auto &src_kernel) {
+        return detail::visit_kernel(dst_encoding, [&](const auto &dst_kernel) {
+            return detail::transcode_kernel(src_kernel, src, src_length, dst_kernel, dst, dst_length);
+        });
+    });
+}
+
+/// \brief  Convert text between two encodings chosen at compile time.
+/// \tparam SrcCodec    Static codec, such as UTF8Codec, of the source bytes.
+/// \tparam DstCodec    Static codec into which the text is to be converted.
+/// \param src          Pointer to the bytes to be converted.
+/// \param src_length   Number of bytes pointed to by \p src.
+/// \param dst          Pointer to a buffer to receive the converted bytes.
+/// \param dst_length   Size in bytes of the buffer pointed to by \p dst.
+/// \return A TranscodeResult, exactly as for the TextEncoding overload.
+/// \details    This uses the same specialized kernels as the TextEncoding
+///             overload but selects them at compile time, so nothing is
+///             dispatched at run time.
+template <typename SrcCodec, typename DstCodec>
+TranscodeResult transcode(const unsigned char *src, size_t src_length,
+                          unsigned char *dst, size_t dst_length) noexcept
+{
+    return detail::transcode_kernel(SrcCodec{}, src, src_length, DstCodec{}, dst, dst_length);
+}
+
+/// \brief  Determine the number of bytes needed to hold the result of
+///         converting text from one encoding to another.
+/// \param src_encoding Encoding of the source bytes.
+/// \param src          Pointer to the bytes to be converted.
+/// \param src_length   Number of bytes pointed to by \p src.
+/// \param dst_encoding Encoding into which the text is to be converted.
+/// \return The number of bytes a call to \c transcode with the same source
+///         would write, assuming an unlimited destination buffer.
+/// \details    If the source contains an error, the value returned is the size
+///             of the output produced before the error.
+inline size_t transcoded_length(const TextEncoding &src_encoding, const unsigned char *src, size_t src_length,
+                                const TextEncoding &dst_encoding) noexcept
+{
+    constexpr size_t    chunk_size{4096};
+    unsigned char       chunk[chunk_size];
+    size_t              total{0};
+
+    while (src_length)
+    {
+        auto    rv{transcode(src_encoding, src, src_length, dst_encoding, chunk, chunk_size)};
+
+        total += rv.bytes_written;
+        if (rv.status != TranscodeStatus::OutputFull || rv.bytes_read == 0)
+            break;
+        src += rv.bytes_read;
+        src_length -= rv.bytes_read;
+    }
+
+    return total;
+}
+
+/// \brief  Decode text to a buffer of Unicode scalar values.
+/// \param src_encoding Encoding of the source bytes.
+/// \param src          Pointer to the bytes to be decoded.
+/// \param src_length   Number of bytes pointed to by \p src.
+/// \param dst          Pointer to a buffer to receive the decoded characters.
+/// \param dst_length   Number of characters the buffer pointed to by \p dst
+///                     can hold.
+/// \param errors       Whether to stop at, or replace, invalid input.
+/// \return A TranscodeResult in which \c bytes_written is the number of
+///         characters, not bytes, stored in \p dst.
+/// \details    With ErrorHandling::Stop, decoding stops at the first invalid
+///             sequence, or at an incomplete sequence at the end of the source,
+///             exactly as \c transcode does. With ErrorHandling::Replace each
+///             such sequence becomes a single U+FFFD, the status is \c Ok or
+///             \c OutputFull, and \c error_offset records the position of the
+///             first replaced sequence. An invalid UTF-8 sequence is replaced
+///             by its longest valid prefix, following the Unicode Standard's
+///             recommended practice.
+inline TranscodeResult decode(const TextEncoding &src_encoding, const unsigned char *src, size_t src_length,
+                              char32_t *dst, size_t dst_length, ErrorHandling errors = ErrorHandling::Stop) noexcept
+{
+    return detail::visit_kernel(src_encoding, [&](const auto &kernel) {
+        return detail::decode_kernel(kernel, src, src_length, dst, dst_length, errors);
+    });
+}
+
+/// \brief  Decode text in an encoding chosen at compile time to a buffer
+///         of Unicode scalar values.
+/// \tparam Codec       Static codec, such as UTF8Codec, of the source bytes.
+/// \param src          Pointer to the bytes to be decoded.
+/// \param src_length   Number of bytes pointed to by \p src.
+/// \param dst          Pointer to a buffer to receive the decoded characters.
+/// \param dst_length   Number of characters the buffer pointed to by \p dst
+///                     can hold.
+/// \param errors       Whether to stop at, or replace, invalid input.
+/// \return A TranscodeResult, exactly as for the TextEncoding overload.
+template <typename Codec>
+TranscodeResult decode(const unsigned char *src, size_t src_length,
+                       char32_t *dst, size_t dst_length, ErrorHandling errors = ErrorHandling::Stop) noexcept
+{
+    return detail::decode_kernel(Codec{}, src, src_length, dst, dst_length, errors);
+}
+
+}
+
+#endif  // BRACE_LIB_TRANSCODE_INC
@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2024 Jeffrey K. Bienstadt
+//
+// This file is part of the brace C++ library.
+//
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+//////////////////////////////////////////////////////////////////////
+
+/// \file transcode_stream.h
+///
+/// \author Jeff Bienstadt
+#ifndef BRACE_LIB_TRANSCODE_STREAM_INC
+#define BRACE_LIB_TRANSCODE_STREAM_INC
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "brace/binistream.h"
+#include "brace/binostream.h"
+#include "brace/text_encoding.h"
+#include "brace/transcode.h"
+
+namespace brace {
+
+/// \brief  Options for transcoding between streams.
+struct StreamTranscodeOptions
+{
+    /// \brief  Number of source bytes read from the input stream at a time.
+    size_t  block_size{64 * 1024};
+    /// \brief  If \c true, a byte order mark at the start of the source
+    ///         is consumed rather than converted.
+    bool    skip_bom{true};
+    /// \brief  If \c true, a byte order mark is written to the destination
+    ///         before any converted text, provided the destination encoding
+    ///         can represent one.
+    bool    emit_bom{false};
+};
+
+/// \brief  Convert text from one encoding to another, reading from a
+///         binary input stream and writing to a binary output stream.
+/// \param src_encoding Encoding of the bytes in \p instream.
+/// \param instream     Stream from which the source bytes are read.
+/// \param dst_encoding Encoding into which the text is to be converted.
+/// \param outstream    Stream to which the converted bytes are written.
+/// \param options      Block size and byte order mark handling.
+/// \return A TranscodeResult giving the totals of bytes read and written.
+///         \c error_offset is relative to the start of the stream.
+/// \details    The source is read and converted one block at a time, so
+///             memory use does not depend on the size of the stream. A
+///             multi-byte sequence or surrogate pair that straddles two
+///             blocks is carried over and converted with the next block;
+///             one that is still incomplete at the end of the stream is
+///             reported as TranscodeStatus::IncompleteSequence. Each block
+///             is converted by \c transcode, and so uses the same specialized
+///             kernels. If the output stream stops accepting bytes the
+///             status is TranscodeStatus::OutputFull.
+inline TranscodeResult transcode(const TextEncoding &src_encoding, BinIStream &instream,
+                                 const TextEncoding &dst_encoding, BinOStream &outstream,
+                                 const StreamTranscodeOptions &options = {})
+{
+    // Room to carry an incomplete sequence over to the next block.
+    constexpr size_t    carry_room{16};
+    // No supported conversion produces more than four bytes per source byte.
+    constexpr size_t    max_expansion{4};
+
+    const size_t                block_size{options.block_size < carry_room ? carry_room : options.block_size};
+    std::vector<unsigned char>  in(block_size + carry_room);
+    std::vector<unsigned char>  out(in.size() * max_expansion);
+    size_t                      carry{0};
+    size_t                      total_read{0};
+    size_t                      total_written{0};
+    bool                        at_start{true};
+    bool                        at_end{false};
+
+    auto    put = [&outstream, &total_written](const unsigned char *bytes, size_t length)
+            {
+                const auto  count{static_cast<std::streamsize>(length)};
+                const auto  written{outstream.write(bytes, count)};
+
+                total_written += written > 0 ? static_cast<size_t>(written) : 0;
+                return written == count;
+            };
+
+    if (options.emit_bom)
+    {
+        unsigned char   bom[8];
+        const int       n{dst_encoding.encode(0xFEFF, bom, sizeof(bom))};
+
+        if (n > 0 && !put(bom, static_cast<size_t>(n)))
+            return {TranscodeStatus::OutputFull, 0, total_written, TranscodeResult::npos};
+    }
+
+    while (!at_end)
+    {
+        const auto  request{static_cast<std::streamsize>(in.size() - carry)};
+
+        instream.read(in.data() + carry, request);
+
+        const auto  got{instream.gcount()};
+
+        at_end = got < request || !instream.good();
+
+        size_t  length{carry + (got > 0 ? static_cast<size_t>(got) : 0)};
+        size_t  pos{0};
+
+        if (at_start)
+        {
+            unsigned char   bom[8];
+            const int       n{options.skip_bom ? src_encoding.encode(0xFEFF, bom, sizeof(bom)) : 0};
+
+            if (n > 0 && length >= static_cast<size_t>(n) && memcmp(in.data(), bom, static_cast<size_t>(n)) == 0)
+                pos = static_cast<size_t>(n);
+            at_start = false;
+        }
+
+        // Convert the block, emptying the output buffer as often as needed.
+        for (;;)
+        {
+            const auto  rv{transcode(src_encoding, in.data() + pos, length - pos,
+                                     dst_encoding, out.data(), out.size())};
+
+            if (!put(out.data(), rv.bytes_written))
+                return {TranscodeStatus::OutputFull, total_read + pos + rv.bytes_read, total_written,
+                        TranscodeResult::npos};
+
+            pos += rv.bytes_read;
+
+            if (rv.status == TranscodeStatus::Ok)
+                break;
+            if (rv.status == TranscodeStatus::OutputFull && rv.bytes_read != 0)
+                continue;
+            if (   rv.status == TranscodeStatus::IncompleteSequence
+                && !at_end
+                && length - pos < carry_room)
+            {
+                break;
+            }
+
+            return {rv.status, total_read + pos, total_written, total_read + pos};
+        }
+
+        // Move whatever was not converted to the front of the buffer.
+        carry = length - pos;
+        if (carry)
+            memmove(in.data(), in.data() + pos, carry);
+        total_read += pos;
+    }
+
+    return {TranscodeStatus::Ok, total_read, total_written, TranscodeResult::npos};
+}
+
+}
+
+#endif  // BRACE_LIB_TRANSCODE_STREAM_INC
@@ -14,13 +14,25 @@
 #ifndef BRACE_LIB_UTF16_ENCODING_INC
 #define BRACE_LIB_UTF16_ENCODING_INC
 
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "brace/bits.h"
 #include "brace/byteorder.h"
 #include "brace/text_encoding.h"
 #include "brace/string.h"
+#include "brace/text_codec.h"
 
 namespace brace {
-class UTF16Encoding : TextEncoding
+class UTF16Encoding : public TextEncoding
 {
+public:
     UTF16Encoding(Endian e = Endian::Native)
     {
         endian(e);
@@ -50,7 +62,7 @@ class UTF16Encoding : TextEncoding
         _flip = byte_order_mark != 0xFEFF;
     }
 
-    Endian endian()
+    Endian endian() const noexcept
     {
 #if BRACE_BYTE_ORDER == BRACE_BYTE_ORDER_BIG_ENDIAN
         return _flip ? Endian::Little : Endian::Big;
@@ -81,109 +93,209 @@ class UTF16Encoding : TextEncoding
 
     /// \brief  Decode a multi-byte sequence to a Unicode scalar value
     /// \param bytes pointer to a byte sequence
-    /// \return the Unicode scalar value represented by the UTF-8 byte sequence
+    /// \return the Unicode scalar value represented by the UTF-16 byte sequence
     ///         if successful, -1 otherwise.
     int decode(const unsigned char *bytes) const noexcept override
     {
-        uint16_t        uc;
-        unsigned char  *p = (unsigned char *)&uc;
-        *p++ = *bytes++;
-        *p++ = *bytes++;
-
-        if (_flip)
-        {
-            uc = brace::byte_swap(uc);
-        }
+        return endian() == Endian::Big ? decode_sequence<UTF16Codec<Endian::Big>>(bytes)
+                                       : decode_sequence<UTF16Codec<Endian::Little>>(bytes);
+    }
 
-        if (uc >= 0xD800 && uc < 0xDC00)
-        {
-            uint16_t    uc2;
-            p = (unsigned char *)&uc2;
-            *p++ = *bytes++;
-            *p++ = *bytes++;
-
-            if (_flip)
-            {
-                uc2 = brace::byte_swap(uc2);
-            }
-
-            if (uc2 >= 0xDC00 && uc2 < 0xE000)
-            {
-                return ((uc & 0x3FF) << 10) + (uc2 & 0x3FF) + 0x10000;
-            }
-            else
-            {
-                return -1;
-            }
-        }
-        else
-        {
-            return uc;
-        }
+    /// \brief  Decode the UTF-16 sequence at the start of a bounded byte sequence.
+    /// \param bytes    Pointer to a byte sequence.
+    /// \param length   Number of bytes available at \p bytes.
+    /// \return A DecodeResult holding the Unicode scalar value and the
+    ///         number of bytes it occupied. An unpaired surrogate is
+    ///         reported as invalid with a length of two bytes.
+    DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept override
+    {
+        return endian() == Endian::Big ? decode_sequence<UTF16Codec<Endian::Big>>(bytes, length)
+                                       : decode_sequence<UTF16Codec<Endian::Little>>(bytes, length);
     }
 
     int encode(int ch, unsigned char *bytes, int length) const noexcept override
     {
-        if (ch <= 0xFFFF)
-        {
-            if (bytes && length >= 2)
-            {
-                uint16_t    ch1 = _flip ? brace::byte_swap(static_cast<uint16_t>(ch))
-                                        : static_cast<uint16_t>(ch);
-                unsigned char  *p = reinterpret_cast<unsigned char *>(&ch1);
+        return endian() == Endian::Big ? encode_sequence<UTF16Codec<Endian::Big>>(ch, bytes, length)
+                                       : encode_sequence<UTF16Codec<Endian::Little>>(ch, bytes, length);
+    }
 
-                *bytes++ = *p++;
-                *bytes++ = *p++;
-            }
+    int sequence_length(const unsigned char *bytes, int length) const noexcept override
+    {
+        return endian() == Endian::Big ? measure_sequence<UTF16Codec<Endian::Big>>(bytes, length)
+                                       : measure_sequence<UTF16Codec<Endian::Little>>(bytes, length);
+    }
+
+    /// \brief  Count the code points in a buffer of UTF-16.
+    /// \param bytes    Pointer to UTF-16 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes. A trailing
+    ///                 odd byte is ignored.
+    /// \return The number of code points in the buffer.
+    /// \details    A surrogate pair counts as one code point; every other
+    ///             code unit, including an unpaired surrogate, counts as one.
+    ///             The buffer is scanned 32 or 16 bytes at a time when AVX2
+    ///             or SSE2 is available.
+    size_t count_code_points(const unsigned char *bytes, size_t length) const noexcept
+    {
+        const bool      big{endian() == Endian::Big};
+        const size_t    end{length & ~size_t{1}};
+        size_t          count{0};
+        size_t          pos{0};
+        bool            after_high{false};
+
+        for (; pos + unit_block_size <= end; pos += unit_block_size)
+            count += popcount(start_mask(bytes + pos, big, after_high));
+        for (; pos < end; pos += 2)
+            count += is_start(bytes + pos, after_high);
+
+        return count;
+    }
+
+    /// \brief  Find the byte offset of a code point in a buffer of UTF-16.
+    /// \param bytes    Pointer to UTF-16 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \param n        Zero-based index of the code point to find.
+    /// \return The offset of the first byte of the \p n th code point, or
+    ///         \p length if the buffer holds \p n or fewer code points.
+    size_t code_point_offset(const unsigned char *bytes, size_t length, size_t n) const noexcept
+    {
+        const bool      big{endian() == Endian::Big};
+        const size_t    end{length & ~size_t{1}};
+        size_t          pos{0};
+        bool            after_high{false};
 
-            return 2;
+        for (; pos + unit_block_size <= end; pos += unit_block_size)
+        {
+            const auto      mask{start_mask(bytes + pos, big, after_high)};
+            const size_t    count{static_cast<size_t>(popcount(mask))};
+
+            // Each code unit is marked by the bit of its high-order byte.
+            if (n < count)
+                return pos + (static_cast<size_t>(select_bit(mask, static_cast<int>(n))) & ~size_t{1});
+            n -= count;
         }
-        else
+        for (; pos < end; pos += 2)
         {
-            if (bytes && length >= 4)
-            {
-                int         ch1 = ch - 0x10000;
-                uint16_t    sp1 = 0xD800 + ((ch1 >> 10) & 0x3FF);
-                uint16_t    sp2 = 0xDC00 + (ch1 & 0x3FF);
-
-                if (_flip)
-                {
-                    sp1 = brace::byte_swap(sp1);
-                    sp2 = brace::byte_swap(sp2);
-                }
-                unsigned char  *p = reinterpret_cast<unsigned char *>(&sp1);
-                *bytes++ = *p++;
-                *bytes++ = *p++;
-                p = reinterpret_cast<unsigned char *>(&sp2);
-                *bytes++ = *p++;
-                *bytes++ = *p++;
-            }
-
-            return 4;
+            if (is_start(bytes + pos, after_high) && n-- == 0)
+                return pos;
         }
+
+        return length;
     }
 
-    int sequence_length(const unsigned char *bytes, int length) const noexcept override
+    /// \brief  Find the nearest code point boundary at or before an offset.
+    /// \param bytes    Pointer to UTF-16 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \param offset   Byte offset into the buffer.
+    /// \return The offset of the first byte of the code point that contains
+    ///         the byte at \p offset, or \p length if \p offset is at or
+    ///         past the end of the buffer.
+    size_t boundary_before(const unsigned char *bytes, size_t length, size_t offset) const noexcept
     {
-        if (length <= 1)
-            return -1;
+        if (offset >= length)
+            return length;
 
-        uint32_t        cu;
-        unsigned char  *p{reinterpret_cast<unsigned char *>(cu)};
-        *p++ = *bytes++;
-        *p++ = *bytes++;
+        offset &= ~size_t{1};
+        if (   offset >= 2
+            && offset + 2 <= length
+            && is_low_surrogate(unit(bytes + offset))
+            && is_high_surrogate(unit(bytes + offset - 2)))
+        {
+            offset -= 2;
+        }
 
-        if (_flip)
-            cu = byte_swap(cu);
-        if (cu >= 0xD800 && cu <= 0xDC00)
-            return 4;
-        else
-            return 2;
+        return offset;
     }
 
 private:
     bool    _flip;
 
+    static bool is_high_surrogate(int u) noexcept
+    {
+        return u >= 0xD800 && u < 0xDC00;
+    }
+
+    static bool is_low_surrogate(int u) noexcept
+    {
+        return u >= 0xDC00 && u < 0xE000;
+    }
+
+    // Determine if the code unit at bytes begins a code point, given
+    // whether the previous unit was a high surrogate, and update that.
+    bool is_start(const unsigned char *bytes, bool &after_high) const noexcept
+    {
+        const int   u{unit(bytes)};
+        const bool  start{!(after_high && is_low_surrogate(u))};
+
+        after_high = is_high_surrogate(u);
+        return start;
+    }
+
+    // Bitmask marking the code units in a block that begin a code point.
+    // Each unit is represented by the bit of its high-order byte. A low
+    // surrogate continues a code point exactly when the unit before it is
+    // a high surrogate; after_high carries that across blocks.
+#if defined(__AVX2__)
+    static constexpr size_t unit_block_size{32};
+
+    static uint32_t start_mask(const unsigned char *bytes, bool big, bool &after_high) noexcept
+    {
+        const __m256i   v{_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes)),
+                                           _mm256_set1_epi8(static_cast<char>(0xFC)))};
+        const uint32_t  units{big ? 0x55555555U : 0xAAAAAAAAU};
+        const uint32_t  high{units & static_cast<uint32_t>(_mm256_movemask_epi8(
+                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(0xD8)))))};
+        const uint32_t  low{units & static_cast<uint32_t>(_mm256_movemask_epi8(
+                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(0xDC)))))};
+        const uint32_t  carry{after_high ? (big ? 1U : 2U) : 0U};
+
+        after_high = (high >> 30) != 0;
+        return units & ~(low & ((high << 2) | carry));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    static constexpr size_t unit_block_size{16};
+
+    static uint32_t start_mask(const unsigned char *bytes, bool big, bool &after_high) noexcept
+    {
+        const __m128i   v{_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)),
+                                        _mm_set1_epi8(static_cast<char>(0xFC)))};
+        const uint32_t  units{big ? 0x5555U : 0xAAAAU};
+        const uint32_t  high{units & static_cast<uint32_t>(_mm_movemask_epi8(
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(0xD8)))))};
+        const uint32_t  low{units & static_cast<uint32_t>(_mm_movemask_epi8(
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(0xDC)))))};
+        const uint32_t  carry{after_high ? (big ? 1U : 2U) : 0U};
+
+        after_high = (high >> 14) != 0;
+        return units & ~(low & ((high << 2) | carry));
+    }
+#else
+    static constexpr size_t unit_block_size{8};
+
+    static uint32_t start_mask(const unsigned char *bytes, bool big, bool &after_high) noexcept
+    {
+        uint32_t    mask{0};
+
+        for (size_t i = 0; i < unit_block_size; i += 2)
+        {
+            const int   u{big ? (bytes[i] << 8) | bytes[i + 1]
+                              : (bytes[i + 1] << 8) | bytes[i]};
+
+            if (!(after_high && is_low_surrogate(u)))
+                mask |= 1U << (big ? i : i + 1);
+            after_high = is_high_surrogate(u);
+        }
+
+        return mask;
+    }
+#endif
+    // Read one code unit in this encoding's byte order.
+    int unit(const unsigned char *bytes) const noexcept
+    {
+        return (endian() == Endian::Big) ? (bytes[0] << 8) | bytes[1]
+                                         : (bytes[1] << 8) | bytes[0];
+    }
+
+
     inline constexpr static const char *_names[] {
         "UTF-16",
         "UTF16"
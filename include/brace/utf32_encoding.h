@@ -17,10 +17,11 @@
 #include "brace/byteorder.h"
 #include "brace/text_encoding.h"
 #include "brace/string.h"
+#include "brace/text_codec.h"
 
 namespace brace {
 
-class UTF32Encoding : TextEncoding
+class UTF32Encoding : public TextEncoding
 {
 public:
     UTF32Encoding(Endian e = Endian::Native)
@@ -52,7 +53,7 @@ public:
         _flip = byte_order_mark != 0xFEFF;
     }
 
-    Endian endian()
+    Endian endian() const noexcept
     {
 #if BRACE_BYTE_ORDER == BRACE_BYTE_ORDER_BIG_ENDIAN
         return _flip ? Endian::Little : Endian::Big;
@@ -86,21 +87,20 @@ public:
     ///         if successful, -1 otherwise.
     int decode(const unsigned char *bytes) const noexcept override
     {
-        uint32_t        uc;
-        unsigned char  *p = reinterpret_cast<unsigned char *>(&uc);
-
-        *p++ = *bytes++;
-        *p++ = *bytes++;
-        *p++ = *bytes++;
-        *p++ = *bytes++;
-
-        if (_flip)
-            uc = byte_swap(uc);
+        return endian() == Endian::Big ? decode_sequence<UTF32Codec<Endian::Big>>(bytes)
+                                       : decode_sequence<UTF32Codec<Endian::Little>>(bytes);
+    }
 
-        if (uc <= 0x10FFFF)
-            return static_cast<int>(uc);
-        else
-            return -1;
+    /// \brief  Decode the UTF-32 sequence at the start of a bounded byte sequence.
+    /// \param bytes    Pointer to a byte sequence.
+    /// \param length   Number of bytes available at \p bytes.
+    /// \return A DecodeResult holding the Unicode scalar value and the
+    ///         number of bytes it occupied. Values above U+10FFFF and
+    ///         surrogates are reported as invalid.
+    DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept override
+    {
+        return endian() == Endian::Big ? decode_sequence<UTF32Codec<Endian::Big>>(bytes, length)
+                                       : decode_sequence<UTF32Codec<Endian::Little>>(bytes, length);
     }
 
     /// \brief  Encode the Unicode character ch into a byte sequence.
@@ -110,24 +110,14 @@ public:
     /// \return The number of bytes used in the conversion.
     int encode(int ch, unsigned char *bytes, int length) const noexcept override
     {
-        if (bytes && length >= 4)
-        {
-            uint32_t        ch1{_flip ? byte_swap(static_cast<uint32_t>(ch))
-                                      : static_cast<uint32_t>(ch)};
-
-            unsigned char  *p = reinterpret_cast<unsigned char*>(&ch1);
-            *bytes++ = *p++;
-            *bytes++ = *p++;
-            *bytes++ = *p++;
-            *bytes++ = *p++;
-        }
-
-        return 4;
+        return endian() == Endian::Big ? encode_sequence<UTF32Codec<Endian::Big>>(ch, bytes, length)
+                                       : encode_sequence<UTF32Codec<Endian::Little>>(ch, bytes, length);
     }
 
     int sequence_length(const unsigned char *bytes, int length) const noexcept override
     {
-        return 4;
+        return endian() == Endian::Big ? measure_sequence<UTF32Codec<Endian::Big>>(bytes, length)
+                                       : measure_sequence<UTF32Codec<Endian::Little>>(bytes, length);
     }
 
 private:
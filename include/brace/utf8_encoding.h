@@ -14,10 +14,332 @@
 #ifndef BRACE_LIB_UTF8_ENCODING_INC
 #define BRACE_LIB_UTF8_ENCODING_INC
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "brace/bits.h"
+#include "brace/cpu_features.h"
 #include "brace/text_encoding.h"
 #include "brace/string.h"
+#include "brace/text_codec.h"
 
 namespace brace {
+
+/// \cond
+namespace detail {
+
+// Vectorized UTF-8 validation, after J. Keiser and D. Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte" (2021).
+//
+// Each pair of adjacent bytes is classified by three 16-entry
+// table lookups (high nibble of the first byte, low nibble of the
+// first byte, high nibble of the second byte). ANDing the results
+// leaves a bit set only for the error classes that the pair belongs
+// to. Three- and four-byte sequences are then checked by verifying
+// that continuation bytes appear exactly where the lead bytes two
+// and three positions back require them.
+//
+// The algorithm is written once, against the small vector "traits"
+// structures that follow, and instantiated for each instruction set
+// that is enabled at compile time or, where kernels can be chosen at
+// run time, for each one the processor may have. The members of each
+// traits structure are marked with BRACE_TARGET for its instruction set.
+
+#if defined(__SSE4_1__) || defined(BRACE_RUNTIME_DISPATCH)
+struct Utf8VecSSE
+{
+    using type = __m128i;
+    static constexpr size_t size{16};
+
+    BRACE_TARGET("sse4.1")
+    static type load(const unsigned char *p) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    BRACE_TARGET("sse4.1")
+    static type table(const uint8_t *t) noexcept
+    {
+        return load(t);
+    }
+    BRACE_TARGET("sse4.1")
+    static type zero() noexcept
+    {
+        return _mm_setzero_si128();
+    }
+    BRACE_TARGET("sse4.1")
+    static type set1(uint8_t b) noexcept
+    {
+        return _mm_set1_epi8(static_cast<char>(b));
+    }
+    BRACE_TARGET("sse4.1")
+    static type lookup(type tbl, type idx) noexcept
+    {
+        return _mm_shuffle_epi8(tbl, idx);
+    }
+    BRACE_TARGET("sse4.1")
+    static type high_nibbles(type v) noexcept
+    {
+        return _mm_and_si128(_mm_srli_epi16(v, 4), set1(0x0F));
+    }
+    BRACE_TARGET("sse4.1") static type and_(type a, type b) noexcept { return _mm_and_si128(a, b); }
+    BRACE_TARGET("sse4.1") static type or_(type a, type b) noexcept { return _mm_or_si128(a, b); }
+    BRACE_TARGET("sse4.1") static type xor_(type a, type b) noexcept { return _mm_xor_si128(a, b); }
+    BRACE_TARGET("sse4.1") static type subs(type a, type b) noexcept { return _mm_subs_epu8(a, b); }
+    template <int N>
+    BRACE_TARGET("sse4.1")
+    static type prev(type cur, type before) noexcept
+    {
+        return _mm_alignr_epi8(cur, before, 16 - N);
+    }
+    BRACE_TARGET("sse4.1")
+    static bool is_ascii(type v) noexcept
+    {
+        return _mm_movemask_epi8(v) == 0;
+    }
+    BRACE_TARGET("sse4.1")
+    static bool any(type v) noexcept
+    {
+        return !_mm_testz_si128(v, v);
+    }
+};
+#endif
+
+#if defined(__AVX2__) || defined(BRACE_RUNTIME_DISPATCH)
+struct Utf8VecAVX2
+{
+    using type = __m256i;
+    static constexpr size_t size{32};
+
+    BRACE_TARGET("avx2")
+    static type load(const unsigned char *p) noexcept
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    BRACE_TARGET("avx2")
+    static type table(const uint8_t *t) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+    }
+    BRACE_TARGET("avx2")
+    static type zero() noexcept
+    {
+        return _mm256_setzero_si256();
+    }
+    BRACE_TARGET("avx2")
+    static type set1(uint8_t b) noexcept
+    {
+        return _mm256_set1_epi8(static_cast<char>(b));
+    }
+    BRACE_TARGET("avx2")
+    static type lookup(type tbl, type idx) noexcept
+    {
+        return _mm256_shuffle_epi8(tbl, idx);
+    }
+    BRACE_TARGET("avx2")
+    static type high_nibbles(type v) noexcept
+    {
+        return _mm256_and_si256(_mm256_srli_epi16(v, 4), set1(0x0F));
+    }
+    BRACE_TARGET("avx2") static type and_(type a, type b) noexcept { return _mm256_and_si256(a, b); }
+    BRACE_TARGET("avx2") static type or_(type a, type b) noexcept { return _mm256_or_si256(a, b); }
+    BRACE_TARGET("avx2") static type xor_(type a, type b) noexcept { return _mm256_xor_si256(a, b); }
+    BRACE_TARGET("avx2") static type subs(type a, type b) noexcept { return _mm256_subs_epu8(a, b); }
+    template <int N>
+    BRACE_TARGET("avx2")
+    static type prev(type cur, type before) noexcept
+    {
+        return _mm256_alignr_epi8(cur, _mm256_permute2x128_si256(before, cur, 0x21), 16 - N);
+    }
+    BRACE_TARGET("avx2")
+    static bool is_ascii(type v) noexcept
+    {
+        return _mm256_movemask_epi8(v) == 0;
+    }
+    BRACE_TARGET("avx2")
+    static bool any(type v) noexcept
+    {
+        return !_mm256_testz_si256(v, v);
+    }
+};
+#endif
+
+#if defined(__AVX512BW__) || defined(BRACE_RUNTIME_DISPATCH)
+struct Utf8VecAVX512
+{
+    using type = __m512i;
+    static constexpr size_t size{64};
+
+    BRACE_TARGET("avx512f,avx512bw")
+    static type load(const unsigned char *p) noexcept
+    {
+        return _mm512_loadu_si512(p);
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static type table(const uint8_t *t) noexcept
+    {
+        return _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static type zero() noexcept
+    {
+        return _mm512_setzero_si512();
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static type set1(uint8_t b) noexcept
+    {
+        return _mm512_set1_epi8(static_cast<char>(b));
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static type lookup(type tbl, type idx) noexcept
+    {
+        return _mm512_shuffle_epi8(tbl, idx);
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static type high_nibbles(type v) noexcept
+    {
+        return _mm512_and_si512(_mm512_srli_epi16(v, 4), set1(0x0F));
+    }
+    BRACE_TARGET("avx512f,avx512bw") static type and_(type a, type b) noexcept { return _mm512_and_si512(a, b); }
+    BRACE_TARGET("avx512f,avx512bw") static type or_(type a, type b) noexcept { return _mm512_or_si512(a, b); }
+    BRACE_TARGET("avx512f,avx512bw") static type xor_(type a, type b) noexcept { return _mm512_xor_si512(a, b); }
+    BRACE_TARGET("avx512f,avx512bw") static type subs(type a, type b) noexcept { return _mm512_subs_epu8(a, b); }
+    template <int N>
+    BRACE_TARGET("avx512f,avx512bw")
+    static type prev(type cur, type before) noexcept
+    {
+        const type  idx{_mm512_set_epi64(13, 12, 11, 10, 9, 8, 7, 6)};
+
+        return _mm512_alignr_epi8(cur, _mm512_permutex2var_epi64(before, idx, cur), 16 - N);
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static bool is_ascii(type v) noexcept
+    {
+        return _mm512_movepi8_mask(v) == 0;
+    }
+    BRACE_TARGET("avx512f,avx512bw")
+    static bool any(type v) noexcept
+    {
+        return _mm512_test_epi8_mask(v, v) != 0;
+    }
+};
+#endif
+
+// Utf8Check and UTF8Encoding::find_invalid_vector call functions marked
+// with BRACE_TARGET that take and return vectors. They are always inlined
+// into a kernel for the same instruction set, so GCC's warning that the
+// calling convention of those functions differs from their own does not
+// apply.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+struct Utf8Check
+{
+    // Error classes for a pair of adjacent bytes.
+    static constexpr uint8_t too_short{1 << 0};     // 11______ 0_______ or 11______ 11______
+    static constexpr uint8_t too_long{1 << 1};      // 0_______ 10______
+    static constexpr uint8_t overlong_3{1 << 2};    // 11100000 100_____
+    static constexpr uint8_t too_large{1 << 3};     // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+    static constexpr uint8_t surrogate{1 << 4};     // 11101101 101_____
+    static constexpr uint8_t overlong_2{1 << 5};    // 1100000_ 10______
+    static constexpr uint8_t too_large_1000{1 << 6};// 11110101+ 1000____
+    static constexpr uint8_t overlong_4{1 << 6};    // 11110000 1000____
+    static constexpr uint8_t two_conts{1 << 7};     // 10______ 10______
+    static constexpr uint8_t carry{too_short | too_long | two_conts};
+
+    inline constexpr static uint8_t byte_1_high[16] {
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+        two_conts, two_conts, two_conts, two_conts,
+        too_short | overlong_2,
+        too_short,
+        too_short | overlong_3 | surrogate,
+        too_short | too_large | too_large_1000 | overlong_4
+    };
+
+    inline constexpr static uint8_t byte_1_low[16] {
+        carry | overlong_3 | overlong_2 | overlong_4,
+        carry | overlong_2,
+        carry,
+        carry,
+        carry | too_large,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000
+    };
+
+    inline constexpr static uint8_t byte_2_high[16] {
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_short, too_short, too_short, too_short
+    };
+
+    // Check one vector of input, given the vector that preceded it, and
+    // add any errors found to error.
+    template <typename V>
+    BRACE_ALWAYS_INLINE static void check(const typename V::type &input, const typename V::type &before, typename V::type &error) noexcept
+    {
+        const auto  prev1{V::template prev<1>(input, before)};
+        const auto  special{V::and_(V::and_(V::lookup(V::table(byte_1_high), V::high_nibbles(prev1)),
+                                            V::lookup(V::table(byte_1_low), V::and_(prev1, V::set1(0x0F)))),
+                                    V::lookup(V::table(byte_2_high), V::high_nibbles(input)))};
+
+        // Bytes two positions after a three- or four-byte lead, or three
+        // positions after a four-byte lead, must be continuation bytes.
+        const auto  prev2{V::template prev<2>(input, before)};
+        const auto  prev3{V::template prev<3>(input, before)};
+        const auto  must_be_cont{V::and_(V::or_(V::subs(prev2, V::set1(0xE0 - 0x80)),
+                                                V::subs(prev3, V::set1(0xF0 - 0x80))),
+                                         V::set1(0x80))};
+
+        error = V::or_(error, V::xor_(must_be_cont, special));
+    }
+
+    // The largest byte value that does not begin a sequence running
+    // past the end of a vector, for each of the last 64 positions.
+    inline constexpr static uint8_t max_value[64] {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+    };
+
+    // Set incomplete to nonzero if the vector ends with an incomplete
+    // sequence, and to zero otherwise.
+    template <typename V>
+    BRACE_ALWAYS_INLINE static void is_incomplete(const typename V::type &input, typename V::type &incomplete) noexcept
+    {
+        incomplete = V::subs(input, V::load(max_value + sizeof(max_value) - V::size));
+    }
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+struct Utf8FindInvalid;
+
+}   // namespace detail
+/// \endcond
+
 class UTF8Encoding : public TextEncoding
 {
 public:
@@ -71,31 +393,21 @@ public:
     ///         if successful, -1 otherwise.
     int decode(const unsigned char *bytes) const noexcept override
     {
-        int     n{_map[*bytes]};
-        int     cp;
-
-        switch (n)
-        {
-            case -1:
-                return -1;
-            case -4:
-            case -3:
-            case -2:
-                if (!is_valid(bytes, -n))
-                    return -1;
-                cp = *bytes & ((0x07 << (n + 4)) | 0x03);
-                break;
-            default:
-                return n;
-        }
-
-        while (n++ < -1)
-        {
-            cp <<= 6;
-            cp |= (*++bytes & 0x03F);
-        }
+        return decode_sequence<UTF8Codec>(bytes);
+    }
 
-        return cp;
+    /// \brief  Decode the UTF-8 sequence at the start of a bounded byte sequence.
+    /// \param bytes    Pointer to a byte sequence.
+    /// \param length   Number of bytes available at \p bytes.
+    /// \return A DecodeResult holding the Unicode scalar value and the
+    ///         number of bytes it occupied.
+    /// \details    An ill-formed sequence is reported with the length of its
+    ///             longest valid prefix (at least one byte), so that skipping
+    ///             it and substituting U+FFFD follows the Unicode Standard's
+    ///             recommended practice.
+    DecodeResult decode_bounded(const unsigned char *bytes, int length) const noexcept override
+    {
+        return decode_sequence<UTF8Codec>(bytes, length);
     }
 
     /// \brief  Encode the Unicode character ch into a byte sequence.
@@ -105,46 +417,7 @@ public:
     /// \return The number of bytes used in the conversion.
     int encode(int ch, unsigned char *bytes, int length) const noexcept override
     {
-        if (ch <= 0x7F)
-        {
-            if (bytes && length >= 1)
-                *bytes = static_cast<unsigned char>(ch);
-            return 1;
-        }
-        else if (ch <= 0x7FF)
-        {
-            if (bytes && length >= 2)
-            {
-                *bytes++ = static_cast<unsigned char>(((ch >> 6) & 0x1F) | 0xC0);
-                *bytes   = static_cast<unsigned char>((ch & 0x3F) | 0x80);
-            }
-            return 2;
-        }
-        else if (ch <= 0xFFFF)
-        {
-            if (bytes && length >= 3)
-            {
-                *bytes++ = static_cast<unsigned char>(((ch >> 12) & 0x0F) | 0xE0);
-                *bytes++ = static_cast<unsigned char>(((ch >> 6) & 0x3F) | 0x80);
-                *bytes   = static_cast<unsigned char>((ch & 0x3F) | 0x80);
-            }
-            return 3;
-        }
-        else if (ch <= 0x10FFFF)
-        {
-            if (bytes && length >= 4)
-            {
-                *bytes++ = static_cast<unsigned char>(((ch >> 18) & 0x07) | 0xF0);
-                *bytes++ = static_cast<unsigned char>(((ch >> 12) & 0x3F) | 0x80);
-                *bytes++ = static_cast<unsigned char>(((ch >> 6) & 0x3F) | 0x80);
-                *bytes   = static_cast<unsigned char>((ch & 0x3F) | 0x80);
-            }
-            return 4;
-        }
-        else
-        {
-            return 0;
-        }
+        return encode_sequence<UTF8Codec>(ch, bytes, length);
     }
 
     /// \brief  Determine the length of a byte sequence.
@@ -153,71 +426,311 @@ public:
     /// \return Length of the byte sequence.
     int sequence_length(const unsigned char *bytes, int length) const noexcept override
     {
-        if (length >= 1)
+        return measure_sequence<UTF8Codec>(bytes, length);
+    }
+
+    /// \brief  Find the first invalid UTF-8 sequence in a buffer.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return The offset of the first byte of the first sequence that is
+    ///         not well-formed UTF-8, or \p length if the entire buffer is
+    ///         valid. A sequence cut short by the end of the buffer is
+    ///         reported as invalid.
+    /// \details    When the processor has AVX-512BW, AVX2 or SSE4.1 the
+    ///             buffer is checked 64 bytes at a time using vector
+    ///             instructions; otherwise a table-driven state machine is used.
+    ///             The instruction set is chosen on the first call from those
+    ///             cpu_features() reports, unless the program is compiled for
+    ///             AVX-512BW.
+    static size_t find_invalid(const unsigned char *bytes, size_t length) noexcept;
+
+    /// \brief  Determine if a buffer contains only well-formed UTF-8.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return \c true if the entire buffer is valid UTF-8, \c false otherwise.
+    static bool validate(const unsigned char *bytes, size_t length) noexcept
+    {
+        return find_invalid(bytes, length) == length;
+    }
+
+    /// \brief  Count the code points in a buffer of UTF-8.
+    /// \param bytes    Pointer to UTF-8 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return The number of code points in the buffer.
+    /// \details    Every byte that is not a continuation byte is counted, so
+    ///             the result is exact for well-formed text. The buffer is
+    ///             scanned 32 or 16 bytes at a time when AVX2 or SSE2 is
+    ///             available.
+    static size_t count_code_points(const unsigned char *bytes, size_t length) noexcept
+    {
+        size_t  count{0};
+        size_t  pos{0};
+
+        for (; pos + lead_block_size <= length; pos += lead_block_size)
+            count += popcount(lead_byte_mask(bytes + pos));
+        for (; pos < length; ++pos)
+            count += !is_continuation(bytes[pos]);
+
+        return count;
+    }
+
+    /// \brief  Find the byte offset of a code point in a buffer of UTF-8.
+    /// \param bytes    Pointer to UTF-8 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \param n        Zero-based index of the code point to find.
+    /// \return The offset of the first byte of the \p n th code point, or
+    ///         \p length if the buffer holds \p n or fewer code points.
+    /// \details    <tt>code_point_offset(bytes, length, n)</tt> is the length
+    ///             of the buffer truncated to its first \p n code points.
+    static size_t code_point_offset(const unsigned char *bytes, size_t length, size_t n) noexcept
+    {
+        size_t  pos{0};
+
+        for (; pos + lead_block_size <= length; pos += lead_block_size)
         {
-            int     value{_map[*bytes]};
+            const auto      mask{lead_byte_mask(bytes + pos)};
+            const size_t    count{static_cast<size_t>(popcount(mask))};
 
-            if (value >= 0)
-                return 1;
-            else
-                return -value;
+            if (n < count)
+                return pos + static_cast<size_t>(select_bit(mask, static_cast<int>(n)));
+            n -= count;
+        }
+        for (; pos < length; ++pos)
+        {
+            if (!is_continuation(bytes[pos]) && n-- == 0)
+                return pos;
         }
 
-        return -1;
+        return length;
+    }
+
+    /// \brief  Find the nearest code point boundary at or before an offset.
+    /// \param bytes    Pointer to UTF-8 encoded text.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \param offset   Byte offset into the buffer.
+    /// \return The offset of the first byte of the code point that contains
+    ///         the byte at \p offset, or \p length if \p offset is at or
+    ///         past the end of the buffer.
+    /// \details    At most three bytes are examined, so a stray run of
+    ///             continuation bytes never causes a long backwards scan.
+    static size_t boundary_before(const unsigned char *bytes, size_t length, size_t offset) noexcept
+    {
+        if (offset >= length)
+            return length;
+
+        for (int i = 0; i < 3 && offset > 0 && is_continuation(bytes[offset]); ++i)
+            --offset;
+
+        return offset;
     }
 
 private:
-    bool is_valid(const unsigned char *bytes, int length) const noexcept
+    friend struct detail::Utf8FindInvalid;
+
+    static bool is_continuation(unsigned char b) noexcept
+    {
+        return (b & 0xC0) == 0x80;
+    }
+
+    // Bitmask of the bytes in a block that are not continuation bytes.
+    // Continuation bytes are the signed bytes below -64.
+#if defined(__AVX2__)
+    static constexpr size_t lead_block_size{32};
+
+    static uint32_t lead_byte_mask(const unsigned char *bytes) noexcept
     {
-        if (bytes == nullptr || length == 0)
-            return false;
+        const __m256i   v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes))};
 
-        unsigned char   ch;
-        const unsigned char *source = bytes + length;
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(-64), v)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    static constexpr size_t lead_block_size{16};
 
-        switch (length)
+    static uint32_t lead_byte_mask(const unsigned char *bytes) noexcept
+    {
+        const __m128i   v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes))};
+
+        return ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(v, _mm_set1_epi8(-64)))) & 0xFFFF;
+    }
+#else
+    static constexpr size_t lead_block_size{8};
+
+    static uint32_t lead_byte_mask(const unsigned char *bytes) noexcept
+    {
+        uint32_t    mask{0};
+
+        for (size_t i = 0; i < lead_block_size; ++i)
+            mask |= static_cast<uint32_t>(!is_continuation(bytes[i])) << i;
+
+        return mask;
+    }
+#endif
+
+    /// \cond
+    // Byte classes and state transitions for the scalar validator.
+    enum DfaState
+    {
+        dfa_accept   = 0,
+        dfa_reject   = 8
+    };
+
+    inline constexpr static uint8_t _dfa_class[256] {
+    /* 00 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 20 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 30 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 40 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 50 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 60 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 70 */    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 80 */    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* 90 */    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* A0 */    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    /* B0 */    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    /* C0 */   11,11, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* D0 */    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* E0 */    5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 6, 6,
+    /* F0 */    8, 9, 9, 9,10,11,11,11,11,11,11,11,11,11,11,11,
+    };
+
+    // Classes: 0 ASCII, 1 80-8F, 2 90-9F, 3 A0-BF, 4 C2-DF, 5 E0, 6 E1-EC/EE-EF,
+    //          7 ED, 8 F0, 9 F1-F3, 10 F4, 11 invalid
+    // States:  0 accept, 1-3 expecting that many continuation bytes,
+    //          4 after E0, 5 after ED, 6 after F0, 7 after F4, 8 reject
+    inline constexpr static uint8_t _dfa_transition[9][12] {
+        /* 0 */ {0, 8, 8, 8, 1, 4, 2, 5, 6, 3, 7, 8},
+        /* 1 */ {8, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 2 */ {8, 1, 1, 1, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 3 */ {8, 2, 2, 2, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 4 */ {8, 8, 8, 1, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 5 */ {8, 1, 1, 8, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 6 */ {8, 8, 2, 2, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 7 */ {8, 2, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8},
+        /* 8 */ {8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8},
+    };
+    /// \endcond
+
+    /// \brief  Validate a buffer with the scalar state machine.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \param pos      Offset of a character boundary at which to begin.
+    /// \return The offset of the first invalid sequence, or \p length.
+    static size_t find_invalid_scalar(const unsigned char *bytes, size_t length, size_t pos) noexcept
+    {
+        size_t  start{pos};
+        int     state{dfa_accept};
+
+        while (pos < length)
         {
-            default:
-                return false;
-            case 4:
-                if ((ch = (*--source)) < 0x80 || ch > 0xBF)
-                    return false;
-            case 3:
-                if ((ch = (*--source)) < 0x80 || ch > 0xBF)
-                    return false;
-            case 2:
+            if (state == dfa_accept)
             {
-                ch = (*--source);
-                switch (*bytes)
+                // Skip runs of ASCII eight bytes at a time.
+                uint64_t    word;
+
+                while (pos + 8 <= length)
                 {
-                    case 0xE0:
-                        if (ch < 0xA0 || ch > 0xBF)
-                            return false;
-                        break;
-                    case 0xED:
-                        if (ch < 0x80 || ch > 0x9F)
-                            return false;
-                        break;
-                    case 0xF0:
-                        if (ch < 0x90 || ch > 0xBF)
-                            return false;
+                    std::memcpy(&word, bytes + pos, 8);
+                    if (word & 0x8080808080808080ULL)
                         break;
-                    case 0xF4:
-                        if (ch < 0x80 || ch > 0x8F)
-                            return false;
-                        break;
-                    default:
-                        if (ch < 0x80 || ch > 0xBF)
-                            return false;
+                    pos += 8;
                 }
+                if (pos == length)
+                    break;
+                start = pos;
             }
-            case 1:
-                if (*bytes >= 0x80 && *bytes < 0xC2)
-                    return false;
+
+            state = _dfa_transition[state][_dfa_class[bytes[pos]]];
+            if (state == dfa_reject)
+                return start;
+            ++pos;
         }
-        return *bytes <= 0xF4;
+
+        return state == dfa_accept ? length : start;
     }
 
+    /// \brief  Find the start of the character containing the byte at \p pos,
+    ///         assuming the bytes before \p pos are valid UTF-8.
+    static size_t sequence_start(const unsigned char *bytes, size_t pos) noexcept
+    {
+        for (size_t k = 1; k <= 3 && k <= pos; ++k)
+        {
+            const unsigned char ch{bytes[pos - k]};
+
+            if (ch < 0x80)
+                break;
+            if (ch >= 0xC0)
+                return pos - k;
+        }
+
+        return pos;
+    }
+
+#if defined(__SSE4_1__) || defined(BRACE_RUNTIME_DISPATCH)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+    /// \brief  Validate a buffer 64 bytes at a time using vector instructions.
+    /// \tparam V   Vector traits for the instruction set to use.
+    /// \param bytes    Pointer to the bytes to be validated.
+    /// \param length   Number of bytes pointed to by \p bytes.
+    /// \return The offset of the first invalid sequence, or \p length.
+    /// \details    The vector code only determines whether a block contains an
+    ///             error. The block in which the first error is detected, and
+    ///             any partial block at the end of the buffer, are re-scanned by
+    ///             the scalar state machine to locate the exact offset.
+    template <typename V>
+    BRACE_ALWAYS_INLINE static size_t find_invalid_vector(const unsigned char *bytes, size_t length) noexcept
+    {
+        using vector = typename V::type;
+        constexpr size_t    block_size{64};
+        constexpr size_t    count{block_size / V::size};
+
+        size_t  pos{0};
+        vector  before{V::zero()};
+        vector  incomplete{V::zero()};
+
+        while (pos + block_size <= length)
+        {
+            vector  input[count];
+            vector  any_high{V::zero()};
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                input[i] = V::load(bytes + pos + i * V::size);
+                any_high = V::or_(any_high, input[i]);
+            }
+
+            vector  error{V::zero()};
+
+            if (V::is_ascii(any_high))
+            {
+                error = incomplete;
+                incomplete = V::zero();
+                before = V::zero();
+            }
+            else
+            {
+                detail::Utf8Check::check<V>(input[0], before, error);
+                for (size_t i = 1; i < count; ++i)
+                    detail::Utf8Check::check<V>(input[i], input[i - 1], error);
+                detail::Utf8Check::is_incomplete<V>(input[count - 1], incomplete);
+                before = input[count - 1];
+            }
+
+            if (V::any(error))
+                break;
+
+            pos += block_size;
+        }
+
+        return find_invalid_scalar(bytes, length, sequence_start(bytes, pos));
+    }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
     inline constexpr static const char *_names[] {
         "UTF-8",
         "UTF8"
@@ -243,6 +756,69 @@ private:
     };
 };
 
+/// \cond
+namespace detail {
+
+#if defined(BRACE_RUNTIME_DISPATCH)
+// Chooses the UTF8Encoding::find_invalid kernel for the running processor.
+// The kernels are flattened so that find_invalid_vector and Utf8Check are
+// compiled for the instruction set of the traits they are given.
+struct Utf8FindInvalid
+{
+    static size_t scalar(const unsigned char *bytes, size_t length) noexcept
+    {
+        return UTF8Encoding::find_invalid_scalar(bytes, length, 0);
+    }
+
+    BRACE_TARGET("sse4.1") BRACE_FLATTEN
+    static size_t sse41(const unsigned char *bytes, size_t length) noexcept
+    {
+        return UTF8Encoding::find_invalid_vector<Utf8VecSSE>(bytes, length);
+    }
+
+    BRACE_TARGET("avx2") BRACE_FLATTEN
+    static size_t avx2(const unsigned char *bytes, size_t length) noexcept
+    {
+        return UTF8Encoding::find_invalid_vector<Utf8VecAVX2>(bytes, length);
+    }
+
+    BRACE_TARGET("avx512f,avx512bw") BRACE_FLATTEN
+    static size_t avx512(const unsigned char *bytes, size_t length) noexcept
+    {
+        return UTF8Encoding::find_invalid_vector<Utf8VecAVX512>(bytes, length);
+    }
+
+    static auto select(const CpuFeatures &features) noexcept -> size_t (*)(const unsigned char *, size_t)
+    {
+        if (features.has(CpuFeature::AVX512F) && features.has(CpuFeature::AVX512BW))
+            return avx512;
+        if (features.has(CpuFeature::AVX2))
+            return avx2;
+        if (features.has(CpuFeature::SSE41) && features.has(CpuFeature::SSSE3))
+            return sse41;
+        return scalar;
+    }
+};
+#endif
+
+}   // namespace detail
+/// \endcond
+
+inline size_t UTF8Encoding::find_invalid(const unsigned char *bytes, size_t length) noexcept
+{
+#if defined(__AVX512BW__)
+    return find_invalid_vector<detail::Utf8VecAVX512>(bytes, length);
+#elif defined(BRACE_RUNTIME_DISPATCH)
+    return KernelDispatch<detail::Utf8FindInvalid, size_t(const unsigned char *, size_t)>::call(bytes, length);
+#elif defined(__AVX2__)
+    return find_invalid_vector<detail::Utf8VecAVX2>(bytes, length);
+#elif defined(__SSE4_1__)
+    return find_invalid_vector<detail::Utf8VecSSE>(bytes, length);
+#else
+    return find_invalid_scalar(bytes, length, 0);
+#endif
+}
+
 }
 
 #endif  // BRACE_LIB_UTF8_ENCODING_INC
@@ -1,7 +1,12 @@
 #define CATCH_CONFIG_MAIN
 #include "catch2/catch.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "brace/string.h"
 
@@ -30,3 +35,397 @@ TEST_CASE("Test to_lower")
         REQUIRE(brace::ci_compare(quieter_dog, louder_dog) == 0);
     }
 }
+
+TEST_CASE("Compare strings without regard to case")
+{
+    const std::string   lower{"content-type: text/plain; charset=utf-8; boundary=0123456789abcdefghijklmnop"};
+    const std::string   upper{brace::to_upper(lower)};
+
+    REQUIRE(brace::ci_equal(lower, upper));
+    REQUIRE(brace::ci_compare(lower, upper) == 0);
+    REQUIRE(brace::ci_starts_with(upper, "Content-Type:"));
+    REQUIRE_FALSE(brace::ci_starts_with(upper, "Content-Length"));
+    REQUIRE_FALSE(brace::ci_starts_with("Content", "Content-Type"));
+    REQUIRE(brace::ci_starts_with(lower, ""));
+    REQUIRE(brace::ci_equal("", ""));
+
+    // A difference at each position is found, and ordered the same way
+    // as by the generic comparison.
+    for (size_t i = 0; i < upper.size(); ++i)
+    {
+        std::string changed{upper};
+
+        changed[i] = changed[i] == '~' ? '}' : '~';
+        REQUIRE_FALSE(brace::ci_equal(lower, changed));
+        REQUIRE(brace::ci_compare(lower, changed) == brace::ci_compare<char>(std::string_view(lower), std::string_view(changed)));
+        REQUIRE(brace::ci_compare(changed, lower) == -brace::ci_compare(lower, changed));
+        REQUIRE(brace::ci_starts_with(lower, std::string_view(changed).substr(0, i)));
+        REQUIRE_FALSE(brace::ci_starts_with(lower, std::string_view(changed).substr(0, i + 1)));
+    }
+
+    // Only ASCII letters are folded.
+    REQUIRE_FALSE(brace::ci_equal("[\\]^_@", "{|}~\x7F`"));
+    REQUIRE_FALSE(brace::ci_equal("\xC0\xC9", "\xE0\xE9"));
+    REQUIRE(brace::ci_compare("abc", "ABCD") < 0);
+    REQUIRE(brace::ci_compare("abcd", "ABC") > 0);
+
+    REQUIRE(brace::ci_equal(std::u32string_view(U"Dog"), std::u32string_view(U"dOG")));
+    REQUIRE(brace::ci_starts_with(std::u16string_view(u"Dogma"), std::u16string_view(u"DOG")));
+}
+
+TEST_CASE("Find substrings without regard to case")
+{
+    const std::string   log{"2024-05-01 12:00:00 WARN  [net] Connection RESET by peer 10.0.0.1; retrying"};
+
+    REQUIRE(brace::ci_find(log, "connection reset") == log.find("Connection"));
+    REQUIRE(brace::ci_find(log, "warn") == 20);
+    REQUIRE(brace::ci_find(log, "WARN", 21) == std::string_view::npos);
+    REQUIRE(brace::ci_find(log, "") == 0);
+    REQUIRE(brace::ci_find(log, "", log.size()) == log.size());
+    REQUIRE(brace::ci_find(log, "x", log.size() + 1) == std::string_view::npos);
+    REQUIRE(brace::ci_contains(log, "RETRYING"));
+    REQUIRE_FALSE(brace::ci_contains(log, "error"));
+    REQUIRE_FALSE(brace::ci_contains("abc", "abcd"));
+    REQUIRE_FALSE(brace::ci_contains("[\\]^_@", "{|}~\x7F`"));
+    REQUIRE(brace::ci_find(std::u16string_view(u"Log: ERROR"), std::u16string_view(u"error")) == 5);
+    REQUIRE(brace::ci_contains(std::u32string_view(U"Log: ERROR"), std::u32string_view(U"G: e")));
+
+    // Compare against searching lower-case copies, with needles short
+    // enough for the vector filter and long enough for Horspool, over
+    // text with many near-matches.
+    const char      alphabet[]{"aAbB\xC1\xE1"};
+    uint32_t        seed{12345};
+    auto            random_string = [&](size_t length)
+                    {
+                        std::string str;
+
+                        for (size_t i = 0; i < length; ++i)
+                        {
+                            seed = seed * 1103515245 + 12345;
+                            str += alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+                        }
+                        return str;
+                    };
+
+    for (size_t needle_length : {1, 2, 3, 5, 8, 17, 31, 32, 40})
+    {
+        for (int trial = 0; trial < 200; ++trial)
+        {
+            const std::string   haystack{random_string(static_cast<size_t>(trial))};
+            const std::string   needle{random_string(needle_length)};
+            const size_t        pos{static_cast<size_t>(trial % 3)};
+
+            REQUIRE(brace::ci_find(haystack, needle, pos) == brace::to_lower(haystack).find(brace::to_lower(needle), pos));
+        }
+    }
+
+    // Needles found at every offset, including the very end.
+    const std::string   text(300, '.');
+
+    for (size_t needle_length : {1, 2, 16, 33})
+    {
+        const std::string   needle(needle_length, 'Q');
+
+        for (size_t at = 0; at + needle_length <= text.size(); at += 7)
+        {
+            std::string haystack{text};
+
+            haystack.replace(at, needle_length, std::string(needle_length, 'q'));
+            REQUIRE(brace::ci_find(haystack, needle) == at);
+        }
+    }
+}
+
+TEST_CASE("Hash strings without regard to case")
+{
+    brace::ci_hash  hash;
+
+    // Every byte hashes the same as its lower-case form, at every
+    // position within a word.
+    for (int ch = 0; ch < 256; ++ch)
+    {
+        for (size_t pos = 0; pos < 10; ++pos)
+        {
+            std::string s1(10, 'x');
+            std::string s2(10, 'x');
+
+            s1[pos] = static_cast<char>(ch);
+            s2[pos] = static_cast<char>(brace::Ascii::to_lower(ch));
+            REQUIRE(hash(s1) == hash(s2));
+            if (ch != 'x' && ch != 'X')
+                REQUIRE(hash(s1) != hash(std::string(10, 'x')));
+        }
+    }
+
+    REQUIRE(hash("") != hash(std::string_view("\0", 1)));
+    REQUIRE(hash("Accept-Encoding") != hash("Accept-Language"));
+
+    std::unordered_map<std::string, int, brace::ci_hash, brace::ci_equal_to> headers;
+
+    headers["Content-Type"] = 1;
+    headers["Content-Length"] = 2;
+    headers["CONTENT-TYPE"] = 3;
+
+    REQUIRE(headers.size() == 2);
+    REQUIRE(headers.at("content-type") == 3);
+    REQUIRE(headers.count("content-LENGTH") == 1);
+    REQUIRE(headers.count("content-encoding") == 0);
+}
+
+TEST_CASE("Convert case in place")
+{
+    // Every byte value, at every position relative to a vector boundary.
+    std::string all;
+
+    for (int i = 0; i < 3; ++i)
+        for (int ch = 0; ch < 256; ++ch)
+            all += static_cast<char>(ch);
+
+    for (size_t start = 0; start < 70; ++start)
+    {
+        std::string upper{all.substr(start)};
+        std::string lower{upper};
+        std::string buffer(upper.size(), '\0');
+
+        std::string expected_upper;
+        std::string expected_lower;
+
+        for (size_t i = start; i < all.size(); ++i)
+        {
+            const auto  ch{static_cast<unsigned char>(all[i])};
+
+            expected_upper += static_cast<char>(brace::Ascii::to_upper(ch));
+            expected_lower += static_cast<char>(brace::Ascii::to_lower(ch));
+        }
+
+        brace::to_upper_in_place(upper);
+        brace::to_lower_in_place(lower);
+        REQUIRE(upper == expected_upper);
+        REQUIRE(lower == expected_lower);
+
+        REQUIRE(brace::to_upper(std::string_view(all).substr(start), buffer.data()) == buffer.size());
+        REQUIRE(buffer == upper);
+        REQUIRE(brace::to_lower(upper, buffer.data()) == buffer.size());
+        REQUIRE(buffer == lower);
+    }
+
+    std::u32string  wide{U"Straße Łódź"};
+    brace::to_upper_in_place(wide);
+    REQUIRE(wide == U"STRAßE ŁóDź");
+    REQUIRE(brace::to_lower(wide) == U"straße Łódź");
+}
+
+TEST_CASE("Scan for character classes")
+{
+    using brace::Ascii;
+
+    // Runs of each class, with bytes above 0x7F mixed in.
+    std::string text;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        text += "   \t\r\n";
+        text += "identifier_" + std::to_string(i * 7919);
+        text += "(){}[];";
+        text += "\xC3\xA9\x80\xFF";
+        text += std::string(static_cast<size_t>(i * 5), ' ');
+    }
+
+    const int   classes[] {Ascii::SPACE, Ascii::DIGIT, Ascii::ALPHA | Ascii::DIGIT, Ascii::PUNCT,
+                           Ascii::CONTROL, Ascii::UPPER, Ascii::PRINT, Ascii::SPACE | Ascii::PUNCT | Ascii::LOWER,
+                           Ascii::HEXDIGIT | Ascii::CONTROL, 0};
+
+    for (int props : classes)
+    {
+        for (size_t start = 0; start < text.size(); ++start)
+        {
+            const std::string_view  str{std::string_view(text).substr(start)};
+            size_t                  first{str.size()};
+            size_t                  first_not{str.size()};
+            size_t                  count{0};
+
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                const bool  in_class{Ascii::has_property(static_cast<unsigned char>(str[i]), props)};
+
+                if (in_class && first == str.size())
+                    first = i;
+                if (!in_class && first_not == str.size())
+                    first_not = i;
+                count += in_class;
+            }
+
+            REQUIRE(Ascii::find_first(str, props) == first);
+            REQUIRE(Ascii::find_first_not(str, props) == first_not);
+            REQUIRE(Ascii::span(str, props) == first_not);
+            REQUIRE(Ascii::count(str, props) == count);
+        }
+    }
+
+    REQUIRE(Ascii::span("    x", Ascii::SPACE) == 4);
+    REQUIRE(Ascii::find_first("abc", Ascii::DIGIT) == 3);
+    REQUIRE(Ascii::count("", Ascii::ALPHA) == 0);
+}
+
+TEST_CASE("Split strings into views")
+{
+    using Pieces = std::vector<std::string_view>;
+
+    auto    collect = [](const brace::SplitRange &range)
+            {
+                return Pieces(range.begin(), range.end());
+            };
+
+    REQUIRE(collect(brace::split("a,b,,c", ',')) == Pieces{"a", "b", "", "c"});
+    REQUIRE(collect(brace::split(",a,", ',')) == Pieces{"", "a", ""});
+    REQUIRE(collect(brace::split("", ',')) == Pieces{""});
+    REQUIRE(collect(brace::split("abc", ',')) == Pieces{"abc"});
+    REQUIRE(collect(brace::split(" a , b ,, c ", ',', brace::SplitOptions::Trim | brace::SplitOptions::SkipEmpty))
+            == Pieces{"a", "b", "c"});
+    REQUIRE(collect(brace::split("k1=v1;k2=v2&k3", ";&")) == Pieces{"k1=v1", "k2=v2", "k3"});
+    REQUIRE(collect(brace::tokenize("  the quick\tbrown\r\n fox  ")) == Pieces{"the", "quick", "brown", "fox"});
+    REQUIRE(collect(brace::tokenize(" \t ")).empty());
+    REQUIRE(collect(brace::tokenize("//usr//local/", "/")) == Pieces{"usr", "local"});
+
+    REQUIRE(brace::trim("  \tx y\n") == "x y");
+    REQUIRE(brace::trim_left("  x ") == "x ");
+    REQUIRE(brace::trim_right("  x ") == "  x");
+    REQUIRE(brace::trim("   ").empty());
+
+    // Long lines, with delimiters on both sides of every vector boundary.
+    std::string line;
+    Pieces      expected;
+
+    for (size_t i = 0; i < 40; ++i)
+        line += std::string(i, static_cast<char>('a' + i % 26)) + (i % 3 ? "," : ";");
+    for (auto piece : brace::split(line, ',', brace::SplitOptions::None))
+    {
+        REQUIRE(piece.data() >= line.data());
+        REQUIRE(piece.data() + piece.size() <= line.data() + line.size());
+        REQUIRE(piece.find(',') == std::string_view::npos);
+        expected.push_back(piece);
+    }
+    REQUIRE(expected.size() == 26 + 1);
+
+    const std::string   many_delimiters{";,:|/\\!?#&=+-*%^~"};
+    size_t              count{0};
+
+    for (auto piece : brace::split(line, many_delimiters))
+    {
+        REQUIRE(piece.find_first_of(many_delimiters) == std::string_view::npos);
+        ++count;
+    }
+    REQUIRE(count == 41);
+
+    // The end of the input is reached exactly once.
+    auto    range{brace::split("x,y", ',')};
+    auto    it{range.begin()};
+    REQUIRE(*it++ == "x");
+    REQUIRE(*it == "y");
+    REQUIRE(++it == range.end());
+}
+
+TEST_CASE("Parse and format numbers")
+{
+    int32_t     i32{0};
+    uint64_t    u64{0};
+    int64_t     i64{0};
+    uint8_t     u8{0};
+
+    REQUIRE(brace::parse_integer("12345,", i32).position == 5);
+    REQUIRE(i32 == 12345);
+    REQUIRE(brace::parse_integer("-2147483648", i32).ok());
+    REQUIRE(i32 == std::numeric_limits<int32_t>::min());
+    REQUIRE(brace::parse_integer("+7", i32).ok());
+    REQUIRE(i32 == 7);
+
+    auto    rv{brace::parse_integer("2147483648 x", i32)};
+
+    REQUIRE(rv.status == brace::ParseStatus::OutOfRange);
+    REQUIRE(rv.position == 10);
+    REQUIRE(i32 == 7);
+
+    rv = brace::parse_integer("-x", i32);
+    REQUIRE(rv.status == brace::ParseStatus::Invalid);
+    REQUIRE(rv.position == 1);
+    REQUIRE(brace::parse_integer("-1", u64).status == brace::ParseStatus::Invalid);
+    REQUIRE(brace::parse_integer("", u64).status == brace::ParseStatus::Invalid);
+    REQUIRE(brace::parse_integer("256", u8).status == brace::ParseStatus::OutOfRange);
+
+    REQUIRE(brace::parse_integer("18446744073709551615", u64).ok());
+    REQUIRE(u64 == UINT64_MAX);
+    REQUIRE(brace::parse_integer("18446744073709551616", u64).status == brace::ParseStatus::OutOfRange);
+    REQUIRE(brace::parse_integer("000000000000000000000000000000042", u64).ok());
+    REQUIRE(u64 == 42);
+
+    REQUIRE(brace::parse_hex("DeadBeef-", u64).position == 8);
+    REQUIRE(u64 == 0xDEADBEEF);
+    REQUIRE(brace::parse_hex("ffffffffffffffff", u64).ok());
+    REQUIRE(u64 == UINT64_MAX);
+    REQUIRE(brace::parse_hex("10000000000000000", u64).status == brace::ParseStatus::OutOfRange);
+    REQUIRE(brace::parse_hex("-80", i32).ok());
+    REQUIRE(i32 == -128);
+    REQUIRE(brace::parse_hex("0x10", i32).position == 1);
+
+    // Every length of digit run, through the vector, SWAR and scalar
+    // steps, in a field followed by more text.
+    char    buffer[brace::max_integer_chars];
+
+    for (uint64_t value = 1, n = 1; n <= 20; value = value * 10 + (n++ % 10))
+    {
+        const std::string   text{std::to_string(value)};
+        const std::string   field{text + ";" + text};
+
+        REQUIRE(brace::parse_integer(field, u64).position == text.size());
+        REQUIRE(u64 == value);
+        REQUIRE(std::string(buffer, brace::format_integer(value, buffer)) == text);
+        REQUIRE(brace::parse_hex(std::string_view(buffer, brace::format_hex(value, buffer)), u64).ok());
+        REQUIRE(u64 == value);
+    }
+    for (int64_t value : {INT64_MIN, int64_t{-100}, int64_t{-9}, int64_t{0}, int64_t{99}, INT64_MAX})
+    {
+        REQUIRE(std::string(buffer, brace::format_integer(value, buffer)) == std::to_string(value));
+        REQUIRE(brace::parse_hex(std::string_view(buffer, brace::format_hex(value, buffer)), i64).ok());
+        REQUIRE(i64 == value);
+    }
+    REQUIRE(std::string(buffer, brace::format_hex(uint16_t{0xABCD}, buffer)) == "abcd");
+
+    double  d{0};
+
+    REQUIRE(brace::parse_float("3.25 ms", d).position == 4);
+    REQUIRE(d == 3.25);
+    REQUIRE(brace::parse_float("-.5e1x", d).position == 5);
+    REQUIRE(d == -5.0);
+    REQUIRE(brace::parse_float("7.e", d).position == 2);
+    REQUIRE(d == 7.0);
+    REQUIRE(brace::parse_float("1e+", d).position == 1);
+    REQUIRE(brace::parse_float(".", d).status == brace::ParseStatus::Invalid);
+    REQUIRE(brace::parse_float("-e5", d).position == 1);
+    REQUIRE(brace::parse_float("1e999", d).status == brace::ParseStatus::OutOfRange);
+    REQUIRE(brace::parse_float("0e999", d).ok());
+    REQUIRE(d == 0.0);
+    REQUIRE(brace::parse_float("-Infinity", d).position == 9);
+    REQUIRE(d == -std::numeric_limits<double>::infinity());
+    REQUIRE(brace::parse_float("NaN", d).ok());
+    REQUIRE(std::isnan(d));
+
+    // Values on the exact and the correctly rounded paths.
+    const char *values[]{"0.1", "123456789012345678901234567890", "2.2250738585072014e-308",
+                         "1.7976931348623157e308", "9007199254740993", "4.9e-324",
+                         "0.000000000000000000000000000001", "299792458", "6.02214076e23"};
+
+    for (const char *text : values)
+    {
+        REQUIRE(brace::parse_float(text, d).ok());
+        REQUIRE(d == std::strtod(text, nullptr));
+    }
+
+    // Formatting gives text that parses back to the same value.
+    char    fbuffer[brace::max_float_chars];
+
+    for (double value : {0.1, -1.5, 1e100, 5e-324, -1.7976931348623157e308, 1.0 / 3.0})
+    {
+        REQUIRE(brace::parse_float(std::string_view(fbuffer, brace::format_float(value, fbuffer)), d).ok());
+        REQUIRE(d == value);
+    }
+}
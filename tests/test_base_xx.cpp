@@ -2,8 +2,10 @@
 #include "catch2/catch.hpp"
 
 #include <filesystem>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -12,6 +14,7 @@
 #include "brace/base64.h"
 #include "brace/binastream.h"
 #include "brace/binfstream.h"
+#include "brace/utf8_encoding.h"
 
 std::string test_data64[][2] = {
     {"",            ""},
@@ -327,3 +330,145 @@ TEST_CASE("Test Base16 encoding from external file", "[base16]")
 
     test_encoding_from_external_file(brace::Base16{}, path, head, tail);
 }
+
+template<typename T>
+void test_arena_round_trip(const T &coder, const std::string &word, std::string_view result)
+{
+    // The arena has no upstream, so any allocation from the global heap
+    // would throw std::bad_alloc instead.
+    char                                buffer[1024];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof buffer, std::pmr::null_memory_resource()};
+
+    std::pmr::string    enc{coder.encode(word.begin(), word.end(), &arena)};
+    REQUIRE(enc == result);
+    REQUIRE(enc.get_allocator().resource() == &arena);
+
+    std::pmr::vector<uint8_t>   dec{coder.decode(result, &arena)};
+    REQUIRE(std::string(dec.begin(), dec.end()) == word);
+
+    brace::BinIArrayStream  stream((uint8_t *)word.data(), (uint8_t *)word.data() + word.size());
+    REQUIRE(coder.encode(stream, &arena) == result);
+
+    std::istringstream  encstream{std::string{result}};
+    REQUIRE(coder.decode(encstream, &arena) == dec);
+
+    REQUIRE_THROWS_AS(coder.decode("#", &arena), brace::BasicParseError);
+}
+
+TEST_CASE("Encode and decode using a memory resource", "[pmr]")
+{
+    for (const auto &[word, result] : test_data64)
+        test_arena_round_trip(brace::Base64{}, word, result);
+    for (const auto &[word, result] : test_data32)
+        test_arena_round_trip(brace::Base32{}, word, result);
+    for (const auto &[word, result] : test_data16)
+        test_arena_round_trip(brace::Base16{}, word, result);
+}
+
+template<typename T>
+void test_try_decode(const T &coder, const std::string &word, const std::string &result)
+{
+    std::vector<uint8_t>        out;
+    brace::CodecDecodeResult    status{coder.try_decode(result, out)};
+
+    REQUIRE(status);
+    REQUIRE(status.size == word.size());
+    REQUIRE(std::string(out.begin(), out.end()) == word);
+
+    // Bytes are appended.
+    status = coder.try_decode(result, out);
+    REQUIRE(status.ok());
+    REQUIRE(out.size() == 2 * word.size());
+
+    std::vector<uint8_t>    buffer(64);
+    brace::BinOArrayStream  outstream(buffer.data(), buffer.size());
+    std::istringstream      instream{result};
+
+    status = coder.try_decode(instream, outstream);
+    REQUIRE(status.ok());
+    REQUIRE(status.size == word.size());
+    REQUIRE(std::string(buffer.begin(), buffer.begin() + status.size) == word);
+}
+
+template<typename T>
+void test_try_decode_errors(const T &coder, std::string_view valid)
+{
+    // An invalid character on the second line, third position.
+    std::string             bad{std::string{valid} + "\n" + std::string{valid}};
+    std::vector<uint8_t>    out;
+
+    bad[valid.size() + 3] = '!';
+
+    brace::CodecDecodeResult status{coder.try_decode(bad, out, true)};
+
+    REQUIRE_FALSE(status);
+    REQUIRE(status.error == brace::CodecDecodeError::InvalidCharacter);
+    REQUIRE(status.line == 2);
+    REQUIRE(status.position == 3);
+    REQUIRE(std::string_view{status.message} == "Invalid character");
+
+    // The throwing form reports the same error.
+    try
+    {
+        (void)coder.decode(bad, true);
+        FAIL("decode did not throw");
+    }
+    catch (const brace::BasicParseError &err)
+    {
+        REQUIRE(err.line() == status.line);
+        REQUIRE(err.position() == status.position);
+    }
+
+    // A newline is invalid unless requested.
+    std::istringstream  instream{bad};
+
+    status = coder.try_decode(instream, out);
+    REQUIRE(status.error == brace::CodecDecodeError::InvalidCharacter);
+    REQUIRE(status.line == 1);
+}
+
+TEST_CASE("Decode without throwing", "[try_decode]")
+{
+    // The codec result is distinct from the text encoding DecodeResult, and
+    // both headers can be used together.
+    static_assert(!std::is_same_v<brace::CodecDecodeResult, brace::DecodeResult>);
+
+    for (const auto &[word, result] : test_data64)
+        test_try_decode(brace::Base64{}, word, result);
+    for (const auto &[word, result] : test_data32)
+        test_try_decode(brace::Base32{}, word, result);
+    for (const auto &[word, result] : test_data16)
+        test_try_decode(brace::Base16{}, word, result);
+
+    test_try_decode_errors(brace::Base64{}, "Zm9vYmFy");
+    test_try_decode_errors(brace::Base32{}, "MZXW6YTB");
+    test_try_decode_errors(brace::Base16{}, "666F6F626172");
+
+    std::vector<uint8_t>    out;
+
+    REQUIRE(brace::Base64().try_decode("Zm9vYmE", out).error == brace::CodecDecodeError::InvalidLength);
+    REQUIRE(brace::Base16().try_decode("666", out).error == brace::CodecDecodeError::InvalidLength);
+    REQUIRE_THROWS_AS(brace::Base16().decode("666"), brace::BasicParseError);
+
+    // Writing past the end of the output is reported, not thrown.
+    uint8_t                 small[2];
+    brace::BinOArrayStream  outstream(small, sizeof small);
+
+    REQUIRE(brace::Base64().try_decode("Zm9vYmFy", outstream).error == brace::CodecDecodeError::OutputFailed);
+
+    char                                arena_buffer[256];
+    std::pmr::monotonic_buffer_resource arena{arena_buffer, sizeof arena_buffer, std::pmr::null_memory_resource()};
+    std::pmr::vector<uint8_t>           pmr_out{&arena};
+
+    REQUIRE(brace::Base32Hex().try_decode("CPNMUOJ1", pmr_out).ok());
+    REQUIRE(std::string(pmr_out.begin(), pmr_out.end()) == "fooba");
+
+    // Rejected input allocates nothing, so it is reported even when the
+    // output cannot allocate at all.
+    std::pmr::vector<uint8_t>   no_memory{std::pmr::null_memory_resource()};
+
+    REQUIRE(brace::Base64().try_decode("!!!!!!!!", no_memory).error == brace::CodecDecodeError::InvalidCharacter);
+    REQUIRE(brace::Base32().try_decode("!!!!!!!!", no_memory).error == brace::CodecDecodeError::InvalidCharacter);
+    REQUIRE(brace::Base16().try_decode("!!!!!!!!", no_memory).error == brace::CodecDecodeError::InvalidCharacter);
+    REQUIRE(no_memory.empty());
+}
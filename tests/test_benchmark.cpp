@@ -0,0 +1,137 @@
+#define CATCH_CONFIG_MAIN
+#include "catch2/catch.hpp"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "brace/benchmark.h"
+
+using brace::PerfEvent;
+
+TEST_CASE("Register and run benchmarks")
+{
+    brace::BenchmarkRegistry    registry;
+    uint64_t                    calls{0};
+    uint64_t                    batched{0};
+
+    registry.add("test/per-op", 64, [&calls] { return ++calls; });
+    registry.add("test/batch", 0, [&batched](uint64_t n) { batched += n; });
+    registry.add("other/void", 0, [&calls] { ++calls; });
+
+    REQUIRE(registry.benchmarks().size() == 3);
+    REQUIRE(registry.benchmarks()[1].name == "test/batch");
+
+    brace::BenchmarkOptions options;
+
+    options.filter = "test/";
+    options.min_time = 0.01;
+    options.repetitions = 3;
+
+    const auto  results{brace::run_benchmarks(registry, options)};
+
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].name == "test/per-op");
+    REQUIRE(results[1].name == "test/batch");
+
+    for (const auto &result : results)
+    {
+        REQUIRE(result.iterations > 0);
+        REQUIRE(result.repetitions == 3);
+        REQUIRE(result.ns_per_op > 0);
+        REQUIRE(result.ns_per_op <= result.median_ns_per_op);
+    }
+
+    // Every operation is run: the calibrating runs, then the timed runs.
+    REQUIRE(calls >= 3 * results[0].iterations);
+    REQUIRE(batched >= 3 * results[1].iterations);
+
+    REQUIRE(results[0].bytes_per_second());
+    REQUIRE(*results[0].bytes_per_second() == Approx(64e9 / results[0].ns_per_op));
+    REQUIRE_FALSE(results[1].bytes_per_second());
+    REQUIRE_FALSE(results[1].cycles_per_byte());
+}
+
+TEST_CASE("Derive rates from counts")
+{
+    brace::BenchmarkResult  result;
+
+    result.bytes_per_op = 100;
+    result.ns_per_op = 50;
+    result.per_op[PerfEvent::Cycles] = 200;
+    result.per_op[PerfEvent::Instructions] = 500;
+
+    REQUIRE(*result.bytes_per_second() == Approx(2e9));
+    REQUIRE(*result.cycles_per_byte() == Approx(2.0));
+    REQUIRE(*result.instructions_per_cycle() == Approx(2.5));
+
+    // Time stamp counter ticks are not core cycles, so give no IPC.
+    result.tsc_cycles = true;
+    REQUIRE_FALSE(result.instructions_per_cycle());
+}
+
+TEST_CASE("Read hardware counters when available")
+{
+    brace::PerfCounters counters;
+
+    counters.start();
+
+    uint64_t    sum{0};
+
+    for (uint64_t i = 0; i < 100000; ++i)
+    {
+        sum += i * i;
+        brace::do_not_optimize(sum);
+    }
+
+    const auto  counts{counters.stop()};
+
+    for (size_t e = 0; e < brace::perf_event_count; ++e)
+    {
+        const auto  event{static_cast<PerfEvent>(e)};
+
+        if (!counters.available(event))
+            REQUIRE_FALSE(counts[event]);
+    }
+    if (counts[PerfEvent::Instructions])
+        REQUIRE(*counts[PerfEvent::Instructions] >= 100000);
+}
+
+TEST_CASE("Write results as JSON")
+{
+    brace::BenchmarkResult  result;
+
+    result.name = "quote\"back\\slash";
+    result.bytes_per_op = 10;
+    result.iterations = 7;
+    result.repetitions = 1;
+    result.ns_per_op = 2.5;
+    result.median_ns_per_op = 2.5;
+    result.per_op[PerfEvent::BranchMisses] = 0.25;
+
+    std::ostringstream  out;
+
+    brace::write_json(out, {result});
+
+    const std::string   json{out.str()};
+
+    REQUIRE(json.find("\"context\": {") != std::string::npos);
+    REQUIRE(json.find("\"name\": \"quote\\\"back\\\\slash\"") != std::string::npos);
+    REQUIRE(json.find("\"bytes_per_op\": 10, \"iterations\": 7") != std::string::npos);
+    REQUIRE(json.find("\"ns_per_op\": 2.5,") != std::string::npos);
+    REQUIRE(json.find("\"bytes_per_second\": 4e+09,") != std::string::npos);
+    REQUIRE(json.find("\"ipc\": null") != std::string::npos);
+    REQUIRE(json.find("\"branch_misses_per_op\": 0.25") != std::string::npos);
+    REQUIRE(json.find("\"llc_misses_per_op\": null}") != std::string::npos);
+
+    std::ostringstream  empty;
+
+    brace::write_json(empty, {});
+    REQUIRE(empty.str().find("\"benchmarks\": []") != std::string::npos);
+
+    std::ostringstream  table;
+
+    brace::write_table(table, {result});
+    REQUIRE(table.str().find("quote\"back\\slash") != std::string::npos);
+}
@@ -0,0 +1,404 @@
+#define CATCH_CONFIG_MAIN
+#include "catch2/catch.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "brace/binastream.h"
+#include "brace/bits.h"
+#include "brace/packed_array.h"
+#include "brace/rank_select.h"
+
+namespace {
+
+// A simple deterministic generator of test words.
+uint64_t next_word(uint64_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Whether brace::popcount accepts a T, as std::popcount accepts only
+// unsigned integer types.
+template <typename T, typename = void>
+struct can_popcount : std::false_type {};
+
+template <typename T>
+struct can_popcount<T, std::void_t<decltype(brace::popcount(std::declval<T>()))>> : std::true_type {};
+
+}
+
+TEST_CASE("Count and reverse bits")
+{
+    static_assert(brace::popcount(uint64_t{0xFF00FF00FF00FF00}) == 32);
+    static_assert(brace::countr_zero(uint32_t{0x80}) == 7);
+    static_assert(brace::countl_zero(uint64_t{1}) == 63);
+    static_assert(brace::bit_reverse(uint32_t{1}) == 0x80000000);
+    static_assert(brace::byte_prefix_sums(0x0101010101010101) == 0x0807060504030201);
+
+    REQUIRE(brace::countr_zero(uint32_t{0}) == 32);
+    REQUIRE(brace::countr_zero(uint64_t{0}) == 64);
+    REQUIRE(brace::countl_zero(uint32_t{0}) == 32);
+    REQUIRE(brace::countl_zero(uint64_t{0}) == 64);
+
+    // Every unsigned integer type is accepted, and narrower types count
+    // only their own bits.
+    static_assert(brace::popcount(1ULL) == 1);
+    static_assert(brace::popcount(~0UL) == 8 * sizeof(unsigned long));
+    static_assert(brace::popcount(uint8_t{0xFF}) == 8);
+    static_assert(brace::countr_zero(uint8_t{0}) == 8);
+    static_assert(brace::countr_zero(uint16_t{0x100}) == 8);
+    static_assert(brace::countr_zero(1ULL << 40) == 40);
+    static_assert(brace::countl_zero(uint8_t{1}) == 7);
+    static_assert(brace::countl_zero(uint16_t{0}) == 16);
+    static_assert(brace::countl_zero(1ULL) == 63);
+    static_assert(!can_popcount<int>::value);
+    static_assert(!can_popcount<bool>::value);
+    static_assert(can_popcount<unsigned long long>::value);
+    static_assert(brace::bit_reverse(1ULL) == 1ULL << 63);
+    static_assert(brace::bit_reverse(1UL) == 1UL << (8 * sizeof(unsigned long) - 1));
+    static_assert(brace::bit_reverse(uint8_t{0x01}) == 0x80);
+    static_assert(brace::bit_reverse(uint8_t{0xC4}) == 0x23);
+    static_assert(brace::bit_reverse(uint16_t{0x0003}) == 0xC000);
+    static_assert(std::is_same_v<decltype(brace::bit_reverse(uint16_t{0})), uint16_t>);
+
+    uint64_t    state{0x9E3779B97F4A7C15};
+
+    for (int trial = 0; trial < 1000; ++trial)
+    {
+        const uint64_t  word{next_word(state) >> (trial % 64)};
+        int             count{0};
+        int             low{64};
+        int             high{-1};
+        uint64_t        reversed{0};
+        uint64_t        sums{0};
+        unsigned        running{0};
+
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if ((word >> bit) & 1)
+            {
+                ++count;
+                low = low == 64 ? bit : low;
+                high = bit;
+                reversed |= uint64_t{1} << (63 - bit);
+            }
+        }
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            running += static_cast<unsigned>(brace::popcount(static_cast<uint32_t>((word >> (8 * byte)) & 0xFF)));
+            sums |= uint64_t{running} << (8 * byte);
+        }
+
+        REQUIRE(brace::popcount(word) == count);
+        REQUIRE(brace::countr_zero(word) == low);
+        REQUIRE(brace::countl_zero(word) == 63 - high);
+        REQUIRE(brace::countl_zero(static_cast<uint32_t>(word)) == brace::countl_zero(word << 32 | 0xFFFFFFFF));
+        REQUIRE(brace::bit_reverse(word) == reversed);
+        REQUIRE(brace::bit_reverse(static_cast<uint32_t>(word)) == static_cast<uint32_t>(reversed >> 32));
+        REQUIRE(brace::byte_prefix_sums(brace::byte_popcounts(word)) == sums);
+    }
+}
+
+TEST_CASE("Deposit and extract bits")
+{
+    REQUIRE(brace::deposit_bits(0b101, 0b11100) == 0b10100);
+    REQUIRE(brace::extract_bits(0b10100, 0b11100) == 0b101);
+    REQUIRE(brace::deposit_bits(~uint64_t{0}, 0) == 0);
+    REQUIRE(brace::extract_bits(~uint64_t{0}, ~uint64_t{0}) == ~uint64_t{0});
+
+    uint64_t    state{12345};
+
+    for (int trial = 0; trial < 1000; ++trial)
+    {
+        const uint64_t  word{next_word(state)};
+        const uint64_t  mask{next_word(state) & next_word(state)};
+        const int       n{brace::popcount(mask)};
+        const uint64_t  low{n == 64 ? word : word & ((uint64_t{1} << n) - 1)};
+
+        REQUIRE(brace::extract_bits(brace::deposit_bits(word, mask), mask) == low);
+        REQUIRE(brace::deposit_bits(brace::extract_bits(word, mask), mask) == (word & mask));
+        REQUIRE(brace::popcount(brace::extract_bits(word, mask)) == brace::popcount(word & mask));
+
+        for (int k = 0; k < n; k += 5)
+        {
+            const int   bit{brace::select_bit(mask, k)};
+
+            REQUIRE(((mask >> bit) & 1) == 1);
+            REQUIRE(brace::popcount(mask & ((uint64_t{1} << bit) - 1)) == k);
+        }
+    }
+}
+
+TEST_CASE("Combine arrays of bits")
+{
+    uint64_t    state{777};
+
+    for (size_t count : {0, 1, 3, 4, 5, 16, 33})
+    {
+        std::vector<uint64_t>   a(count);
+        std::vector<uint64_t>   b(count);
+        std::vector<uint64_t>   dst(count);
+        size_t                  expected{0};
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            a[i] = next_word(state);
+            b[i] = next_word(state);
+            expected += static_cast<size_t>(brace::popcount(a[i]));
+        }
+
+        REQUIRE(brace::popcount(a.data(), count) == expected);
+
+        brace::bitwise_and(dst.data(), a.data(), b.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(dst[i] == (a[i] & b[i]));
+        brace::bitwise_or(dst.data(), a.data(), b.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(dst[i] == (a[i] | b[i]));
+        brace::bitwise_xor(dst.data(), a.data(), b.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(dst[i] == (a[i] ^ b[i]));
+
+        // The destination may be one of the operands.
+        std::vector<uint64_t>   original{a};
+
+        brace::bitwise_and_not(a.data(), a.data(), b.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(a[i] == (original[i] & ~b[i]));
+    }
+}
+
+TEST_CASE("Rank and select in a bit vector")
+{
+    uint64_t    state{4242};
+
+    REQUIRE(brace::RankSelect{}.rank(0) == 0);
+    REQUIRE(brace::RankSelect{}.select(0) == brace::RankSelect::npos);
+
+    // Sizes around word, block and superblock boundaries, at densities
+    // from very sparse (so select spans many superblocks between samples)
+    // to full.
+    for (size_t size : {1, 63, 64, 65, 511, 512, 2047, 2048, 2049, 10000, 100000})
+    {
+        for (int density : {0, 1, 8, 32, 63, 64})
+        {
+            std::vector<uint64_t>   words((size + 63) / 64);
+
+            for (auto &word : words)
+            {
+                for (int k = 0; k < 64; ++k)
+                    word = (word << 1) | ((next_word(state) % 64) < static_cast<uint64_t>(density) ? 1 : 0);
+            }
+
+            const brace::RankSelect bits{words, size};
+            std::vector<size_t>     ones;
+
+            for (size_t pos = 0; pos < size; ++pos)
+            {
+                REQUIRE(bits.rank(pos) == ones.size());
+                if ((words[pos / 64] >> (pos % 64)) & 1)
+                {
+                    REQUIRE(bits[pos]);
+                    ones.push_back(pos);
+                }
+            }
+            REQUIRE(bits.rank(size) == ones.size());
+            REQUIRE(bits.rank_zero(size) == size - ones.size());
+            REQUIRE(bits.count() == ones.size());
+
+            for (size_t n = 0; n < ones.size(); ++n)
+                REQUIRE(bits.select(n) == ones[n]);
+            REQUIRE(bits.select(ones.size()) == brace::RankSelect::npos);
+        }
+    }
+
+    // Bits past the size are ignored.
+    const brace::RankSelect trimmed{std::vector<uint64_t>{~uint64_t{0}}, 10};
+
+    REQUIRE(trimmed.count() == 10);
+    REQUIRE(trimmed.select(9) == 9);
+}
+
+TEST_CASE("Serialize a rank/select bit vector")
+{
+    std::vector<uint64_t>   words(100);
+    uint64_t                state{99};
+
+    for (auto &word : words)
+        word = next_word(state);
+
+    const brace::RankSelect original{words, 6000};
+
+    for (brace::Endian endian : {brace::Endian::Little, brace::Endian::Big})
+    {
+        std::vector<unsigned char>  buffer(2048);
+        brace::BinArrayStream       stream{buffer.data(), buffer.size()};
+        brace::RankSelect           copy;
+
+        stream.endian(endian);
+        stream << original;
+        stream.seekg(0);
+        stream >> copy;
+
+        REQUIRE(stream);
+        REQUIRE(copy.size() == original.size());
+        REQUIRE(copy.words() == original.words());
+        REQUIRE(copy.count() == original.count());
+        REQUIRE(copy.select(copy.count() / 2) == original.select(original.count() / 2));
+    }
+
+    // A truncated stream leaves the bit vector unchanged.
+    std::vector<unsigned char>  small(100);
+    brace::BinArrayStream       stream{small.data(), small.size()};
+    brace::RankSelect           copy{original};
+
+    stream << uint64_t{6000};
+    stream.seekg(0);
+    stream >> copy;
+
+    REQUIRE_FALSE(stream);
+    REQUIRE(copy.words() == original.words());
+
+    // Sizes from a corrupt stream, including one whose word count would
+    // wrap and one far larger than the stream, fail without allocating
+    // for them.
+    for (uint64_t size : {~uint64_t{0}, ~uint64_t{0} - 62, uint64_t{1} << 62})
+    {
+        brace::BinArrayStream   corrupt{small.data(), small.size()};
+
+        corrupt << size << uint64_t{0xFF};
+        corrupt.seekg(0);
+        corrupt >> copy;
+
+        REQUIRE_FALSE(corrupt);
+        REQUIRE(copy.size() == original.size());
+        REQUIRE(copy.words() == original.words());
+    }
+
+    REQUIRE(brace::RankSelect::word_count(~size_t{0}) == (~size_t{0} >> 6) + 1);
+}
+
+TEST_CASE("Pack integers of a fixed width")
+{
+    REQUIRE_THROWS_AS(brace::PackedArray(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(brace::PackedArray(33), std::invalid_argument);
+    REQUIRE_THROWS_AS(brace::PackedArray(64), std::invalid_argument);
+    REQUIRE_THROWS_AS(brace::PackedArray(200, 10), std::invalid_argument);
+
+    uint64_t    state{31337};
+
+    for (unsigned width = 1; width <= brace::PackedArray::max_width; ++width)
+    {
+        const uint64_t          mask{(uint64_t{1} << width) - 1};
+        std::vector<uint32_t>   values(600);
+
+        for (auto &value : values)
+            value = static_cast<uint32_t>(next_word(state));
+
+        // Values are truncated to the width.
+        brace::PackedArray  array(width);
+
+        for (size_t i = 0; i < 100; ++i)
+            array.push_back(values[i]);
+        array.append(values.data() + 100, values.size() - 100);
+
+        REQUIRE(array.size() == values.size());
+        REQUIRE(array.word_count() == (values.size() * width + 63) / 64);
+        for (size_t i = 0; i < values.size(); ++i)
+            REQUIRE(array[i] == (values[i] & mask));
+
+        // Unpack ranges with every alignment, including blocks of 128 and
+        // 256 elements.
+        std::vector<uint32_t>   out(values.size());
+
+        for (size_t first : {0, 1, 7, 8, 13})
+        {
+            for (size_t count : {0, 5, 8, 128, 256, 587})
+            {
+                if (first + count > values.size())
+                    continue;
+                array.unpack(first, count, out.data());
+                for (size_t i = 0; i < count; ++i)
+                    REQUIRE(out[i] == (values[first + i] & mask));
+            }
+        }
+
+        // Setting an element leaves its neighbours alone.
+        for (size_t i = 0; i < values.size(); i += 7)
+        {
+            array.set(i, ~values[i]);
+            values[i] = ~values[i];
+        }
+        for (size_t i = 0; i < values.size(); ++i)
+            REQUIRE(array.get(i) == (values[i] & mask));
+
+        // Shrinking and growing again gives zeros.
+        array.resize(300);
+        array.resize(310);
+        REQUIRE(array.get(299) == (values[299] & mask));
+        REQUIRE(array.get(300) == 0);
+        REQUIRE(array.get(309) == 0);
+    }
+}
+
+TEST_CASE("Serialize a packed integer array")
+{
+    brace::PackedArray  original(11);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+        original.push_back(i * 37);
+
+    for (brace::Endian endian : {brace::Endian::Little, brace::Endian::Big})
+    {
+        std::vector<unsigned char>  buffer(2048);
+        brace::BinArrayStream       stream{buffer.data(), buffer.size()};
+        brace::PackedArray          copy(1);
+
+        stream.endian(endian);
+        stream << original;
+        stream.seekg(0);
+        stream >> copy;
+
+        REQUIRE(stream);
+        REQUIRE(copy == original);
+        REQUIRE(copy.get(999) == ((999 * 37) & 0x7FF));
+    }
+
+    // An invalid width fails the stream and leaves the array unchanged.
+    std::vector<unsigned char>  buffer(64);
+    brace::BinArrayStream       stream{buffer.data(), buffer.size()};
+    brace::PackedArray          copy(original);
+
+    stream << uint8_t{40} << uint64_t{1};
+    stream.seekg(0);
+    stream >> copy;
+
+    REQUIRE_FALSE(stream);
+    REQUIRE(copy == original);
+
+    // So does a size whose bit count overflows, or that is far larger
+    // than the stream.
+    for (uint64_t size : {uint64_t{1} << 61, ~uint64_t{0}, uint64_t{1} << 40})
+    {
+        brace::BinArrayStream   corrupt{buffer.data(), buffer.size()};
+
+        corrupt << uint8_t{8} << size << uint64_t{0xFF};
+        corrupt.seekg(0);
+        corrupt >> copy;
+
+        REQUIRE_FALSE(corrupt);
+        REQUIRE(copy == original);
+    }
+
+    REQUIRE(brace::PackedArray(8).max_size() == (SIZE_MAX - 63) / 8);
+    REQUIRE_THROWS_AS(brace::PackedArray(8, size_t{1} << 61), std::length_error);
+    REQUIRE_THROWS_AS(copy.resize(SIZE_MAX), std::length_error);
+    REQUIRE_THROWS_AS(copy.reserve(SIZE_MAX / 2), std::length_error);
+    REQUIRE(copy == original);
+}
@@ -0,0 +1,163 @@
+#define CATCH_CONFIG_MAIN
+#include "catch2/catch.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brace/bits_dispatch.h"
+#include "brace/cpu_features.h"
+#include "brace/utf8_encoding.h"
+
+using brace::CpuFeature;
+using brace::CpuFeatures;
+
+namespace {
+
+int selections{0};
+
+int twice(int n) { return 2 * n; }
+int thrice(int n) { return 3 * n; }
+
+struct CountingSelector
+{
+    static int (*select(const CpuFeatures &features))(int)
+    {
+        ++selections;
+        return features.has(CpuFeature::SSE2) ? twice : thrice;
+    }
+};
+
+}
+
+TEST_CASE("Detect processor features")
+{
+    const CpuFeatures   detected{CpuFeatures::detect()};
+
+    REQUIRE(brace::cpu_features().bits() == (brace::cpu_features().bits() & detected.bits()));
+
+#if defined(BRACE_CPU_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    REQUIRE(detected.has(CpuFeature::SSE2) == (__builtin_cpu_supports("sse2") != 0));
+    REQUIRE(detected.has(CpuFeature::SSSE3) == (__builtin_cpu_supports("ssse3") != 0));
+    REQUIRE(detected.has(CpuFeature::SSE42) == (__builtin_cpu_supports("sse4.2") != 0));
+    REQUIRE(detected.has(CpuFeature::POPCNT) == (__builtin_cpu_supports("popcnt") != 0));
+    REQUIRE(detected.has(CpuFeature::AVX2) == (__builtin_cpu_supports("avx2") != 0));
+    REQUIRE(detected.has(CpuFeature::AVX512BW) == (__builtin_cpu_supports("avx512bw") != 0));
+#endif
+
+    // Features the compiler was told to assume must be present.
+#if defined(__SSE2__)
+    REQUIRE(detected.has(CpuFeature::SSE2));
+#endif
+#if defined(__AVX2__)
+    REQUIRE(detected.has(CpuFeature::AVX2));
+#endif
+}
+
+TEST_CASE("Restrict processor features")
+{
+    static_assert(CpuFeatures::name(CpuFeature::SSE41) == "sse4.1");
+
+    constexpr CpuFeatures   all{~uint32_t{0}};
+
+    REQUIRE(all.restrict("").bits() == all.bits());
+    REQUIRE(all.restrict("none").bits() == 0);
+    REQUIRE(all.restrict("bogus").bits() == all.bits());
+
+    const CpuFeatures   no_avx{all.restrict("-avx2, -AVX512BW")};
+
+    REQUIRE_FALSE(no_avx.has(CpuFeature::AVX2));
+    REQUIRE_FALSE(no_avx.has(CpuFeature::AVX512BW));
+    REQUIRE(no_avx.has(CpuFeature::AVX512F));
+    REQUIRE(no_avx.has(CpuFeature::SSE2));
+
+    const CpuFeatures   only{all.restrict("sse2,ssse3,-ssse3")};
+
+    REQUIRE(only.bits() == static_cast<uint32_t>(CpuFeature::SSE2));
+
+    // Features can be removed but never added.
+    REQUIRE(CpuFeatures{}.set(CpuFeature::SHA).restrict("sha,avx2").bits() == static_cast<uint32_t>(CpuFeature::SHA));
+}
+
+TEST_CASE("Dispatch to a kernel on first use")
+{
+    using Dispatch = brace::KernelDispatch<CountingSelector, int(int)>;
+
+    const int   expected{brace::cpu_features().has(CpuFeature::SSE2) ? 14 : 21};
+
+    REQUIRE(Dispatch::call(7) == expected);
+    REQUIRE(Dispatch::call(7) == expected);
+    REQUIRE(Dispatch::kernel()(7) == expected);
+    REQUIRE(selections == 1);
+}
+
+#if defined(BRACE_RUNTIME_DISPATCH)
+TEST_CASE("Every popcount kernel gives the same count")
+{
+    std::vector<uint64_t>   words(1001);
+    uint64_t                state{0x9E3779B97F4A7C15};
+    size_t                  expected{0};
+
+    for (auto &word : words)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        word = state;
+        expected += static_cast<size_t>(brace::popcount(word));
+    }
+
+    const CpuFeatures   detected{brace::cpu_features()};
+
+    for (const char *spec : {"none", "-avx2", ""})
+    {
+        const auto  kernel{brace::detail::PopcountWords::select(detected.restrict(spec))};
+
+        REQUIRE(kernel(words.data(), words.size()) == expected);
+        REQUIRE(kernel(words.data() + 1, 6) == brace::popcount(words.data() + 1, 6));
+    }
+
+    REQUIRE(brace::popcount_dispatched(words.data(), words.size()) == expected);
+}
+
+TEST_CASE("Every UTF-8 validation kernel finds the same error")
+{
+    std::string text;
+
+    while (text.size() < 300)
+        text += u8"ASCII, \u00E9t\u00E9, \u65E5\u672C, \U0001F600 ";
+
+    const auto          bytes{reinterpret_cast<const unsigned char *>(text.data())};
+    const CpuFeatures   detected{brace::cpu_features()};
+    const auto          scalar{brace::detail::Utf8FindInvalid::scalar};
+
+    for (const char *spec : {"none", "sse2,ssse3,sse4.1", "-avx512bw", ""})
+    {
+        const auto  kernel{brace::detail::Utf8FindInvalid::select(detected.restrict(spec))};
+
+        REQUIRE(kernel(bytes, text.size()) == text.size());
+
+        // A sequence cut short by the end of the buffer.
+        for (size_t length = 250; length < text.size(); ++length)
+            REQUIRE(kernel(bytes, length) == scalar(bytes, length));
+
+        // A stray continuation byte, and a lead byte with no continuation.
+        for (const unsigned char bad : {0x80, 0xE6})
+        {
+            for (size_t pos = 0; pos < text.size(); pos += 7)
+            {
+                std::string corrupt{text};
+
+                corrupt[pos] = static_cast<char>(bad);
+
+                const auto  p{reinterpret_cast<const unsigned char *>(corrupt.data())};
+
+                REQUIRE(kernel(p, corrupt.size()) == scalar(p, corrupt.size()));
+            }
+        }
+    }
+
+    REQUIRE(brace::UTF8Encoding::find_invalid(bytes, text.size()) == text.size());
+}
+#endif
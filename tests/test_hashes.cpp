@@ -4,7 +4,11 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <memory_resource>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "brace/sha1.h"
 #include "brace/sha2.h"
@@ -137,3 +141,60 @@ TEST_CASE("Basic md5 from brace binary array stream")
 
     REQUIRE(str == "D26422E528EE388C001F5E8D4498963F");
 }
+
+TEST_CASE("Hash using a memory resource")
+{
+    const std::string   input{"The quick brown fox jumps over the lazy dog"};
+
+    char                                buffer[1024];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof buffer, std::pmr::null_memory_resource()};
+
+    brace::SHA256   sha256;
+    auto            digest{sha256.compute_hash(input, &arena)};
+
+    REQUIRE(digest.get_allocator().resource() == &arena);
+    REQUIRE(digest.size() == 32);
+    REQUIRE(std::vector<uint8_t>(digest.begin(), digest.end()) == sha256.compute_hash(input));
+
+    REQUIRE(sha256.compute_hash_string(input, &arena) == "D7A8FBB307D7809469CA9ABCB0082E4F8D5651E46D3CDB762D02D0BF37C9E592");
+    REQUIRE(brace::SHA1().compute_hash_string(input, &arena) == "2FD4E1C67A2D28FCED849EE1BB76E7391B93EB12");
+    REQUIRE(brace::MD5().compute_hash_string(input, &arena) == "9E107D9D372BB6826BD81D3542A419D6");
+    REQUIRE(brace::SHA512().compute_hash_string(input, &arena).size() == 128);
+
+    std::istringstream  stream{input};
+
+    REQUIRE(brace::SHA224().compute_hash(stream, &arena).size() == 28);
+
+    // The remaining overloads must match the ones that use the default
+    // allocator, and allocate only from the arena.
+    const std::string           prefix{input.substr(0, 19)};
+    const std::vector<uint8_t>  bytes(input.begin(), input.end());
+    std::vector<uint8_t>        data(input.begin(), input.end());
+
+    REQUIRE(std::string_view{sha256.compute_hash_string(bytes, &arena)} == sha256.compute_hash_string(bytes));
+
+    std::istringstream  stream1{input};
+    std::istringstream  stream2{input};
+    std::istringstream  stream3{input};
+
+    auto    partial{sha256.compute_hash(stream1, prefix.size(), &arena)};
+
+    REQUIRE(partial.get_allocator().resource() == &arena);
+    REQUIRE(std::vector<uint8_t>(partial.begin(), partial.end()) == sha256.compute_hash(prefix));
+    REQUIRE(std::string_view{sha256.compute_hash_string(stream2, &arena)} == sha256.compute_hash_string(input));
+    REQUIRE(std::string_view{sha256.compute_hash_string(stream3, prefix.size(), &arena)} == sha256.compute_hash_string(prefix));
+
+    brace::BinIArrayStream  bin1{data.data(), data.size()};
+    brace::BinIArrayStream  bin2{data.data(), data.size()};
+    brace::BinIArrayStream  bin3{data.data(), data.size()};
+
+    auto    bin_partial{sha256.compute_hash(bin1, prefix.size(), &arena)};
+
+    REQUIRE(bin_partial.get_allocator().resource() == &arena);
+    REQUIRE(std::vector<uint8_t>(bin_partial.begin(), bin_partial.end()) == sha256.compute_hash(prefix));
+    REQUIRE(std::string_view{sha256.compute_hash_string(bin2, &arena)} == sha256.compute_hash_string(input));
+    auto    bin_string{sha256.compute_hash_string(bin3, prefix.size(), &arena)};
+
+    REQUIRE(bin_string.get_allocator().resource() == &arena);
+    REQUIRE(std::string_view{bin_string} == sha256.compute_hash_string(prefix));
+}
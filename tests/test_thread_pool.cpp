@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_MAIN
+#include "catch2/catch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "brace/base16.h"
+#include "brace/base32.h"
+#include "brace/base64.h"
+#include "brace/parallel_codec.h"
+#include "brace/sha2.h"
+#include "brace/thread_pool.h"
+
+TEST_CASE("Submit tasks to a thread pool")
+{
+    brace::ThreadPool   pool{3};
+
+    REQUIRE(pool.size() == 3);
+    REQUIRE(brace::ThreadPool{0}.size() == 1);
+
+    std::vector<std::future<int>>   results;
+
+    for (int i = 0; i < 100; ++i)
+        results.push_back(pool.submit([](int a, int b) { return a * b; }, i, i));
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(results[i].get() == i * i);
+
+    auto    moved{pool.submit([](std::unique_ptr<int> p) { return *p + 1; }, std::make_unique<int>(41))};
+    auto    failed{pool.submit([] { throw std::runtime_error("failed"); })};
+
+    REQUIRE(moved.get() == 42);
+    REQUIRE_THROWS_AS(failed.get(), std::runtime_error);
+}
+
+TEST_CASE("Run a parallel loop")
+{
+    brace::ThreadPool   pool{4};
+
+    for (size_t count : {0, 1, 7, 1000, 100000})
+    {
+        for (size_t grain : {0, 1, 16, 1000, 1000000})
+        {
+            if (grain < 16 && count > 1000)
+                continue;
+
+            std::vector<std::atomic<int>>   visits(count);
+            std::atomic<size_t>             largest{0};
+
+            pool.parallel_for(0, count, grain, [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                        visits[i].fetch_add(1);
+                    if (end - begin > largest)
+                        largest = end - begin;
+                });
+
+            for (size_t i = 0; i < count; ++i)
+                REQUIRE(visits[i].load() == 1);
+            REQUIRE(largest <= (grain ? grain : 1));
+        }
+    }
+
+    // An offset range, on the default pool.
+    std::atomic<size_t> sum{0};
+
+    brace::parallel_for(100, 200, 8, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                sum += i;
+        });
+    REQUIRE(sum == 14950);
+}
+
+TEST_CASE("Nest parallel loops and propagate exceptions")
+{
+    // More outer iterations than threads, each waiting on an inner loop,
+    // must not deadlock.
+    brace::ThreadPool   pool{2};
+    std::atomic<size_t> total{0};
+
+    pool.parallel_for(0, 16, 1, [&](size_t, size_t)
+        {
+            pool.parallel_for(0, 64, 4, [&](size_t begin, size_t end) { total += end - begin; });
+        });
+    REQUIRE(total == 16 * 64);
+
+    auto    nested{pool.submit([&pool]
+        {
+            std::atomic<int>    n{0};
+
+            pool.parallel_for(0, 10, 1, [&](size_t, size_t) { ++n; });
+            return n.load();
+        })};
+
+    REQUIRE(nested.get() == 10);
+
+    REQUIRE_THROWS_AS(pool.parallel_for(0, 1000, 10, [](size_t begin, size_t)
+        {
+            if (begin >= 500)
+                throw std::out_of_range("too far");
+        }), std::out_of_range);
+}
+
+TEST_CASE("Hash many inputs in parallel")
+{
+    std::vector<std::string>    inputs;
+
+    for (int i = 0; i < 64; ++i)
+        inputs.push_back(std::string(static_cast<size_t>(i) * 1000, static_cast<char>('a' + i % 26)));
+
+    std::vector<std::string>    expected;
+
+    for (const auto &input : inputs)
+        expected.push_back(brace::SHA256().compute_hash_string(input));
+
+    std::vector<std::string>    actual(inputs.size());
+
+    brace::parallel_for(0, inputs.size(), 1, [&](size_t begin, size_t end)
+        {
+            brace::SHA256   hash;
+
+            for (size_t i = begin; i < end; ++i)
+                actual[i] = hash.compute_hash_string(inputs[i]);
+        });
+
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("Encode in parallel")
+{
+    brace::ThreadPool       pool{4};
+    std::vector<uint8_t>    data;
+
+    for (size_t i = 0; i < 5 * brace::parallel_encode_chunk + 7; ++i)
+        data.push_back(static_cast<uint8_t>(i * 131 + (i >> 8)));
+
+    for (size_t size : {size_t{0}, size_t{100}, brace::parallel_encode_chunk * 2, data.size()})
+    {
+        const auto  beg{data.begin()};
+        const auto  end{beg + static_cast<std::ptrdiff_t>(size)};
+
+        for (size_t wrapat : {0, 64, 76})
+        {
+            REQUIRE(brace::parallel_encode(brace::Base64(), beg, end, wrapat, pool)
+                    == brace::Base64().encode(beg, end, wrapat));
+            REQUIRE(brace::parallel_encode(brace::Base32(), beg, end, wrapat, pool)
+                    == brace::Base32().encode(beg, end, wrapat));
+            REQUIRE(brace::parallel_encode(brace::Base16(), beg, end, wrapat, pool)
+                    == brace::Base16().encode(beg, end, wrapat));
+        }
+    }
+
+    // On the default pool.
+    REQUIRE(brace::parallel_encode(brace::Base64Url(), data.data(), data.data() + data.size())
+            == brace::Base64Url().encode(data.begin(), data.end()));
+}
@@ -1,9 +1,19 @@
 #define CATCH_CONFIG_MAIN
 #include "catch2/catch.hpp"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <brace/ascii_encoding.h>
+#include <brace/detect_encoding.h>
+#include <brace/encoding_registry.h>
 #include <brace/utf8_encoding.h>
 #include <brace/utf32_encoding.h>
+#include <brace/transcode.h>
+#include <brace/text_codec.h>
+#include <brace/transcode_stream.h>
+#include <brace/binastream.h>
 
 TEST_CASE("Simple ASCII tests")
 {
@@ -182,3 +192,687 @@ TEST_CASE("Decode UTF-32")
     cp = enc_le.decode(le_hwair);
     REQUIRE(cp == cp_hwair);
 }
+
+TEST_CASE("Transcode UTF-8 to UTF-16 and back")
+{
+    // "$£Иह€한𐍈"
+    constexpr const unsigned char utf8[] {
+        0x24, 0xC2, 0xA3, 0xD0, 0x98, 0xE0, 0xA4, 0xB9, 0xE2, 0x82, 0xAC,
+        0xED, 0x95, 0x9C, 0xF0, 0x90, 0x8D, 0x88
+    };
+    constexpr const unsigned char utf16be[] {
+        0x00, 0x24, 0x00, 0xA3, 0x04, 0x18, 0x09, 0x39, 0x20, 0xAC,
+        0xD5, 0x5C, 0xD8, 0x00, 0xDF, 0x48
+    };
+
+    brace::UTF8Encoding     utf8_enc;
+    brace::UTF16Encoding    be_enc{brace::Endian::Big};
+    brace::UTF16Encoding    le_enc{brace::Endian::Little};
+    unsigned char           buffer[64];
+    unsigned char           round_trip[64];
+
+    auto    rv{brace::transcode(utf8_enc, utf8, sizeof(utf8), be_enc, buffer, sizeof(buffer))};
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_read == sizeof(utf8));
+    REQUIRE(rv.bytes_written == sizeof(utf16be));
+    REQUIRE(rv.error_offset == brace::TranscodeResult::npos);
+    REQUIRE(memcmp(buffer, utf16be, sizeof(utf16be)) == 0);
+
+    rv = brace::transcode(be_enc, utf16be, sizeof(utf16be), le_enc, buffer, sizeof(buffer));
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == sizeof(utf16be));
+    REQUIRE(buffer[0] == 0x24);
+    REQUIRE(buffer[1] == 0x00);
+
+    rv = brace::transcode(le_enc, buffer, rv.bytes_written, utf8_enc, round_trip, sizeof(round_trip));
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == sizeof(utf8));
+    REQUIRE(memcmp(round_trip, utf8, sizeof(utf8)) == 0);
+
+    REQUIRE(brace::transcoded_length(utf8_enc, utf8, sizeof(utf8), be_enc) == sizeof(utf16be));
+}
+
+TEST_CASE("Transcode long UTF-8 and UTF-16 runs")
+{
+    // Long runs of ASCII and two-byte characters, broken up by three- and
+    // four-byte characters and a bad surrogate, so that every path through
+    // the conversion is taken.
+    std::string text;
+
+    for (int i = 0; i < 100; ++i)
+        text += "plain ascii text ";
+    for (int i = 0; i < 40; ++i)
+        text += "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82";     // "Привет"
+    text += "\xE2\x82\xAC\xF0\x90\x8D\x88";                             // "€𐍈"
+    for (int i = 0; i < 40; ++i)
+        text += "\xC3\xA9t\xC3\xA9 ";                                     // "été "
+
+    const auto  *utf8{reinterpret_cast<const unsigned char *>(text.data())};
+
+    brace::UTF8Encoding     utf8_enc;
+
+    for (auto endian : {brace::Endian::Big, brace::Endian::Little})
+    {
+        brace::UTF16Encoding        utf16_enc{endian};
+        std::vector<unsigned char>  utf16(text.size() * 2);
+        std::vector<unsigned char>  round_trip(text.size());
+
+        auto    rv{brace::transcode(utf8_enc, utf8, text.size(), utf16_enc, utf16.data(), utf16.size())};
+        REQUIRE(rv.ok());
+        REQUIRE(rv.bytes_read == text.size());
+
+        const size_t    utf16_length{rv.bytes_written};
+        const bool      big{endian == brace::Endian::Big};
+
+        REQUIRE(utf16[big ? 1 : 0] == 'p');
+        REQUIRE(utf16[big ? 0 : 1] == 0);
+        REQUIRE(utf16[1700 * 2 + (big ? 0 : 1)] == 0x04);     // 'П' is U+041F
+        REQUIRE(utf16[1700 * 2 + (big ? 1 : 0)] == 0x1F);
+
+        rv = brace::transcode(utf16_enc, utf16.data(), utf16_length, utf8_enc, round_trip.data(), round_trip.size());
+        REQUIRE(rv.ok());
+        REQUIRE(rv.bytes_written == text.size());
+        REQUIRE(memcmp(round_trip.data(), utf8, text.size()) == 0);
+
+        // An output buffer one byte short stops cleanly before the last character.
+        rv = brace::transcode(utf16_enc, utf16.data(), utf16_length, utf8_enc, round_trip.data(), text.size() - 1);
+        REQUIRE(rv.status == brace::TranscodeStatus::OutputFull);
+        REQUIRE(rv.bytes_written == text.size() - 1);
+
+        // A lone low surrogate in the middle of a long run is reported.
+        utf16[2000 + (big ? 0 : 1)] = 0xDC;
+        rv = brace::transcode(utf16_enc, utf16.data(), utf16_length, utf8_enc, round_trip.data(), round_trip.size());
+        REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+        REQUIRE(rv.error_offset == 2000);
+    }
+}
+
+TEST_CASE("Transcode between UTF-32, Latin-1 and ASCII")
+{
+    constexpr const unsigned char latin1[] {'C', 'a', 'f', 0xE9, '!'};
+    constexpr const unsigned char utf8[] {'C', 'a', 'f', 0xC3, 0xA9, '!'};
+
+    brace::Latin1Encoding   latin1_enc;
+    brace::UTF8Encoding     utf8_enc;
+    brace::UTF32Encoding    utf32_enc{brace::Endian::Little};
+    brace::ASCIIEncoding    ascii_enc;
+    unsigned char           buffer[64];
+    unsigned char           buffer2[64];
+
+    auto    rv{brace::transcode(latin1_enc, latin1, sizeof(latin1), utf8_enc, buffer, sizeof(buffer))};
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == sizeof(utf8));
+    REQUIRE(memcmp(buffer, utf8, sizeof(utf8)) == 0);
+
+    rv = brace::transcode(utf8_enc, utf8, sizeof(utf8), utf32_enc, buffer, sizeof(buffer));
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == 20);
+    REQUIRE(buffer[12] == 0xE9);
+
+    rv = brace::transcode(utf32_enc, buffer, rv.bytes_written, latin1_enc, buffer2, sizeof(buffer2));
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == sizeof(latin1));
+    REQUIRE(memcmp(buffer2, latin1, sizeof(latin1)) == 0);
+
+    // 'é' has no ASCII representation
+    rv = brace::transcode(latin1_enc, latin1, sizeof(latin1), ascii_enc, buffer, sizeof(buffer));
+    REQUIRE(rv.status == brace::TranscodeStatus::Unencodable);
+    REQUIRE(rv.bytes_read == 3);
+    REQUIRE(rv.bytes_written == 3);
+    REQUIRE(rv.error_offset == 3);
+}
+
+TEST_CASE("Transcode long Latin-1 and ASCII text")
+{
+    std::vector<unsigned char>  latin1;
+
+    for (int i = 0; i < 300; ++i)
+        latin1.push_back(static_cast<unsigned char>(i % 3 == 0 ? 0xA0 + i % 0x60 : 0x20 + i % 0x5F));
+
+    brace::Latin1Encoding       latin1_enc;
+    brace::UTF8Encoding         utf8_enc;
+    brace::UTF16Encoding        utf16_enc{brace::Endian::Big};
+    brace::UTF32Encoding        utf32_enc{brace::Endian::Little};
+    brace::ASCIIEncoding        ascii_enc;
+    std::vector<unsigned char>  utf8(latin1.size() * 2);
+    std::vector<unsigned char>  back(latin1.size());
+
+    auto    rv{brace::transcode(latin1_enc, latin1.data(), latin1.size(), utf8_enc, utf8.data(), utf8.size())};
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == 400);
+    REQUIRE(brace::UTF8Encoding::validate(utf8.data(), rv.bytes_written));
+    REQUIRE(utf8[0] == 0xC2);
+    REQUIRE(utf8[1] == 0xA0);
+
+    rv = brace::transcode(utf8_enc, utf8.data(), rv.bytes_written, latin1_enc, back.data(), back.size());
+    REQUIRE(rv.ok());
+    REQUIRE(back == latin1);
+
+    // U+0100 cannot be narrowed to Latin-1.
+    utf8[200] = 0xC4;
+    utf8[201] = 0x80;
+    rv = brace::transcode(utf8_enc, utf8.data(), 400, latin1_enc, back.data(), back.size());
+    REQUIRE(rv.status == brace::TranscodeStatus::Unencodable);
+    REQUIRE(rv.error_offset == 200);
+
+    std::vector<unsigned char>  wide(latin1.size() * 4);
+
+    rv = brace::transcode(latin1_enc, latin1.data(), latin1.size(), utf32_enc, wide.data(), wide.size());
+    REQUIRE(rv.ok());
+    REQUIRE(wide[4 * 299] == latin1[299]);
+    REQUIRE(wide[4 * 299 + 3] == 0);
+
+    rv = brace::transcode(latin1_enc, latin1.data(), latin1.size(), utf16_enc, wide.data(), wide.size());
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == 600);
+    REQUIRE(wide[0] == 0x00);
+    REQUIRE(wide[1] == 0xA0);
+
+    // ASCII
+    std::string ascii(100, 'x');
+
+    ascii += "0123456789";
+    REQUIRE(brace::ASCIIEncoding::validate(reinterpret_cast<const unsigned char *>(ascii.data()), ascii.size()));
+    ascii[77] = '\xE9';
+    REQUIRE(brace::ASCIIEncoding::find_invalid(reinterpret_cast<const unsigned char *>(ascii.data()), ascii.size()) == 77);
+
+    rv = brace::transcode(ascii_enc, reinterpret_cast<const unsigned char *>(ascii.data()), ascii.size(),
+                          utf16_enc, wide.data(), wide.size());
+    REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+    REQUIRE(rv.error_offset == 77);
+    REQUIRE(rv.bytes_written == 154);
+
+    char32_t    decoded[128];
+
+    rv = brace::decode(ascii_enc, reinterpret_cast<const unsigned char *>(ascii.data()), ascii.size(),
+                       decoded, 128, brace::ErrorHandling::Replace);
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == ascii.size());
+    REQUIRE(decoded[76] == U'x');
+    REQUIRE(decoded[77] == 0xFFFD);
+    REQUIRE(decoded[109] == U'9');
+}
+
+TEST_CASE("Transcode with static codecs")
+{
+    using UTF16LE = brace::UTF16Codec<brace::Endian::Little>;
+    using UTF32BE = brace::UTF32Codec<brace::Endian::Big>;
+
+    unsigned char   bytes[4];
+    size_t          used;
+
+    REQUIRE(UTF16LE::encoded_length(0x10348) == 4);
+    UTF16LE::encode(0x10348, bytes);
+    REQUIRE(bytes[0] == 0x00);
+    REQUIRE(bytes[1] == 0xD8);
+    REQUIRE(bytes[2] == 0x48);
+    REQUIRE(bytes[3] == 0xDF);
+    REQUIRE(UTF16LE::decode(bytes, 4, used) == 0x10348);
+    REQUIRE(used == 4);
+    REQUIRE(UTF16LE::decode(bytes, 3, used) == brace::DecodeResult::incomplete);
+    REQUIRE(UTF16LE::encoded_length(0xDC00) == 0);
+
+    UTF32BE::encode(0x20AC, bytes);
+    REQUIRE(bytes[2] == 0x20);
+    REQUIRE(bytes[3] == 0xAC);
+
+    REQUIRE(brace::Latin1Codec<>::encoded_length(0x85) == 1);
+    REQUIRE(brace::Latin1Codec<false>::encoded_length(0x85) == 0);
+    REQUIRE(brace::UTF8Codec::encoded_length(0x110000) == 0);
+
+    // The static and virtual interfaces agree.
+    const std::string   text{"$\xC2\xA3\xE2\x82\xAC\xF0\x90\x8D\x88 and some ASCII"};
+    const auto          *in{reinterpret_cast<const unsigned char *>(text.data())};
+
+    std::vector<unsigned char>  by_codec(text.size() * 2);
+    std::vector<unsigned char>  by_encoding(text.size() * 2);
+
+    auto    rv{brace::transcode<brace::UTF8Codec, UTF16LE>(in, text.size(), by_codec.data(), by_codec.size())};
+    REQUIRE(rv.ok());
+    by_codec.resize(rv.bytes_written);
+
+    rv = brace::transcode(brace::UTF8Encoding{}, in, text.size(),
+                          brace::UTF16Encoding{brace::Endian::Little}, by_encoding.data(), by_encoding.size());
+    REQUIRE(rv.ok());
+    by_encoding.resize(rv.bytes_written);
+    REQUIRE(by_codec == by_encoding);
+
+    std::u32string  decoded(text.size(), U'\0');
+    rv = brace::decode<UTF16LE>(by_codec.data(), by_codec.size(), decoded.data(), decoded.size());
+    REQUIRE(rv.ok());
+    decoded.resize(rv.bytes_written);
+    REQUIRE(decoded == U"$\u00A3\u20AC\U00010348 and some ASCII");
+
+    // Latin-1 with control characters disabled rejects C1 controls.
+    const unsigned char c1[] {'a', 0x85, 'b'};
+    rv = brace::transcode<brace::Latin1Codec<false>, brace::UTF8Codec>(c1, 3, bytes, sizeof(bytes));
+    REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+    REQUIRE(rv.error_offset == 1);
+}
+
+TEST_CASE("Transcode reports errors")
+{
+    constexpr const unsigned char bad_utf8[] {'a', 'b', 0xE2, 0x28, 0xA1, 'c'};
+    constexpr const unsigned char short_utf8[] {'a', 'b', 0xE2, 0x82};
+    constexpr const unsigned char lone_surrogate[] {0x00, 0x41, 0xDC, 0x00, 0x00, 0x42};
+
+    brace::UTF8Encoding     utf8_enc;
+    brace::UTF16Encoding    utf16_enc{brace::Endian::Big};
+    unsigned char           buffer[64];
+
+    auto    rv{brace::transcode(utf8_enc, bad_utf8, sizeof(bad_utf8), utf16_enc, buffer, sizeof(buffer))};
+    REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+    REQUIRE(rv.error_offset == 2);
+    REQUIRE(rv.bytes_read == 2);
+    REQUIRE(rv.bytes_written == 4);
+
+    rv = brace::transcode(utf8_enc, short_utf8, sizeof(short_utf8), utf8_enc, buffer, sizeof(buffer));
+    REQUIRE(rv.status == brace::TranscodeStatus::IncompleteSequence);
+    REQUIRE(rv.error_offset == 2);
+    REQUIRE(rv.bytes_written == 2);
+
+    rv = brace::transcode(utf16_enc, lone_surrogate, sizeof(lone_surrogate), utf8_enc, buffer, sizeof(buffer));
+    REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+    REQUIRE(rv.error_offset == 2);
+
+    rv = brace::transcode(utf8_enc, short_utf8, 2, utf16_enc, buffer, 3);
+    REQUIRE(rv.status == brace::TranscodeStatus::OutputFull);
+    REQUIRE(rv.bytes_read == 1);
+    REQUIRE(rv.bytes_written == 2);
+}
+
+TEST_CASE("Count and locate code points")
+{
+    // "$£€𐍈" repeated, long enough to cover whole vector blocks and a tail.
+    std::string text;
+
+    for (int i = 0; i < 10; ++i)
+        text += "$\xC2\xA3\xE2\x82\xAC\xF0\x90\x8D\x88";
+
+    const auto  *utf8{reinterpret_cast<const unsigned char *>(text.data())};
+
+    REQUIRE(brace::UTF8Encoding::count_code_points(utf8, text.size()) == 40);
+    REQUIRE(brace::UTF8Encoding::code_point_offset(utf8, text.size(), 0) == 0);
+    REQUIRE(brace::UTF8Encoding::code_point_offset(utf8, text.size(), 3) == 6);
+    REQUIRE(brace::UTF8Encoding::code_point_offset(utf8, text.size(), 39) == 96);
+    REQUIRE(brace::UTF8Encoding::code_point_offset(utf8, text.size(), 40) == text.size());
+    REQUIRE(brace::UTF8Encoding::boundary_before(utf8, text.size(), 8) == 6);
+    REQUIRE(brace::UTF8Encoding::boundary_before(utf8, text.size(), 6) == 6);
+    REQUIRE(brace::UTF8Encoding::boundary_before(utf8, text.size(), 99) == 96);
+    REQUIRE(brace::UTF8Encoding::boundary_before(utf8, text.size(), 500) == text.size());
+
+    brace::UTF8Encoding     utf8_enc;
+    brace::UTF16Encoding    utf16_enc{brace::Endian::Little};
+    unsigned char           utf16[200];
+
+    auto    rv{brace::transcode(utf8_enc, utf8, text.size(), utf16_enc, utf16, sizeof(utf16))};
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_written == 100);
+
+    REQUIRE(utf16_enc.count_code_points(utf16, rv.bytes_written) == 40);
+    REQUIRE(utf16_enc.code_point_offset(utf16, rv.bytes_written, 3) == 6);
+    REQUIRE(utf16_enc.code_point_offset(utf16, rv.bytes_written, 4) == 10);
+    REQUIRE(utf16_enc.code_point_offset(utf16, rv.bytes_written, 39) == 96);
+    REQUIRE(utf16_enc.code_point_offset(utf16, rv.bytes_written, 40) == 100);
+    REQUIRE(utf16_enc.boundary_before(utf16, rv.bytes_written, 9) == 6);
+    REQUIRE(utf16_enc.boundary_before(utf16, rv.bytes_written, 5) == 4);
+
+    // An unpaired high surrogate counts on its own.
+    utf16[98] = 0x41;
+    utf16[99] = 0x00;
+    REQUIRE(utf16_enc.count_code_points(utf16, rv.bytes_written) == 41);
+}
+
+TEST_CASE("Decode bounded sequences")
+{
+    brace::UTF8Encoding     utf8;
+    brace::UTF16Encoding    utf16{brace::Endian::Big};
+    brace::UTF32Encoding    utf32{brace::Endian::Little};
+    brace::Latin1Encoding   latin1;
+    brace::ASCIIEncoding    ascii;
+
+    constexpr const unsigned char euro[] {0xE2, 0x82, 0xAC};
+    auto    rv{utf8.decode_bounded(euro, 3)};
+    REQUIRE(rv.ok());
+    REQUIRE(rv.code_point == 0x20AC);
+    REQUIRE(rv.length == 3);
+
+    rv = utf8.decode_bounded(euro, 2);
+    REQUIRE(rv.code_point == brace::DecodeResult::incomplete);
+    REQUIRE(rv.length == 2);
+
+    constexpr const unsigned char bad[] {0xE2, 0x82, 0x41};
+    rv = utf8.decode_bounded(bad, 3);
+    REQUIRE(rv.code_point == brace::DecodeResult::invalid);
+    REQUIRE(rv.length == 2);
+
+    constexpr const unsigned char overlong[] {0xC0, 0x80};
+    rv = utf8.decode_bounded(overlong, 2);
+    REQUIRE(rv.code_point == brace::DecodeResult::invalid);
+    REQUIRE(rv.length == 1);
+
+    constexpr const unsigned char pair[] {0xD8, 0x00, 0xDF, 0x48};
+    rv = utf16.decode_bounded(pair, 4);
+    REQUIRE(rv.code_point == 0x10348);
+    REQUIRE(rv.length == 4);
+    REQUIRE(utf16.decode_bounded(pair, 3).code_point == brace::DecodeResult::incomplete);
+    REQUIRE(utf16.decode_bounded(pair + 2, 2).code_point == brace::DecodeResult::invalid);
+
+    constexpr const unsigned char gothic[] {0x48, 0x03, 0x01, 0x00};
+    constexpr const unsigned char too_big[] {0x00, 0x00, 0x11, 0x00};
+    REQUIRE(utf32.decode_bounded(gothic, 4).code_point == 0x10348);
+    REQUIRE(utf32.decode_bounded(too_big, 4).code_point == brace::DecodeResult::invalid);
+    REQUIRE(utf32.decode_bounded(gothic, 3).code_point == brace::DecodeResult::incomplete);
+
+    REQUIRE(latin1.decode_bounded(euro, 1).code_point == 0xE2);
+    REQUIRE(ascii.decode_bounded(euro, 1).code_point == brace::DecodeResult::invalid);
+    REQUIRE(ascii.decode_bounded(euro, 0).code_point == brace::DecodeResult::incomplete);
+}
+
+TEST_CASE("Encodings agree with their codecs")
+{
+    const brace::UTF8Encoding   utf8;
+    const brace::UTF16Encoding  utf16{brace::Endian::Little};
+    const brace::UTF32Encoding  utf32{brace::Endian::Big};
+    const brace::Latin1Encoding latin1{false};
+
+    const std::pair<const brace::TextEncoding *, const char *>  encodings[] {
+        {&utf8, "UTF-8"}, {&utf16, "UTF-16LE"}, {&utf32, "UTF-32BE"}, {&latin1, "Latin-1"}
+    };
+
+    for (const auto &[enc, name] : encodings)
+    {
+        INFO(name);
+
+        for (int cp : {0x00, 0x24, 0x7F, 0xA3, 0xFF, 0x0418, 0x20AC, 0xFFFD, 0x10348, 0x10FFFF})
+        {
+            unsigned char   bytes[8]{};
+            const int       n{enc->encode(cp, bytes, sizeof(bytes))};
+
+            REQUIRE(enc->encode(cp, nullptr, 0) == n);
+            if (n == 0)
+                continue;
+
+            REQUIRE(enc->sequence_length(bytes, n) == n);
+            REQUIRE(enc->decode(bytes) == cp);
+            REQUIRE(enc->decode_bounded(bytes, n).code_point == cp);
+        }
+    }
+
+    // Surrogates and values above U+10FFFF are not encodable.
+    unsigned char   bytes[8]{};
+
+    REQUIRE(utf8.encode(0xD800, bytes, sizeof(bytes)) == 0);
+    REQUIRE(utf16.encode(0xDC00, bytes, sizeof(bytes)) == 0);
+    REQUIRE(utf32.encode(0x110000, bytes, sizeof(bytes)) == 0);
+    REQUIRE(latin1.encode(0x85, bytes, sizeof(bytes)) == 0);
+
+    // A buffer that is too short is left alone, and the length is reported.
+    REQUIRE(utf8.encode(0x20AC, bytes, 2) == 3);
+    REQUIRE(bytes[0] == 0);
+
+    constexpr const unsigned char   lone_low[] {0x00, 0xDC};
+    constexpr const unsigned char   lead[] {0xF0, 0x90};
+
+    REQUIRE(utf16.decode(lone_low) == brace::DecodeResult::invalid);
+    REQUIRE(utf16.sequence_length(lone_low, 1) == -1);
+    REQUIRE(utf8.sequence_length(lead, 1) == 4);
+    REQUIRE(utf8.sequence_length(lead, 0) == -1);
+}
+
+TEST_CASE("Decode to UTF-32 with error handling")
+{
+    // "a", a truncated three-byte sequence, "b", a stray continuation byte,
+    // "€", and a truncated four-byte sequence at the end.
+    constexpr const unsigned char utf8[] {
+        0x61, 0xE2, 0x82, 0x62, 0x80, 0xE2, 0x82, 0xAC, 0xF0, 0x90
+    };
+
+    brace::UTF8Encoding utf8_enc;
+    char32_t            buffer[16];
+
+    auto    rv{brace::decode(utf8_enc, utf8, sizeof(utf8), buffer, 16)};
+    REQUIRE(rv.status == brace::TranscodeStatus::InvalidSequence);
+    REQUIRE(rv.bytes_read == 1);
+    REQUIRE(rv.bytes_written == 1);
+    REQUIRE(rv.error_offset == 1);
+    REQUIRE(buffer[0] == U'a');
+
+    rv = brace::decode(utf8_enc, utf8, sizeof(utf8), buffer, 16, brace::ErrorHandling::Replace);
+    REQUIRE(rv.ok());
+    REQUIRE(rv.bytes_read == sizeof(utf8));
+    REQUIRE(rv.error_offset == 1);
+    REQUIRE(rv.bytes_written == 6);
+    REQUIRE(std::u32string(buffer, rv.bytes_written) == U"a\uFFFDb\uFFFD\u20AC\uFFFD");
+
+    rv = brace::decode(utf8_enc, utf8, sizeof(utf8), buffer, 3, brace::ErrorHandling::Replace);
+    REQUIRE(rv.status == brace::TranscodeStatus::OutputFull);
+    REQUIRE(rv.bytes_read == 4);
+    REQUIRE(rv.bytes_written == 3);
+
+    brace::UTF16Encoding                utf16{brace::Endian::Little};
+    constexpr const unsigned char       utf16le[] {0x41, 0x00, 0x00, 0xDC, 0x42, 0x00};
+
+    rv = brace::decode(utf16, utf16le, sizeof(utf16le), buffer, 16, brace::ErrorHandling::Replace);
+    REQUIRE(rv.ok());
+    REQUIRE(std::u32string(buffer, rv.bytes_written) == U"A\uFFFDB");
+}
+
+TEST_CASE("Validate UTF-8 buffers")
+{
+    std::string text;
+
+    // long enough to exercise the vectorized validator
+    for (int i = 0; i < 40; ++i)
+        text += "Gr\xC3\xBC\xC3\x9F" "e \xE2\x82\xAC \xF0\x90\x8D\x88 ascii ";
+
+    const auto *bytes{reinterpret_cast<const unsigned char *>(text.data())};
+
+    REQUIRE(brace::UTF8Encoding::validate(bytes, text.size()));
+    REQUIRE(brace::UTF8Encoding::find_invalid(bytes, text.size()) == text.size());
+    REQUIRE(brace::UTF8Encoding::validate(bytes, 0));
+
+    // truncated in the middle of the final 4-byte sequence
+    REQUIRE(brace::UTF8Encoding::find_invalid(bytes, 14) == 12);
+
+    const std::pair<const char *, size_t> bad[] {
+        {"\xC0\xAF", 0},                // overlong
+        {"ab\xE0\x80\xAF", 2},          // overlong
+        {"abc\xED\xA0\x80", 3},         // surrogate
+        {"\xF4\x90\x80\x80", 0},        // above U+10FFFF
+        {"x\x80", 1},                   // stray continuation
+        {"\xC3\xA9\xE2\x82", 2},        // incomplete
+        {"\xFF", 0},
+    };
+
+    for (const auto &b : bad)
+    {
+        std::string s{text};
+        const size_t offset{s.size() - 7};
+
+        s.replace(offset, 7, b.first);
+        REQUIRE(brace::UTF8Encoding::find_invalid(reinterpret_cast<const unsigned char *>(s.data()), s.size())
+                == offset + b.second);
+    }
+}
+
+TEST_CASE("Find encodings by name")
+{
+    const auto  *utf8{brace::find_encoding("utf-8")};
+    REQUIRE(utf8 != nullptr);
+    REQUIRE(std::string(utf8->canonical_name()) == "UTF-8");
+    REQUIRE(brace::find_encoding("UTF8") == utf8);
+    REQUIRE(brace::find_encoding("csUTF8") == utf8);
+
+    const auto  *latin1{brace::find_encoding("ISO_8859-1:1987")};
+    REQUIRE(latin1 != nullptr);
+    REQUIRE(latin1->aka("Latin-1"));
+    REQUIRE(brace::find_encoding("l1") == latin1);
+    REQUIRE(brace::find_encoding("CP819") == latin1);
+
+    REQUIRE(brace::find_encoding("ANSI_X3.4-1968") == brace::find_encoding("us-ascii"));
+
+    const auto  *be{dynamic_cast<const brace::UTF16Encoding *>(brace::find_encoding("UTF-16BE"))};
+    const auto  *le{dynamic_cast<const brace::UTF16Encoding *>(brace::find_encoding("utf-16le"))};
+    REQUIRE(be != nullptr);
+    REQUIRE(le != nullptr);
+    REQUIRE(be->endian() == brace::Endian::Big);
+    REQUIRE(le->endian() == brace::Endian::Little);
+    REQUIRE(brace::find_encoding("UTF-16") == be);
+
+    const auto  *utf32le{dynamic_cast<const brace::UTF32Encoding *>(brace::find_encoding("UTF-32LE"))};
+    REQUIRE(utf32le != nullptr);
+    REQUIRE(utf32le->endian() == brace::Endian::Little);
+
+    REQUIRE(brace::find_encoding("") == nullptr);
+    REQUIRE(brace::find_encoding("UTF-7") == nullptr);
+    REQUIRE(brace::find_encoding("utf-8 ") == nullptr);
+    REQUIRE(brace::find_encoding("a-name-that-is-far-too-long") == nullptr);
+}
+
+TEST_CASE("Transcode between streams")
+{
+    // "$£€𐍈" repeated, in UTF-16LE with a byte order mark. A block size
+    // of 16 bytes splits surrogate pairs across blocks.
+    std::string text;
+
+    for (int i = 0; i < 25; ++i)
+        text += "$\xC2\xA3\xE2\x82\xAC\xF0\x90\x8D\x88";
+
+    brace::UTF8Encoding         utf8_enc;
+    brace::UTF16Encoding        utf16_enc{brace::Endian::Little};
+    std::vector<unsigned char>  utf16(2 + text.size() * 2);
+
+    utf16[0] = 0xFF;
+    utf16[1] = 0xFE;
+
+    auto    rv{brace::transcode(utf8_enc, reinterpret_cast<const unsigned char *>(text.data()), text.size(),
+                                utf16_enc, utf16.data() + 2, utf16.size() - 2)};
+    REQUIRE(rv.ok());
+    utf16.resize(2 + rv.bytes_written);
+
+    for (size_t block_size : {16, 17, 4096})
+    {
+        std::vector<unsigned char>  result(text.size() + 3);
+        brace::BinIArrayStream      instream{utf16.data(), utf16.size()};
+        brace::BinOArrayStream      outstream{result.data(), result.size()};
+
+        brace::StreamTranscodeOptions   options;
+        options.block_size = block_size;
+        options.emit_bom = true;
+
+        rv = brace::transcode(utf16_enc, instream, utf8_enc, outstream, options);
+        REQUIRE(rv.ok());
+        REQUIRE(rv.bytes_read == utf16.size());
+        REQUIRE(rv.bytes_written == text.size() + 3);
+        REQUIRE(result[0] == 0xEF);
+        REQUIRE(result[1] == 0xBB);
+        REQUIRE(result[2] == 0xBF);
+        REQUIRE(memcmp(result.data() + 3, text.data(), text.size()) == 0);
+    }
+
+    // A surrogate pair cut off by the end of the stream.
+    {
+        std::vector<unsigned char>  result(text.size());
+        brace::BinIArrayStream      instream{utf16.data(), utf16.size() - 2};
+        brace::BinOArrayStream      outstream{result.data(), result.size()};
+
+        rv = brace::transcode(utf16_enc, instream, utf8_enc, outstream, {16, true, false});
+        REQUIRE(rv.status == brace::TranscodeStatus::IncompleteSequence);
+        REQUIRE(rv.error_offset == utf16.size() - 4);
+        REQUIRE(rv.bytes_written == text.size() - 4);
+    }
+
+    // An output stream that is too small.
+    {
+        std::vector<unsigned char>  result(10);
+        brace::BinIArrayStream      instream{utf16.data(), utf16.size()};
+        brace::BinOArrayStream      outstream{result.data(), result.size()};
+
+        rv = brace::transcode(utf16_enc, instream, utf8_enc, outstream);
+        REQUIRE(rv.status == brace::TranscodeStatus::OutputFull);
+        REQUIRE(rv.bytes_written == 10);
+    }
+}
+
+TEST_CASE("Detect encodings")
+{
+    auto    detect = [](const std::vector<unsigned char> &bytes, size_t sample_size = 4096)
+            {
+                return brace::detect_encoding(bytes.data(), bytes.size(), sample_size);
+            };
+    auto    name = [](const brace::DetectedEncoding &detected)
+            {
+                return std::string(detected.encoding->canonical_name());
+            };
+
+    const std::string   text{"Detecting the encoding of ordinary text \xC2\xA3\xE2\x82\xAC "};
+    const auto          *text_bytes{reinterpret_cast<const unsigned char *>(text.data())};
+
+    brace::UTF8Encoding     utf8_enc;
+    brace::UTF16Encoding    utf16be{brace::Endian::Big};
+    brace::UTF16Encoding    utf16le{brace::Endian::Little};
+    brace::UTF32Encoding    utf32be{brace::Endian::Big};
+    brace::UTF32Encoding    utf32le{brace::Endian::Little};
+
+    auto    convert = [&](const brace::TextEncoding &dst, bool bom)
+            {
+                std::vector<unsigned char>  out(8 + text.size() * 4);
+                size_t                      length{0};
+
+                if (bom)
+                    length = static_cast<size_t>(dst.encode(0xFEFF, out.data(), 8));
+
+                const auto  rv{brace::transcode(utf8_enc, text_bytes, text.size(),
+                                                dst, out.data() + length, out.size() - length)};
+                REQUIRE(rv.ok());
+                out.resize(length + rv.bytes_written);
+                return out;
+            };
+
+    // Byte order marks.
+    for (const brace::TextEncoding *enc : std::initializer_list<const brace::TextEncoding *>{
+                                              &utf8_enc, &utf16be, &utf16le, &utf32be, &utf32le})
+    {
+        const auto  bytes{convert(*enc, true)};
+        const auto  detected{detect(bytes)};
+        REQUIRE(name(detected) == enc->canonical_name());
+        REQUIRE(detected.bom_length == bytes.size() - convert(*enc, false).size());
+    }
+    REQUIRE(detect(convert(utf16le, true)).encoding == brace::find_encoding("UTF-16LE"));
+    REQUIRE(detect(convert(utf32be, true)).encoding == brace::find_encoding("UTF-32BE"));
+
+    // No byte order mark.
+    REQUIRE(detect(convert(utf16be, false)).encoding == brace::find_encoding("UTF-16BE"));
+    REQUIRE(detect(convert(utf16le, false)).encoding == brace::find_encoding("UTF-16LE"));
+    REQUIRE(detect(convert(utf32be, false)).encoding == brace::find_encoding("UTF-32BE"));
+    REQUIRE(detect(convert(utf32le, false)).encoding == brace::find_encoding("UTF-32LE"));
+    REQUIRE(detect(convert(utf32le, false)).bom_length == 0);
+
+    const std::vector<unsigned char>    utf8(text_bytes, text_bytes + text.size());
+    REQUIRE(name(detect(utf8)) == "UTF-8");
+    REQUIRE(name(detect({'p', 'l', 'a', 'i', 'n'})) == "UTF-8");
+    REQUIRE(name(detect({})) == "UTF-8");
+
+    // A sample that ends part way through "€" is still UTF-8, but the
+    // same bytes on their own are not.
+    const size_t    euro{text.find('\xE2')};
+    REQUIRE(name(detect(utf8, euro + 2)) == "UTF-8");
+    REQUIRE(name(detect(std::vector<unsigned char>(utf8.begin(), utf8.begin() + euro + 2))) == "ISO-8859-1");
+
+    // A byte that can never start a sequence is not excused by falling at
+    // the end of the sample.
+    std::vector<unsigned char>  ascii(8192, 'a');
+    ascii[100] = 0xFF;
+    REQUIRE(name(detect(ascii)) == "ISO-8859-1");
+    ascii[100] = 'a';
+    ascii[4095] = 0xFF;
+    REQUIRE(name(detect(ascii)) == "ISO-8859-1");
+    ascii[4095] = 0xE2;
+    REQUIRE(name(detect(ascii)) == "UTF-8");
+    ascii[4094] = 0xE2;
+    ascii[4095] = 0x41;
+    REQUIRE(name(detect(ascii)) == "ISO-8859-1");
+
+    REQUIRE(name(detect({'c', 'a', 'f', 0xE9, ' ', 'a', 'u', ' ', 'l', 'a', 'i', 't'})) == "ISO-8859-1");
+}